@@ -8,6 +8,8 @@ check_PROGRAMS += benchmarks/ping-pong          \
                   benchmarks/strided-bench      \
                   benchmarks/bench_groups       \
                   benchmarks/rmw_perf           \
+                  benchmarks/counter_perf       \
+                  benchmarks/rwlock_perf      \
                   # end
 
 TESTS          += benchmarks/ping-pong          \
@@ -15,6 +17,8 @@ TESTS          += benchmarks/ping-pong          \
                   benchmarks/contiguous-bench   \
                   benchmarks/strided-bench      \
                   benchmarks/rmw_perf           \
+                  benchmarks/counter_perf       \
+                  benchmarks/rwlock_perf      \
                   # end
 
 benchmarks_ping_pong_LDADD = libarmci.la
@@ -23,3 +27,5 @@ benchmarks_contiguous_bench_LDADD = libarmci.la -lm
 benchmarks_strided_bench_LDADD = libarmci.la -lm
 benchmarks_bench_groups_LDADD = libarmci.la -lm
 benchmarks_rmw_perf_LDADD = libarmci.la
+benchmarks_counter_perf_LDADD = libarmci.la
+benchmarks_rwlock_perf_LDADD = libarmci.la
@@ -21,7 +21,7 @@ int main(int argc, char **argv) {
   MPI_Comm_rank(MPI_COMM_WORLD, &me);
   MPI_Comm_size(MPI_COMM_WORLD, &nproc);
 
-  procs = malloc(sizeof(int) * ( nproc/2 + (nproc % 2 ? 1 : 0 )));
+  procs = malloc(sizeof(int) * nproc);
 
   if (me == 0) printf("ARMCI Group test starting on %d procs\n", nproc);
 
@@ -74,6 +74,61 @@ int main(int argc, char **argv) {
   }
   /***********************************************************************/
 
+  /***********************************************************************/
+  {
+    const char *names[] = { "collective", "create_group", "intercomm" };
+    const int   iter    = 100;
+    ARMCI_Group g_parent;
+    int         m, size;
+
+    /* The intercommunicator method needs a private parent communicator */
+    g_parent = g_world;
+    if (g_parent.noncoll_pgroup_comm == MPI_COMM_NULL)
+      MPI_Comm_dup(g_world.comm, &g_parent.noncoll_pgroup_comm);
+
+    if (me == 0) printf(" + Group creation latency (us)\n%-14s %8s %12s\n", "method", "size", "time");
+
+    for (m = 0; m < 3; m++) {
+#ifndef HAVE_MPI_COMM_CREATE_GROUP
+      if (m == 1) continue;
+#endif
+      ARMCII_GLOBAL_STATE.noncollective_groups = (m > 0);
+      ARMCII_GLOBAL_STATE.noncoll_method       = (m == 1) ? ARMCII_NONCOLL_CREATE_GROUP : ARMCII_NONCOLL_INTERCOMM;
+
+      for (size = 1; ; size = (2*size > nproc && size < nproc) ? nproc : 2*size) {
+        double t_create = 0, t_max;
+        ARMCI_Group g_new;
+
+        for (i = 0; i < size; i++)
+          procs[i] = i;
+
+        ARMCI_Barrier();
+
+        if (m == 0 || me < size) {
+          t_create = MPI_Wtime();
+
+          for (i = 0; i < iter; i++) {
+            ARMCI_Group_create_child(size, procs, &g_new, &g_parent);
+            ARMCI_Group_free(&g_new);
+          }
+
+          t_create = MPI_Wtime() - t_create;
+        }
+
+        MPI_Reduce(&t_create, &t_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        if (me == 0) printf("%-14s %8d %12.3f\n", names[m], size, t_max/iter * 1.0e6);
+
+        if (size >= nproc) break;
+      }
+    }
+
+    if (g_parent.noncoll_pgroup_comm != g_world.noncoll_pgroup_comm)
+      MPI_Comm_free(&g_parent.noncoll_pgroup_comm);
+
+    ARMCI_Barrier();
+  }
+  /***********************************************************************/
+
   if (me == 0) printf(" + Freeing groups\n");
 
   if (me % 2 > 0)
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+/* Strong-scaling benchmark for shared counters: all processes drain a fixed
+ * number of indices from a counter, first with plain ARMCI_Rmw on rank 0, then
+ * with ARMCIX_Counter in flat and hierarchical mode.  Every index must be
+ * handed out exactly once. */
+
+static int check_complete(int *complete, int count, int rank, const char *name)
+{
+    int i, errors = 0;
+
+    MPI_Allreduce(MPI_IN_PLACE, complete, count, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        for (i = 0; i < count; i++) {
+            if (complete[i] != 1) {
+                if (errors < 10)
+                    printf("%s: counter value %d received %d times\n", name, i, complete[i]);
+                errors++;
+            }
+        }
+    }
+
+    MPI_Bcast(&errors, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    return errors;
+}
+
+static void report(double tt, int nrecv, int rank, int nproc, const char *name)
+{
+    double tmax, rate;
+    int    ntotal;
+
+    MPI_Reduce(&tt, &tmax, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&nrecv, &ntotal, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        rate = tmax > 0 ? ntotal / tmax : 0;
+        printf("%-14s %6d procs %10d indices %12.6f s %14.1f indices/s %10.3f us/index/proc\n",
+               name, nproc, ntotal, tmax, rate, tmax > 0 ? 1.e6*tmax*nproc/ntotal : 0);
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int rank, nproc, errors = 0;
+
+    MPI_Init(&argc, &argv);
+    ARMCI_Init();
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+    int count = ( argc > 1 ? atoi(argv[1]) : 100000 );
+
+    int * complete = (int *) malloc(sizeof(int) * count);
+
+    if (rank == 0) {
+        printf("Shared counter benchmark - %d indices\n", count);
+        fflush(stdout);
+    }
+
+    /* Baseline: ARMCI_Rmw on a single counter */
+    {
+        void ** base_ptrs = malloc(sizeof(void*)*nproc);
+        long    val = -1;
+        int     nrecv = 0;
+        double  t0, tt;
+
+        ARMCI_Malloc(base_ptrs, sizeof(long));
+
+        ARMCI_Access_begin(base_ptrs[rank]);
+        *(long*) base_ptrs[rank] = 0;
+        ARMCI_Access_end(base_ptrs[rank]);
+
+        memset(complete, 0, sizeof(int) * count);
+        ARMCI_Barrier();
+
+        t0 = MPI_Wtime();
+        for (;;) {
+            ARMCI_Rmw(ARMCI_FETCH_AND_ADD_LONG, &val, base_ptrs[0], 1, 0);
+            if (val >= count) break;
+            complete[val]++;
+            nrecv++;
+        }
+        tt = MPI_Wtime() - t0;
+
+        report(tt, nrecv, rank, nproc, "ARMCI_Rmw");
+        errors += check_complete(complete, count, rank, "ARMCI_Rmw");
+
+        ARMCI_Free(base_ptrs[rank]);
+        free(base_ptrs);
+    }
+
+    /* ARMCIX_Counter, flat and hierarchical */
+    {
+        const int   flags[] = { 0, ARMCIX_COUNTER_HIERARCHICAL };
+        const char *names[] = { "Counter", "Counter-hier" };
+        int m;
+
+        for (m = 0; m < 2; m++) {
+            armcix_counter_t cnt = ARMCIX_Counter_create(NULL, count, flags[m]);
+            int    nrecv = 0;
+            long   val;
+            double t0, tt;
+
+            memset(complete, 0, sizeof(int) * count);
+            ARMCI_Barrier();
+
+            t0 = MPI_Wtime();
+            while ((val = ARMCIX_Counter_next(cnt)) < count) {
+                complete[val]++;
+                nrecv++;
+            }
+            tt = MPI_Wtime() - t0;
+
+            report(tt, nrecv, rank, nproc, names[m]);
+            errors += check_complete(complete, count, rank, names[m]);
+
+            ARMCIX_Counter_destroy(cnt);
+        }
+    }
+
+    free(complete);
+
+    if (rank == 0) {
+        if (errors == 0) printf("Test complete: PASS.\n");
+        else             printf("Test fail: %d errors.\n", errors);
+    }
+
+    ARMCI_Finalize();
+    MPI_Finalize();
+
+    return errors != 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+/* Reader-writer lock benchmark: all processes access a small table of shared
+ * records, each guarded by one lock on its owner.  Readers fetch a record and
+ * check that it is consistent, writers update both of its fields.  Each mix of
+ * reads and writes is run with exclusive mutexes and with rwlocks in each
+ * mode. */
+
+#define NLOCKS 4
+
+typedef struct {
+    long a;
+    long b;
+} record_t;
+
+static const char *lock_names[] = { "mutex", "rwlock", "rwlock-wpref", "rwlock-fair" };
+static const int   lock_flags[] = { 0, 0, ARMCIX_RWLOCK_WRITER_PREF, ARMCIX_RWLOCK_FAIR };
+
+static int run(int kind, int read_pct, int niter, record_t **table, int rank, int nproc,
+               double *elapsed, long *nwrites)
+{
+    armcix_mutex_hdl_t  mhdl = NULL;
+    armcix_rwlock_hdl_t rhdl = NULL;
+    ARMCI_Group         world;
+    int                 i, errors = 0;
+    double              t0;
+
+    ARMCI_Group_get_world(&world);
+
+    if (kind == 0)
+        mhdl = ARMCIX_Create_mutexes_hdl(NLOCKS, &world);
+    else
+        rhdl = ARMCIX_Create_rwlocks_hdl(NLOCKS, &world, lock_flags[kind]);
+
+    srand(rank + 1);
+    *nwrites = 0;
+
+    ARMCI_Barrier();
+    t0 = MPI_Wtime();
+
+    for (i = 0; i < niter; i++) {
+        const int proc    = rand() % nproc;
+        const int lock    = rand() % NLOCKS;
+        const int is_read = (rand() % 100) < read_pct;
+        record_t  rec;
+
+        if (kind == 0)
+            ARMCIX_Lock_hdl(mhdl, lock, proc);
+        else if (is_read)
+            ARMCIX_Rdlock_hdl(rhdl, lock, proc);
+        else
+            ARMCIX_Wrlock_hdl(rhdl, lock, proc);
+
+        ARMCI_Get(&table[proc][lock], &rec, sizeof(record_t), proc);
+
+        if (rec.a != rec.b) {
+            printf("%d: %s record (%d, %d) is inconsistent: %ld != %ld\n",
+                   rank, lock_names[kind], proc, lock, rec.a, rec.b);
+            errors++;
+        }
+
+        if (!is_read) {
+            rec.a++;
+            ARMCI_Put(&rec.a, &table[proc][lock].a, sizeof(long), proc);
+            ARMCI_Fence(proc);
+            rec.b++;
+            ARMCI_Put(&rec.b, &table[proc][lock].b, sizeof(long), proc);
+            ARMCI_Fence(proc);
+            (*nwrites)++;
+        }
+
+        if (kind == 0)
+            ARMCIX_Unlock_hdl(mhdl, lock, proc);
+        else
+            ARMCIX_Rwunlock_hdl(rhdl, lock, proc);
+    }
+
+    *elapsed = MPI_Wtime() - t0;
+    ARMCI_Barrier();
+
+    if (kind == 0)
+        ARMCIX_Destroy_mutexes_hdl(mhdl);
+    else
+        ARMCIX_Destroy_rwlocks_hdl(rhdl);
+
+    return errors;
+}
+
+int main(int argc, char* argv[])
+{
+    const int read_pcts[] = { 50, 90, 99 };
+    int       rank, nproc, errors = 0, k, r, i;
+    record_t **table;
+
+    MPI_Init(&argc, &argv);
+    ARMCI_Init();
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+    int niter = ( argc > 1 ? atoi(argv[1]) : 1000 );
+
+    table = malloc(sizeof(record_t*)*nproc);
+    ARMCI_Malloc((void**) table, NLOCKS*sizeof(record_t));
+
+    if (rank == 0) {
+        printf("Reader-writer lock benchmark - %d operations per process\n", niter);
+        printf("%-14s %6s %12s %14s\n", "lock", "read%", "time (s)", "ops/s");
+        fflush(stdout);
+    }
+
+    for (r = 0; r < (int) (sizeof(read_pcts)/sizeof(int)); r++) {
+        for (k = 0; k < (int) (sizeof(lock_flags)/sizeof(int)); k++) {
+            double elapsed, tmax;
+            long   nwrites, total_writes, sum;
+
+            ARMCI_Access_begin(table[rank]);
+            memset(table[rank], 0, NLOCKS*sizeof(record_t));
+            ARMCI_Access_end(table[rank]);
+
+            errors += run(k, read_pcts[r], niter, table, rank, nproc, &elapsed, &nwrites);
+
+            /* Every write must have been applied exactly once */
+            ARMCI_Access_begin(table[rank]);
+            for (i = 0, sum = 0; i < NLOCKS; i++)
+                sum += table[rank][i].a;
+            ARMCI_Access_end(table[rank]);
+
+            MPI_Allreduce(MPI_IN_PLACE, &sum, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+            MPI_Allreduce(&nwrites, &total_writes, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+            MPI_Reduce(&elapsed, &tmax, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+            if (sum != total_writes) {
+                if (rank == 0)
+                    printf("%s: %ld writes applied, expected %ld\n", lock_names[k], sum, total_writes);
+                errors++;
+            }
+
+            if (rank == 0) {
+                printf("%-14s %6d %12.6f %14.1f\n", lock_names[k], read_pcts[r], tmax,
+                       tmax > 0 ? niter*nproc/tmax : 0);
+                fflush(stdout);
+            }
+        }
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        if (errors == 0) printf("Test complete: PASS.\n");
+        else             printf("Test fail: %d errors.\n", errors);
+    }
+
+    ARMCI_Free(table[rank]);
+    free(table);
+
+    ARMCI_Finalize();
+    MPI_Finalize();
+
+    return errors != 0;
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <armci.h>
+#include <armcix.h>
+#include <armci_internals.h>
+#include <debug.h>
+#include <gmr.h>
+
+/** Traffic statistics of one allocation, as kept for freed allocations and
+  * exchanged in the finalize report.  Allocations are identified by their
+  * debug name, or by their group leader and creation order on it if they
+  * have none.
+  */
+typedef struct {
+  char                 key[MPI_MAX_OBJECT_NAME+1];
+  long                 size;            /* Bytes in the local slices            */
+  armcix_alloc_stats_t stats;
+} alloc_record_t;
+
+/* The hottest freed allocations, at most ARMCII_GLOBAL_STATE.alloc_stats_top */
+static alloc_record_t *retired     = NULL;
+static int             retired_len = 0;
+
+
+/** Total bytes transferred, used to rank allocations.
+  */
+static long alloc_heat(const armcix_alloc_stats_t *stats) {
+  long heat = 0;
+  int  op, t;
+
+  for (op = 0; op < ARMCIX_ALLOC_NOPS; op++)
+    for (t = 0; t < ARMCIX_ALLOC_NTARGETS; t++)
+      heat += stats->bytes[op][t];
+
+  return heat;
+}
+
+
+static long alloc_nops(const armcix_alloc_stats_t *stats) {
+  long nops = 0;
+  int  op, t;
+
+  for (op = 0; op < ARMCIX_ALLOC_NOPS; op++)
+    for (t = 0; t < ARMCIX_ALLOC_NTARGETS; t++)
+      nops += stats->ops[op][t];
+
+  return nops;
+}
+
+
+static void alloc_record_fill(alloc_record_t *rec, gmr_t *mreg) {
+  memset(rec, 0, sizeof(alloc_record_t));
+
+  if (mreg->name[0] != '\0')
+    snprintf(rec->key, sizeof(rec->key), "%s", mreg->name);
+  else
+    snprintf(rec->key, sizeof(rec->key), "#%d.%d", mreg->leader, mreg->seq);
+
+  rec->size  = mreg->slices[ARMCI_GROUP_WORLD.rank].size;
+  rec->stats = mreg->stats;
+}
+
+
+/** Order records by decreasing heat, with empty records last.
+  */
+static int alloc_record_cmp_heat(const void *a, const void *b) {
+  const alloc_record_t *ra = a, *rb = b;
+  const long ha = ra->key[0] ? alloc_heat(&ra->stats) : -1;
+  const long hb = rb->key[0] ? alloc_heat(&rb->stats) : -1;
+
+  return (ha < hb) - (ha > hb);
+}
+
+
+static int alloc_record_cmp_key(const void *a, const void *b) {
+  return strcmp(((const alloc_record_t*) a)->key, ((const alloc_record_t*) b)->key);
+}
+
+
+/** Query the traffic this process has issued on an allocation.
+  *
+  * @param[in]  ptr   Address within the calling process's slice of the allocation
+  * @param[out] stats Statistics of the allocation
+  * @return           Zero on success, non-zero if ptr is not in an allocation
+  */
+int ARMCIX_Alloc_stats(void *ptr, armcix_alloc_stats_t *stats) {
+  gmr_t *mreg = gmr_lookup(ptr, ARMCI_GROUP_WORLD.rank);
+
+  if (mreg == NULL)
+    return 1;
+
+  *stats = mreg->stats;
+  return 0;
+}
+
+
+/** Keep the statistics of an allocation that is being freed, if it is among
+  * the hottest so far.
+  *
+  * @param[in] mreg Memory region being destroyed
+  */
+void ARMCII_Alloc_stats_retire(gmr_t *mreg) {
+  const int top = ARMCII_GLOBAL_STATE.alloc_stats_top;
+  int       i, coldest = 0;
+
+  if (top <= 0)
+    return;
+
+  if (retired == NULL) {
+    retired = malloc(sizeof(alloc_record_t) * top);
+    ARMCII_Assert(retired != NULL);
+  }
+
+  if (retired_len < top) {
+    alloc_record_fill(&retired[retired_len++], mreg);
+    return;
+  }
+
+  for (i = 1; i < retired_len; i++)
+    if (alloc_heat(&retired[i].stats) < alloc_heat(&retired[coldest].stats))
+      coldest = i;
+
+  if (alloc_heat(&mreg->stats) > alloc_heat(&retired[coldest].stats))
+    alloc_record_fill(&retired[coldest], mreg);
+}
+
+
+/** Print the hottest allocations, combining the statistics of all processes,
+  * and stop keeping statistics of freed allocations.  Each process
+  * contributes its own hottest allocations, so the result is exact when
+  * every process's share of the top allocations is among its own top ones.
+  * Collective on the world group.
+  */
+void ARMCII_Alloc_stats_report(void) {
+  const int       top = ARMCII_GLOBAL_STATE.alloc_stats_top;
+  alloc_record_t *local, *all = NULL;
+  gmr_t          *mreg;
+  int             nlocal, i, j, nall;
+
+  if (top <= 0)
+    return;
+
+  for (mreg = gmr_list, nlocal = retired_len; mreg != NULL; mreg = mreg->next)
+    nlocal++;
+
+  local = calloc(nlocal > top ? nlocal : top, sizeof(alloc_record_t));
+  ARMCII_Assert(local != NULL);
+
+  if (retired_len > 0)
+    memcpy(local, retired, sizeof(alloc_record_t) * retired_len);
+
+  for (mreg = gmr_list, i = retired_len; mreg != NULL; mreg = mreg->next)
+    alloc_record_fill(&local[i++], mreg);
+
+  qsort(local, nlocal, sizeof(alloc_record_t), alloc_record_cmp_heat);
+
+  if (ARMCI_GROUP_WORLD.rank == 0) {
+    all = malloc(sizeof(alloc_record_t) * top * ARMCI_GROUP_WORLD.size);
+    ARMCII_Assert(all != NULL);
+  }
+
+  MPI_Gather(local, sizeof(alloc_record_t) * top, MPI_BYTE, all, sizeof(alloc_record_t) * top,
+             MPI_BYTE, 0, ARMCI_GROUP_WORLD.comm);
+
+  if (ARMCI_GROUP_WORLD.rank == 0) {
+    nall = top * ARMCI_GROUP_WORLD.size;
+
+    /* Combine the records of each allocation */
+    qsort(all, nall, sizeof(alloc_record_t), alloc_record_cmp_key);
+
+    for (i = 0, j = -1; i < nall; i++) {
+      int op, t;
+
+      if (all[i].key[0] == '\0')
+        continue;
+
+      if (j < 0 || strcmp(all[j].key, all[i].key) != 0) {
+        all[++j] = all[i];
+        continue;
+      }
+
+      all[j].size          += all[i].size;
+      all[j].stats.flushes += all[i].stats.flushes;
+
+      for (op = 0; op < ARMCIX_ALLOC_NOPS; op++) {
+        for (t = 0; t < ARMCIX_ALLOC_NTARGETS; t++) {
+          all[j].stats.ops[op][t]   += all[i].stats.ops[op][t];
+          all[j].stats.bytes[op][t] += all[i].stats.bytes[op][t];
+        }
+      }
+    }
+
+    nall = j + 1;
+    qsort(all, nall, sizeof(alloc_record_t), alloc_record_cmp_heat);
+
+    printf("ARMCI allocation statistics, top %d allocations by bytes transferred:\n",
+           nall < top ? nall : top);
+    printf("  %-24s %14s %10s %14s %14s %14s %14s %14s %14s %10s\n", "name", "size", "ops",
+           "get_local", "get_remote", "put_local", "put_remote", "acc_local", "acc_remote", "flushes");
+
+    for (i = 0; i < nall && i < top; i++) {
+      const armcix_alloc_stats_t *s = &all[i].stats;
+
+      printf("  %-24s %14ld %10ld %14ld %14ld %14ld %14ld %14ld %14ld %10ld\n", all[i].key,
+             all[i].size, alloc_nops(s),
+             s->bytes[ARMCIX_ALLOC_GET][ARMCIX_ALLOC_LOCAL], s->bytes[ARMCIX_ALLOC_GET][ARMCIX_ALLOC_REMOTE],
+             s->bytes[ARMCIX_ALLOC_PUT][ARMCIX_ALLOC_LOCAL], s->bytes[ARMCIX_ALLOC_PUT][ARMCIX_ALLOC_REMOTE],
+             s->bytes[ARMCIX_ALLOC_ACC][ARMCIX_ALLOC_LOCAL], s->bytes[ARMCIX_ALLOC_ACC][ARMCIX_ALLOC_REMOTE],
+             s->flushes);
+    }
+
+    fflush(stdout);
+    free(all);
+  }
+
+  free(local);
+  free(retired);
+  retired     = NULL;
+  retired_len = 0;
+
+  ARMCII_GLOBAL_STATE.alloc_stats_top = 0;
+}
@@ -153,11 +153,12 @@ int ARMCI_Rmw(int op, void *ploc, void *prem, int value, int proc);
 /** ARMCI Groups API
   */
 
+struct armcii_rank_map_s;
+
 typedef struct {
   MPI_Comm  comm;
   MPI_Comm  noncoll_pgroup_comm;
-  int      *grp_to_abs;
-  int      *abs_to_grp;
+  struct armcii_rank_map_s *rank_map;
   int       rank;
   int       size;
 } ARMCI_Group;
@@ -67,17 +67,22 @@ enum ARMCII_Iov_methods_e { ARMCII_IOV_AUTO, ARMCII_IOV_CONSRV,
 
 enum ARMCII_Shr_buf_methods_e { ARMCII_SHR_BUF_COPY, ARMCII_SHR_BUF_NOGUARD };
 
+enum ARMCII_Noncoll_methods_e { ARMCII_NONCOLL_CREATE_GROUP, ARMCII_NONCOLL_INTERCOMM };
+
 extern char ARMCII_Strided_methods_str[][10];
 extern char ARMCII_Iov_methods_str[][10];
 extern char ARMCII_Shr_buf_methods_str[][10];
+extern char ARMCII_Noncoll_methods_str[][13];
 
 typedef struct {
   int           init_count;             /* Number of times ARMCI_Init has been called                           */
   int           debug_alloc;            /* Do extra debuggin on memory allocation                               */
-  int           iov_checks;             /* Disable IOV same allocation and overlapping checks                   */
+  int           iov_checks;             /* Enable IOV overlapping checks                                        */
   int           iov_batched_limit;      /* Max number of ops per epoch for BATCHED IOV method                   */
+  int           iov_batched_adaptive;   /* Adapt the BATCHED IOV flush interval to the observed flush latency   */
   int           noncollective_groups;   /* Use noncollective group creation algorithm                           */
-  int           cache_rank_translation; /* Enable caching of translation between absolute and group ranks       */
+  int           group_cache;            /* Reuse groups created repeatedly with the same parent and members     */
+  int           group_cache_size;       /* Max number of unreferenced groups kept in the group cache            */
   int           verbose;                /* ARMCI should produce extra status output                             */
 #ifdef HAVE_PTHREADS
   int           progress_thread;        /* Create progress thread                                               */
@@ -88,22 +93,72 @@ typedef struct {
   int           rma_atomicity;          /* Use Accumulate and Get_accumulate for Put and Get                    */
   int           end_to_end_flush;       /* All flush_local calls become flush                                   */
   int           rma_nocheck;            /* Use MPI_MODE_NOCHECK on synchronization calls that take assertion    */
+  int           mutex_biased;           /* Mutex holders keep ownership until another process requests it      */
+  int           mutex_qnodes;           /* Queue nodes per process, max mutexes held at once per mutex handle   */
+  int           hier_coll_threshold;    /* Min message size for two-level SCOPE_ALL collectives, 0 to disable  */
+  int           alloc_stats_top;        /* Number of allocations in the finalize traffic report, 0 to disable   */
 
   enum ARMCII_Strided_methods_e strided_method; /* Strided transfer method              */
   enum ARMCII_Iov_methods_e     iov_method;     /* IOV transfer method                  */
   enum ARMCII_Shr_buf_methods_e shr_buf_method; /* Shared buffer management method      */
+  enum ARMCII_Noncoll_methods_e noncoll_method; /* Noncollective group creation method  */
 } global_state_t;
 
 
+/* Number of targets whose BATCHED IOV flush window is tracked at once */
+#define ARMCII_IOV_FLUSH_CTL_NTARGETS 64
+
+/** Flush window of the BATCHED IOV method for one target.  The bounds apply
+  * to the operations outstanding on that target.
+  */
+typedef struct {
+  int           proc;                   /* Target (absolute rank), -1 when the entry is unused                  */
+  int           max_ops;                /* Operations allowed between flushes                                   */
+  long          max_bytes;              /* Bytes allowed between flushes                                        */
+  double        cost;                   /* Smoothed flush time per outstanding byte (seconds)                   */
+} armcii_iov_flush_target_t;
+
+/** Adaptive flush controller for the BATCHED IOV method.  Windows are kept
+  * per target in a table indexed by the target's rank; a target that maps to
+  * an entry in use by another one replaces it and starts from the initial
+  * window.
+  */
+typedef struct {
+  armcii_iov_flush_target_t targets[ARMCII_IOV_FLUSH_CTL_NTARGETS];
+  long          nflushes;               /* Number of flushes issued by the controller                           */
+  long          ngrow;                  /* Number of times the window was grown                                 */
+  long          nshrink;                /* Number of times the window was shrunk                                */
+} armcii_iov_flush_ctl_t;
+
+
+/* Number of data types in GOP operation tables, indexed by ARMCI type */
+#define ARMCII_GOP_NTYPES (ARMCI_DOUBLE+1)
+
+
+/* Operation classes counted in the communication matrix */
+enum ARMCII_Comm_op_e { ARMCII_COMM_GET, ARMCII_COMM_PUT, ARMCII_COMM_ACC, ARMCII_COMM_RMW,
+                        ARMCII_COMM_NOPS };
+
+/** One entry of the communication matrix: traffic from this process to one
+  * target for one operation class.
+  */
+typedef struct {
+  uint64_t      count;                  /* Number of operations                                                 */
+  uint64_t      bytes;                  /* Bytes transferred                                                    */
+} armcii_comm_cell_t;
+
+
 /* Global data */
 
 extern ARMCI_Group    ARMCI_GROUP_WORLD;
 extern ARMCI_Group    ARMCI_GROUP_DEFAULT;
-extern MPI_Op         MPI_ABSMIN_OP;
-extern MPI_Op         MPI_ABSMAX_OP;
+extern MPI_Op         ARMCII_Absmin_ops[ARMCII_GOP_NTYPES];
+extern MPI_Op         ARMCII_Absmax_ops[ARMCII_GOP_NTYPES];
 extern MPI_Op         MPI_SELMIN_OP;
 extern MPI_Op         MPI_SELMAX_OP;
 extern global_state_t ARMCII_GLOBAL_STATE;
+extern armcii_iov_flush_ctl_t ARMCII_IOV_FLUSH_CTL;
+extern armcii_comm_cell_t *ARMCII_Comm_matrix;
 #ifdef HAVE_PTHREADS
 extern pthread_t      ARMCI_Progress_thread;
 #endif
@@ -112,6 +167,7 @@ extern pthread_t      ARMCI_Progress_thread;
 
 void  ARMCII_Bzero(void *buf, armci_size_t size);
 int   ARMCII_Log2(unsigned int val);
+void  ARMCII_Backoff(unsigned distance);
 char *ARMCII_Getenv(const char *varname);
 int   ARMCII_Getenv_bool(const char *varname, int default_value);
 int   ARMCII_Getenv_int(const char *varname, int default_value);
@@ -120,19 +176,70 @@ int   ARMCII_Getenv_int(const char *varname, int default_value);
 
 void ARMCII_Sync_local(void);
 
+/* Communication matrix */
+
+void ARMCII_Comm_matrix_init(void);
+void ARMCII_Comm_matrix_finalize(void);
+
+/* Count an operation of the given class from this process to target.  The
+ * matrix row is only allocated when ARMCI_COMM_MATRIX is set, so this is a
+ * single predictable branch otherwise. */
+#define ARMCII_COMM_MATRIX_RECORD(op, target, nbytes)                                   \
+  do {                                                                                  \
+    if (unlikely(ARMCII_Comm_matrix != NULL)) {                                         \
+      armcii_comm_cell_t *cell_ = &ARMCII_Comm_matrix[(target)*ARMCII_COMM_NOPS + (op)]; \
+      cell_->count++;                                                                   \
+      cell_->bytes += (nbytes);                                                         \
+    }                                                                                   \
+  } while (0)
+
 /* GOP Operators */
 
-void ARMCII_Absmin_op(void *invec, void *inoutvec, int *len, MPI_Datatype *datatype);
-void ARMCII_Absmax_op(void *invec, void *inoutvec, int *len, MPI_Datatype *datatype);
-void ARMCII_Absv_op(void *invec, void *inoutvec, int *len, MPI_Datatype *datatype);
+void ARMCII_Gop_ops_create(void);
+void ARMCII_Gop_ops_free(void);
+void ARMCII_Absv(void *x, int n, int type);
 void ARMCII_Msg_sel_min_op(void *data_in, void *data_inout, int *len, MPI_Datatype *datatype);
 void ARMCII_Msg_sel_max_op(void *data_in, void *data_inout, int *len, MPI_Datatype *datatype);
 
 
+/** Node hierarchy of a group, used by scoped and two-level collectives.  It is
+  * built on first use and cached as an attribute of the group's communicator.
+  */
+typedef struct {
+  MPI_Comm      node_comm;      /* Members of the group on my node                        */
+  MPI_Comm      leader_comm;    /* Node leaders, MPI_COMM_NULL on other processes          */
+  int           nnodes;         /* Number of nodes spanned by the group                    */
+  int          *node_of;        /* Node of each group rank (its rank in leader_comm)       */
+  int          *node_rank_of;   /* Rank of each group rank in its node_comm                */
+} ARMCII_Msg_hier_t;
+
+ARMCII_Msg_hier_t *ARMCII_Msg_hier_get(ARMCI_Group *group);
+void               ARMCII_Msg_hier_finalize(void);
+
+
 /* Group helper routines */
 
+/** Translation between group and absolute ranks.  Groups whose members are
+  * evenly spaced in the world group are described by their first member and
+  * the stride.  Other groups keep the absolute rank of each member, plus the
+  * members ordered by absolute rank when that is not already the group order.
+  */
+typedef struct armcii_rank_map_s {
+  int   first;          /* Absolute rank of group rank 0 (strided maps)               */
+  int   stride;         /* Distance between consecutive members, 0 for irregular maps */
+  int   size;           /* Number of members                                          */
+  int  *grp_to_abs;     /* Irregular maps: absolute rank of each member               */
+  int  *by_abs;         /* Irregular maps: group ranks sorted by absolute rank, or
+                           NULL if grp_to_abs is increasing                           */
+  int   id[2];          /* Identity of the group, the same on all members: absolute
+                           rank of group rank 0 and its count of groups created      */
+} armcii_rank_map_t;
+
 int  ARMCII_Translate_absolute_to_group(ARMCI_Group *group, int world_rank);
 void ARMCII_Group_init_from_comm(ARMCI_Group *group);
+void ARMCII_Group_cache_destroy_all(void);
+int  ARMCII_Rank_map_to_group(armcii_rank_map_t *map, int world_rank);
+int  ARMCII_Rank_map_to_absolute(armcii_rank_map_t *map, int group_rank);
 
 
 /* I/O Vector data management and implementation */
@@ -168,11 +275,15 @@ void ARMCII_Strided_to_iov(armci_giov_t *iov,
 void ARMCII_Strided_to_dtype(int stride_array[/*stride_levels*/], int count[/*stride_levels+1*/],
                              int stride_levels, MPI_Datatype old_type, MPI_Datatype *new_type);
 
+void ARMCII_Iov_flush_ctl_init(void);
+
 int ARMCII_Iov_op_dispatch(enum ARMCII_Op_e op, void **src, void **dst, int count, int size,
     int datatype, int overlapping, int same_alloc, int proc, int blocking);
 
 int ARMCII_Iov_op_batched(enum ARMCII_Op_e op, void **src, void **dst, int count, int elem_count,
     MPI_Datatype type, int proc, int consrv /* if 1, batched = safe */, int blocking);
+int ARMCII_Iov_op_grouped(enum ARMCII_Op_e op, void **src, void **dst, int count, int elem_count,
+    MPI_Datatype type, int proc, int blocking);
 int ARMCII_Iov_op_datatype(enum ARMCII_Op_e op, void **src, void **dst, int count, int elem_count,
     MPI_Datatype type, int proc, int blocking);
 
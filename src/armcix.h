@@ -20,17 +20,27 @@
 int ARMCIX_Group_split(ARMCI_Group *parent, int color, int key, ARMCI_Group *new_group);
 int ARMCIX_Group_dup(ARMCI_Group *parent, ARMCI_Group *new_group);
 
+void ARMCIX_Barrier_group(ARMCI_Group *group);
+void ARMCIX_AllFence_group(ARMCI_Group *group);
+
 /** Mutex handles: These improve on basic ARMCI mutexes by allowing you to
   * create multiple batches of mutexes.  This is needed to allow libraries access to
   * mutexes.
+  *
+  * With the default queue mutexes, a process can hold, wait for, or keep
+  * cached at most ARMCI_MUTEX_QNODES (default: 64) mutexes of a handle at
+  * once; exceeding this limit is a fatal error.
   */
 
 struct armcix_mutex_hdl_s {
   int         my_count;
   int         max_count;
   ARMCI_Group grp;
-  MPI_Win    *windows;
-  uint8_t   **bases;
+  MPI_Win     window;
+  int        *base;
+  int        *held;
+  int         biased;
+  int         nqnodes;
 };
 
 typedef struct armcix_mutex_hdl_s * armcix_mutex_hdl_t;
@@ -41,6 +51,150 @@ void ARMCIX_Lock_hdl(armcix_mutex_hdl_t hdl, int mutex, int proc);
 int  ARMCIX_Trylock_hdl(armcix_mutex_hdl_t hdl, int mutex, int proc);
 void ARMCIX_Unlock_hdl(armcix_mutex_hdl_t hdl, int mutex, int proc);
 
+/** Reader-writer lock handles: Groups of locks that can be held by many
+  * readers or by one writer.
+  */
+
+enum armcix_rwlock_flags_e {
+  ARMCIX_RWLOCK_WRITER_PREF = 0x1,      /* Waiting writers block new readers       */
+  ARMCIX_RWLOCK_FAIR        = 0x2       /* Grant the lock in FIFO order            */
+};
+
+struct armcix_rwlock_hdl_s {
+  int         my_count;
+  int         max_count;
+  int         flags;
+  ARMCI_Group grp;
+  MPI_Win     window;
+  int64_t    *base;
+  int        *held;
+  int         nheld;
+  int         max_held;
+};
+
+typedef struct armcix_rwlock_hdl_s * armcix_rwlock_hdl_t;
+
+armcix_rwlock_hdl_t ARMCIX_Create_rwlocks_hdl(int count, ARMCI_Group *pgroup, int flags);
+int  ARMCIX_Destroy_rwlocks_hdl(armcix_rwlock_hdl_t hdl);
+void ARMCIX_Rdlock_hdl(armcix_rwlock_hdl_t hdl, int lock, int proc);
+void ARMCIX_Wrlock_hdl(armcix_rwlock_hdl_t hdl, int lock, int proc);
+int  ARMCIX_Tryrdlock_hdl(armcix_rwlock_hdl_t hdl, int lock, int proc);
+int  ARMCIX_Trywrlock_hdl(armcix_rwlock_hdl_t hdl, int lock, int proc);
+void ARMCIX_Rwunlock_hdl(armcix_rwlock_hdl_t hdl, int lock, int proc);
+
+/** Multi-target communication: Issue I/O vector or strided transfers to a list
+  * of processes and complete them together.  Transfers are issued in a
+  * staggered target order and each touched window is flushed once per target.
+  */
+
+typedef struct {
+  int           proc;           /* Target process                           */
+  armci_giov_t *iov;            /* I/O vector descriptors for this target   */
+  int           iov_len;        /* Number of descriptors in iov             */
+} armcix_giov_multi_t;
+
+typedef struct {
+  int           proc;           /* Target process                           */
+  void         *src_ptr;        /* Strided descriptor, as in ARMCI_PutS     */
+  int          *src_stride_ar;
+  void         *dst_ptr;
+  int          *dst_stride_ar;
+  int          *count;
+  int           stride_levels;
+} armcix_strided_multi_t;
+
+int ARMCIX_PutV_multi(armcix_giov_multi_t *entries, int nentries);
+int ARMCIX_GetV_multi(armcix_giov_multi_t *entries, int nentries);
+int ARMCIX_AccV_multi(int datatype, void *scale, armcix_giov_multi_t *entries, int nentries);
+
+int ARMCIX_PutS_multi(armcix_strided_multi_t *entries, int nentries);
+int ARMCIX_GetS_multi(armcix_strided_multi_t *entries, int nentries);
+int ARMCIX_AccS_multi(int datatype, void *scale, armcix_strided_multi_t *entries, int nentries);
+
+/** Batched read-modify-write: Issue a list of ARMCI_Rmw operations and complete
+  * them with one flush per touched target.
+  */
+
+int ARMCIX_Rmw_batch(int *ops, void **ploc, void **prem, int *values, int *procs, int n);
+
+/** Extended read-modify-write: Compare-and-swap, fetch-and-op on integer and
+  * floating point types, and atomic reads and writes.
+  */
+
+enum armcix_rmw_op_e {
+  ARMCIX_RMW_CAS,                       /* Compare-and-swap (integer types only)   */
+  ARMCIX_RMW_FETCH_AND_ADD,             /* Fetch-and-add                           */
+  ARMCIX_RMW_FETCH_AND_MIN,             /* Fetch-and-min                           */
+  ARMCIX_RMW_FETCH_AND_MAX,             /* Fetch-and-max                           */
+  ARMCIX_RMW_FETCH_AND_BAND,            /* Fetch-and-bitwise-and (integer types)   */
+  ARMCIX_RMW_FETCH_AND_BOR,             /* Fetch-and-bitwise-or (integer types)    */
+  ARMCIX_RMW_FETCH_AND_BXOR,            /* Fetch-and-bitwise-xor (integer types)   */
+  ARMCIX_RMW_READ,                      /* Atomic read                             */
+  ARMCIX_RMW_WRITE                      /* Atomic write, returns the old value     */
+};
+
+enum armcix_rmw_type_e {
+  ARMCIX_RMW_INT,                       /* int     */
+  ARMCIX_RMW_LONG,                      /* long    */
+  ARMCIX_RMW_INT64,                     /* int64_t */
+  ARMCIX_RMW_FLOAT,                     /* float   */
+  ARMCIX_RMW_DOUBLE                     /* double  */
+};
+
+int ARMCIX_Rmw_ext(int op, int type, void *ploc, void *prem, void *value, void *compare, int proc);
+
+/** Per-allocation traffic statistics: Operations issued by the calling process
+  * on an allocation, by operation type and by whether the target was the
+  * calling process (local) or another process (remote).  Atomic operations
+  * are counted as accumulates.
+  */
+
+enum armcix_alloc_op_e {
+  ARMCIX_ALLOC_GET,                     /* Get                                     */
+  ARMCIX_ALLOC_PUT,                     /* Put                                     */
+  ARMCIX_ALLOC_ACC,                     /* Accumulate and read-modify-write        */
+  ARMCIX_ALLOC_NOPS
+};
+
+enum armcix_alloc_target_e {
+  ARMCIX_ALLOC_LOCAL,                   /* Target is the calling process           */
+  ARMCIX_ALLOC_REMOTE,                  /* Target is another process               */
+  ARMCIX_ALLOC_NTARGETS
+};
+
+typedef struct {
+  long          ops[ARMCIX_ALLOC_NOPS][ARMCIX_ALLOC_NTARGETS];   /* Operations issued      */
+  long          bytes[ARMCIX_ALLOC_NOPS][ARMCIX_ALLOC_NTARGETS]; /* Bytes transferred      */
+  long          flushes;                                         /* Window flushes         */
+} armcix_alloc_stats_t;
+
+int ARMCIX_Alloc_stats(void *ptr, armcix_alloc_stats_t *stats);
+
+/* Name the allocations created until the name is reset, for reports */
+void armci_dbg_set_gmr_name(const char *name);
+void armci_dbg_reset_gmr_name(void);
+
+/** Shared counters (NXTVAL service): Processes lease chunks of indices from a
+  * global counter and hand them out locally.
+  */
+
+enum armcix_counter_flags_e {
+  ARMCIX_COUNTER_HIERARCHICAL = 0x1     /* Combine requests through node leaders */
+};
+
+typedef struct armcix_counter_s * armcix_counter_t;
+
+armcix_counter_t ARMCIX_Counter_create(ARMCI_Group *group, long limit, int flags);
+void ARMCIX_Counter_destroy(armcix_counter_t counter);
+void ARMCIX_Counter_reset(armcix_counter_t counter);
+long ARMCIX_Counter_next(armcix_counter_t counter);
+
+/** Profiling: Current bounds of the adaptive flush controller used by the
+  * BATCHED IOV method for the target proc.
+  */
+
+void ARMCIX_Iov_batched_limits(int proc, int *max_ops, long *max_bytes);
+
 void ARMCIX_Progress(void);
 
 #endif /* _ARMCIX_H_ */
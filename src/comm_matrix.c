@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <armci.h>
+#include <armci_internals.h>
+#include <debug.h>
+
+/** Communication matrix: the number of operations and bytes sent by this
+  * process to each target, per operation class.  The row is indexed by
+  * absolute target rank and operation class, and is NULL when disabled.
+  */
+armcii_comm_cell_t *ARMCII_Comm_matrix = NULL;
+
+static const char *comm_op_names[ARMCII_COMM_NOPS] = { "get", "put", "acc", "rmw" };
+
+/* Fields per nonzero entry gathered at finalize: target, op, count, bytes */
+#define COMM_ENTRY_LEN 4
+
+
+/** Allocate this process's row of the communication matrix if it was
+  * requested with ARMCI_COMM_MATRIX.
+  */
+void ARMCII_Comm_matrix_init(void) {
+  if (!ARMCII_Getenv_bool("ARMCI_COMM_MATRIX", 0))
+    return;
+
+  ARMCII_Comm_matrix = calloc((size_t) ARMCI_GROUP_WORLD.size * ARMCII_COMM_NOPS,
+                              sizeof(armcii_comm_cell_t));
+  ARMCII_Assert(ARMCII_Comm_matrix != NULL);
+}
+
+
+/** Gather the communication matrix on process 0 and write it out.  Two files
+  * are produced: PREFIX.mat holds the total bytes from each origin (row) to
+  * each target (column) as a whitespace-separated square matrix, the format
+  * read by TreeMatch and similar mapping tools, and PREFIX.csv lists the
+  * count and bytes of every nonzero (origin, target, operation) triple.
+  * Collective on the world group.
+  */
+void ARMCII_Comm_matrix_finalize(void) {
+  const int   nproc = ARMCI_GROUP_WORLD.size;
+  const int   me    = ARMCI_GROUP_WORLD.rank;
+  uint64_t   *entries, *all = NULL;
+  int         nentries, t, op, i, j, total = 0;
+  int        *counts = NULL, *displs = NULL;
+
+  if (ARMCII_Comm_matrix == NULL)
+    return;
+
+  /* Pack the nonzero cells of the local row */
+
+  for (t = 0, nentries = 0; t < nproc; t++)
+    for (op = 0; op < ARMCII_COMM_NOPS; op++)
+      if (ARMCII_Comm_matrix[t*ARMCII_COMM_NOPS + op].count > 0)
+        nentries++;
+
+  entries = malloc(sizeof(uint64_t) * COMM_ENTRY_LEN * (nentries > 0 ? nentries : 1));
+  ARMCII_Assert(entries != NULL);
+
+  for (t = 0, i = 0; t < nproc; t++) {
+    for (op = 0; op < ARMCII_COMM_NOPS; op++) {
+      const armcii_comm_cell_t *cell = &ARMCII_Comm_matrix[t*ARMCII_COMM_NOPS + op];
+
+      if (cell->count > 0) {
+        entries[i++] = t;
+        entries[i++] = op;
+        entries[i++] = cell->count;
+        entries[i++] = cell->bytes;
+      }
+    }
+  }
+
+  nentries *= COMM_ENTRY_LEN;
+
+  if (me == 0) {
+    counts = malloc(2 * sizeof(int) * nproc);
+    ARMCII_Assert(counts != NULL);
+    displs = counts + nproc;
+  }
+
+  MPI_Gather(&nentries, 1, MPI_INT, counts, 1, MPI_INT, 0, ARMCI_GROUP_WORLD.comm);
+
+  if (me == 0) {
+    for (i = 0; i < nproc; i++) {
+      displs[i] = total;
+      total    += counts[i];
+    }
+
+    all = malloc(sizeof(uint64_t) * (total > 0 ? total : 1));
+    ARMCII_Assert(all != NULL);
+  }
+
+  MPI_Gatherv(entries, nentries, MPI_UINT64_T, all, counts, displs, MPI_UINT64_T, 0,
+              ARMCI_GROUP_WORLD.comm);
+
+  if (me == 0) {
+    const char *prefix = ARMCII_Getenv("ARMCI_COMM_MATRIX_PREFIX");
+    char        path[1024];
+    FILE       *mat, *csv;
+    uint64_t   *row;
+
+    if (prefix == NULL)
+      prefix = "armci_comm_matrix";
+
+    snprintf(path, sizeof(path), "%s.mat", prefix);
+    mat = fopen(path, "w");
+    if (mat == NULL)
+      ARMCII_Warning("Unable to open communication matrix file (%s)\n", path);
+
+    snprintf(path, sizeof(path), "%s.csv", prefix);
+    csv = fopen(path, "w");
+    if (csv == NULL)
+      ARMCII_Warning("Unable to open communication matrix file (%s)\n", path);
+    else
+      fprintf(csv, "origin,target,op,count,bytes\n");
+
+    row = malloc(sizeof(uint64_t) * nproc);
+    ARMCII_Assert(row != NULL);
+
+    for (i = 0; i < nproc; i++) {
+      const uint64_t *e = &all[displs[i]];
+
+      memset(row, 0, sizeof(uint64_t) * nproc);
+
+      for (j = 0; j < counts[i]; j += COMM_ENTRY_LEN) {
+        row[e[j]] += e[j+3];
+
+        if (csv != NULL)
+          fprintf(csv, "%d,%d,%s,%llu,%llu\n", i, (int) e[j], comm_op_names[e[j+1]],
+                  (unsigned long long) e[j+2], (unsigned long long) e[j+3]);
+      }
+
+      if (mat != NULL) {
+        for (t = 0; t < nproc; t++)
+          fprintf(mat, "%s%llu", t > 0 ? " " : "", (unsigned long long) row[t]);
+        fprintf(mat, "\n");
+      }
+    }
+
+    if (mat != NULL) fclose(mat);
+    if (csv != NULL) fclose(csv);
+
+    free(row);
+    free(all);
+    free(counts);
+  }
+
+  free(entries);
+  free(ARMCII_Comm_matrix);
+  ARMCII_Comm_matrix = NULL;
+}
@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <armci.h>
+#include <armcix.h>
+#include <armci_internals.h>
+#include <debug.h>
+#include <gmr.h>
+
+#define MIN(A,B) (((A) < (B)) ? (A) : (B))
+#define MAX(A,B) (((A) > (B)) ? (A) : (B))
+
+/* Chunks are sized so that the remaining work is spread over roughly
+ * COUNTER_CHUNK_FACTOR leases per process (guided self-scheduling). */
+#define COUNTER_CHUNK_FACTOR   4
+#define COUNTER_MAX_CHUNK      1024
+#define COUNTER_MAX_BLOCK      (1 << 20)
+#define COUNTER_DEFAULT_BLOCK  64
+
+/* In hierarchical mode, the node pool word packs the index of the global
+ * block currently being handed out on the node and the offset of the next
+ * free index in that block.  Claims that overshoot the block are bounded by
+ * COUNTER_MAX_CHUNK per process, so the offset cannot overflow into the block
+ * index. */
+#define POOL_WORD(blk, off)    (((int64_t)(blk) << 32) | (int64_t)(off))
+#define POOL_BLOCK(w)          ((w) >> 32)
+#define POOL_OFFSET(w)         ((w) & 0xffffffffLL)
+
+/* Layout of each process' slice of the counter allocation */
+enum { COUNTER_GLOBAL = 0, COUNTER_POOL = 1, COUNTER_NWORDS = 2 };
+
+struct armcix_counter_s {
+  ARMCI_Group  grp;          /* Group the counter was created on                      */
+  gmr_t       *mreg;         /* Allocation holding the global counter and node pools  */
+  int64_t    **bases;        /* Base pointers of each process' slice (group order)    */
+  int          flags;        /* ARMCIX_COUNTER_* creation flags                       */
+  long         limit;        /* Expected end of the index space, <= 0 if unknown      */
+  int          root;         /* Absolute id of the process holding the global counter */
+  int          leader;       /* Absolute id of my node leader                         */
+  int          leader_grp;   /* Group rank of my node leader                          */
+  int          nnodes;       /* Number of nodes spanned by the group                  */
+  int          node;         /* Index of my node                                      */
+  long         block;        /* Size of the global blocks leased by nodes             */
+
+  /* Local lease */
+  long         next;         /* Next index to hand out                                */
+  long         end;          /* End of the current lease                              */
+  long         seen;         /* Highest index known to be taken from the counter      */
+};
+
+
+/** Pick the size of the next lease from the estimated remaining work.
+  */
+static long counter_chunk(armcix_counter_t cnt, long max_chunk) {
+  long remaining, chunk;
+
+  if (cnt->limit <= 0)
+    return 1;
+
+  remaining = cnt->limit - cnt->seen;
+  chunk     = remaining / (COUNTER_CHUNK_FACTOR * cnt->grp.size);
+
+  return MAX(1, MIN(chunk, max_chunk));
+}
+
+
+/** Atomically add to a word of the counter allocation and return its old
+  * value.
+  */
+static int64_t counter_fadd(armcix_counter_t cnt, int grp_proc, int word, int64_t value, int proc) {
+  int64_t out;
+
+  gmr_fetch_and_op(cnt->mreg, &value, &out, &cnt->bases[grp_proc][word], MPI_INT64_T, MPI_SUM, proc);
+  gmr_flush(cnt->mreg, proc, 0);
+
+  return out;
+}
+
+
+/** Lease a chunk directly from the global counter.
+  */
+static void counter_lease_flat(armcix_counter_t cnt) {
+  const long chunk = counter_chunk(cnt, COUNTER_MAX_CHUNK);
+  const long first = counter_fadd(cnt, 0, COUNTER_GLOBAL, chunk, cnt->root);
+
+  cnt->next = first;
+  cnt->end  = first + chunk;
+  cnt->seen = MAX(cnt->seen, cnt->end);
+}
+
+
+/** Lease a chunk from the node pool.  Chunks are claimed by adding to the
+  * pool offset; the process whose claim reaches the end of the block leases
+  * the next global block and installs it, while claims that start past the
+  * end wait for the new block.  Pool positions only move forward, so every
+  * process receives its indices in increasing order.
+  */
+static void counter_lease_hier(armcix_counter_t cnt) {
+  int64_t *pool = &cnt->bases[cnt->leader_grp][COUNTER_POOL];
+  int64_t  w, nop = 0;
+
+  for (;;) {
+    int64_t blk, off;
+    long    chunk;
+
+    gmr_fetch_and_op(cnt->mreg, &nop, &w, pool, MPI_INT64_T, MPI_NO_OP, cnt->leader);
+    gmr_flush(cnt->mreg, cnt->leader, 0);
+
+    /* Pool is exhausted and being refilled by another process, which needs
+       only a single lease from the global counter */
+    if (POOL_OFFSET(w) >= cnt->block) {
+      ARMCII_Backoff(1);
+      continue;
+    }
+
+    cnt->seen = MAX(cnt->seen, POOL_BLOCK(w)*cnt->block + POOL_OFFSET(w));
+    chunk     = counter_chunk(cnt, COUNTER_MAX_CHUNK);
+    w         = counter_fadd(cnt, cnt->leader_grp, COUNTER_POOL, chunk, cnt->leader);
+    blk       = POOL_BLOCK(w);
+    off       = POOL_OFFSET(w);
+
+    /* Lost the race to the end of the block */
+    if (off >= cnt->block)
+      continue;
+
+    cnt->next = blk*cnt->block + off;
+    cnt->end  = blk*cnt->block + MIN(off + chunk, cnt->block);
+    cnt->seen = MAX(cnt->seen, cnt->end);
+
+    /* My claim exhausted the pool: refill it */
+    if (off + chunk >= cnt->block) {
+      const int64_t new_blk = counter_fadd(cnt, 0, COUNTER_GLOBAL, 1, cnt->root);
+      int64_t       old_w;
+
+      w = POOL_WORD(new_blk, 0);
+      gmr_fetch_and_op(cnt->mreg, &w, &old_w, pool, MPI_INT64_T, MPI_REPLACE, cnt->leader);
+      gmr_flush(cnt->mreg, cnt->leader, 0);
+    }
+
+    return;
+  }
+}
+
+
+/** Reset my slice of the counter allocation.  Must be followed by a barrier.
+  */
+static void counter_reset_local(armcix_counter_t cnt) {
+  int64_t *mine = cnt->bases[cnt->grp.rank];
+
+  /* Node pools start out holding the first nnodes global blocks */
+  mine[COUNTER_GLOBAL] = (cnt->flags & ARMCIX_COUNTER_HIERARCHICAL) ? cnt->nnodes : 0;
+  mine[COUNTER_POOL]   = POOL_WORD(cnt->node, 0);
+  gmr_sync(cnt->mreg);
+
+  cnt->next = 0;
+  cnt->end  = 0;
+  cnt->seen = 0;
+}
+
+
+/** Create a shared counter (NXTVAL service).  Collective on the group.
+  *
+  * Processes lease chunks of indices and hand them out locally.  When the
+  * expected number of indices is known, the chunk size shrinks as the counter
+  * approaches the end.  With ARMCIX_COUNTER_HIERARCHICAL, processes lease from
+  * a pool on their node leader, which is refilled from the global counter one
+  * block at a time.
+  *
+  * @param[in] group Group on which to create the counter (NULL for world)
+  * @param[in] limit Expected total number of indices, or <= 0 if unknown
+  * @param[in] flags Bitwise or of ARMCIX_COUNTER_* flags
+  * @return          Counter handle
+  */
+armcix_counter_t ARMCIX_Counter_create(ARMCI_Group *group, long limit, int flags) {
+  armcix_counter_t cnt;
+  MPI_Comm         node_comm;
+  int              node_rank, is_leader;
+
+  if (group == NULL)
+    group = &ARMCI_GROUP_WORLD;
+
+  cnt = malloc(sizeof(struct armcix_counter_s));
+  ARMCII_Assert(cnt != NULL);
+
+  ARMCIX_Group_dup(group, &cnt->grp);
+  cnt->flags = flags;
+  cnt->limit = limit;
+  cnt->root  = ARMCI_Absolute_id(group, 0);
+
+  /* Find my node leader and the number of nodes */
+  MPI_Comm_split_type(group->comm, MPI_COMM_TYPE_SHARED, group->rank, MPI_INFO_NULL, &node_comm);
+  MPI_Comm_rank(node_comm, &node_rank);
+
+  cnt->leader_grp = group->rank;
+  MPI_Bcast(&cnt->leader_grp, 1, MPI_INT, 0, node_comm);
+  cnt->leader = ARMCI_Absolute_id(group, cnt->leader_grp);
+
+  is_leader = (node_rank == 0);
+  MPI_Allreduce(&is_leader, &cnt->nnodes, 1, MPI_INT, MPI_SUM, group->comm);
+
+  cnt->node = 0;
+  MPI_Exscan(&is_leader, &cnt->node, 1, MPI_INT, MPI_SUM, group->comm);
+  if (group->rank == 0) cnt->node = 0; /* Exscan result is undefined on rank 0 */
+  MPI_Bcast(&cnt->node, 1, MPI_INT, 0, node_comm);
+  MPI_Comm_free(&node_comm);
+
+  if (limit > 0)
+    cnt->block = MAX(1, MIN(limit / (COUNTER_CHUNK_FACTOR * cnt->nnodes), COUNTER_MAX_BLOCK));
+  else
+    cnt->block = COUNTER_DEFAULT_BLOCK;
+
+  cnt->bases = malloc(group->size*sizeof(int64_t*));
+  ARMCII_Assert(cnt->bases != NULL);
+
+  cnt->mreg = gmr_create(COUNTER_NWORDS*sizeof(int64_t), (void**) cnt->bases, &cnt->grp);
+  ARMCII_Assert(cnt->mreg != NULL);
+
+  counter_reset_local(cnt);
+  MPI_Barrier(group->comm);
+
+  ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "counter created: limit %ld, flags %d, %d nodes, block %ld\n",
+                   limit, flags, cnt->nnodes, cnt->block);
+
+  return cnt;
+}
+
+
+/** Destroy a shared counter.  Collective on the group it was created on.
+  *
+  * @param[in] cnt Counter handle
+  */
+void ARMCIX_Counter_destroy(armcix_counter_t cnt) {
+  gmr_destroy(cnt->mreg, &cnt->grp);
+  ARMCI_Group_free(&cnt->grp);
+  free(cnt->bases);
+  free(cnt);
+}
+
+
+/** Reset a shared counter to zero.  Collective on the group it was created
+  * on.
+  *
+  * @param[in] cnt Counter handle
+  */
+void ARMCIX_Counter_reset(armcix_counter_t cnt) {
+  MPI_Barrier(cnt->grp.comm);
+  counter_reset_local(cnt);
+  MPI_Barrier(cnt->grp.comm);
+}
+
+
+/** Fetch the next index from a shared counter.  Indices are unique across the
+  * group.  Each process receives its own indices in increasing order, so a
+  * process that sees an index past the end of the work can stop: every lower
+  * index has been handed to a process that has not yet passed it.
+  *
+  * @param[in] cnt Counter handle
+  * @return        Next index
+  */
+long ARMCIX_Counter_next(armcix_counter_t cnt) {
+  if (cnt->next >= cnt->end) {
+    if (cnt->flags & ARMCIX_COUNTER_HIERARCHICAL)
+      counter_lease_hier(cnt);
+    else
+      counter_lease_flat(cnt);
+  }
+
+  return cnt->next++;
+}
@@ -72,6 +72,8 @@ int gmr_get_accumulate_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype
 
   MPI_Get_accumulate(src, src_count, src_type, out, out_count, out_type, grp_proc, (MPI_Aint) disp, dst_count, dst_type, op, mreg->window);
 
+  gmr_stats_record(mreg, ARMCIX_ALLOC_ACC, proc, gmr_type_bytes(dst_count, dst_type));
+
   return 0;
 }
 
@@ -105,6 +107,41 @@ int gmr_fetch_and_op(gmr_t *mreg, void *src, void *out, void *dst,
 
   MPI_Fetch_and_op(src, out, type, grp_proc, (MPI_Aint) disp, op, mreg->window);
 
+  gmr_stats_record(mreg, ARMCIX_ALLOC_ACC, proc, gmr_type_bytes(1, type));
+
+  return 0;
+}
+
+/** One-sided compare-and-swap.  Source, compare and output buffers must be
+  * private.
+  *
+  * @param[in] mreg      Memory region
+  * @param[in] src       Address of the value to be swapped in
+  * @param[in] cmp       Address of the value to compare with
+  * @param[in] out       Address of output buffer (same process as the source)
+  * @param[in] dst       Address of destination buffer
+  * @param[in] type      MPI datatype of the elements (integer types only)
+  * @param[in] proc      Absolute process id of target process
+  * @return              0 on success, non-zero on failure
+  */
+int gmr_compare_and_swap(gmr_t *mreg, void *src, void *cmp, void *out, void *dst,
+    MPI_Datatype type, int proc) {
+
+  int        grp_proc;
+  gmr_size_t disp;
+
+  grp_proc = ARMCII_Translate_absolute_to_group(&mreg->group, proc);
+  ARMCII_Assert(grp_proc >= 0);
+  ARMCII_Assert_msg(mreg->window != MPI_WIN_NULL, "A non-null mreg contains a null window.");
+
+  disp = (gmr_size_t) ((uint8_t*)dst - (uint8_t*)mreg->slices[proc].base);
+
+  ARMCII_Assert_msg(disp >= 0 && disp < mreg->slices[proc].size, "Invalid remote address");
+
+  MPI_Compare_and_swap(src, cmp, out, type, grp_proc, (MPI_Aint) disp, mreg->window);
+
+  gmr_stats_record(mreg, ARMCIX_ALLOC_ACC, proc, gmr_type_bytes(1, type));
+
   return 0;
 }
 
@@ -150,7 +187,7 @@ int gmr_unlockall(gmr_t *mreg) {
   */
 int gmr_flush(gmr_t *mreg, int proc, int local_only) {
   ARMCI_FUNC_PROFILE_TIMING_START(gmr_flush_trans);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(gmr_flush_trans, proc);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(gmr_flush_trans, proc, 0);
 
   int grp_proc = ARMCII_Translate_absolute_to_group(&mreg->group, proc);
   int grp_me   = ARMCII_Translate_absolute_to_group(&mreg->group, ARMCI_GROUP_WORLD.rank);
@@ -161,7 +198,8 @@ int gmr_flush(gmr_t *mreg, int proc, int local_only) {
 
   ARMCI_FUNC_PROFILE_TIMING_END(gmr_flush_trans);
   ARMCI_FUNC_PROFILE_TIMING_START(gmr_flush);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(gmr_flush, proc);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(gmr_flush, proc, 0);
+  ARMCI_FUNC_PROFILE_WINDOW(gmr_flush, mreg->window);
 
   if (!local_only || ARMCII_GLOBAL_STATE.end_to_end_flush) {
     MPI_Win_flush(grp_proc, mreg->window);
@@ -169,6 +207,8 @@ int gmr_flush(gmr_t *mreg, int proc, int local_only) {
     MPI_Win_flush_local(grp_proc, mreg->window);
   }
 
+  mreg->stats.flushes++;
+
   ARMCI_FUNC_PROFILE_TIMING_END(gmr_flush);
 
   return 0;
@@ -181,7 +221,6 @@ int gmr_flush(gmr_t *mreg, int proc, int local_only) {
   */
 int gmr_flushall(gmr_t *mreg, int local_only) {
   ARMCI_FUNC_PROFILE_TIMING_START(gmr_flushall_trans);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(gmr_flushall_trans, 0);
 
   int grp_me   = ARMCII_Translate_absolute_to_group(&mreg->group, ARMCI_GROUP_WORLD.rank);
 
@@ -190,7 +229,7 @@ int gmr_flushall(gmr_t *mreg, int local_only) {
 
   ARMCI_FUNC_PROFILE_TIMING_END(gmr_flushall_trans);
   ARMCI_FUNC_PROFILE_TIMING_START(gmr_flushall);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(gmr_flushall, 0);
+  ARMCI_FUNC_PROFILE_WINDOW(gmr_flushall, mreg->window);
 
   if (!local_only || ARMCII_GLOBAL_STATE.end_to_end_flush) {
     MPI_Win_flush_all(mreg->window);
@@ -198,6 +237,8 @@ int gmr_flushall(gmr_t *mreg, int local_only) {
     MPI_Win_flush_local_all(mreg->window);
   }
 
+  mreg->stats.flushes++;
+
   ARMCI_FUNC_PROFILE_TIMING_END(gmr_flushall);
 
   return 0;
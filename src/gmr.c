@@ -39,7 +39,8 @@ void armci_reset_async(){/*do nothing*/}
 void armci_auto_async(){/*do nothing*/}
 #endif
 
-#ifdef USE_CSP_RMA_DBG
+/* Name given to the GMRs created until it is reset, used by the allocation
+ * statistics and passed to Casper as the window name */
 static char armci_dbg_gmr_name[MPI_MAX_OBJECT_NAME + 1];
 static int armci_dbg_gmr_name_set = 0;
 void armci_dbg_set_gmr_name(const char *name)
@@ -49,14 +50,12 @@ void armci_dbg_set_gmr_name(const char *name)
     armci_dbg_gmr_name_set = 1;
 }
 
-void armci_dbg_reset_gmr_name()
+void armci_dbg_reset_gmr_name(void)
 {
     armci_dbg_gmr_name_set = 0;
 }
-#else
-void armci_dbg_set_gmr_name(const char *name){/*do nothing*/}
-void armci_dbg_reset_gmr_name(){/*do nothing*/}
-#endif
+
+static int gmr_seq = 0;
 
 /** Create a distributed shared memory region. Collective on ARMCI group.
   *
@@ -78,7 +77,7 @@ gmr_t *gmr_create(gmr_size_t local_size, void **base_ptrs, ARMCI_Group *group) {
   ARMCII_Assert(group != NULL);
 
   ARMCI_FUNC_PROFILE_TIMING_START(gmr_create);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(gmr_create, 0);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(gmr_create, -1, local_size);
 
   MPI_Comm_rank(group->comm, &alloc_me);
   MPI_Comm_size(group->comm, &alloc_nproc);
@@ -103,6 +102,25 @@ gmr_t *gmr_create(gmr_size_t local_size, void **base_ptrs, ARMCI_Group *group) {
   mreg->prev           = NULL;
   mreg->next           = NULL;
 
+  /* Identify the allocation by its creation on the group leader, which is
+     the same on every member.  This is only needed to match allocations in
+     the finalize report, so skip the broadcast when it is disabled. */
+  mreg->leader = -1;
+  mreg->seq    = -1;
+
+  if (ARMCII_GLOBAL_STATE.alloc_stats_top > 0) {
+    int id[2] = { world_me, gmr_seq++ };
+
+    MPI_Bcast(id, 2, MPI_INT, 0, group->comm);
+    mreg->leader = id[0];
+    mreg->seq    = id[1];
+  }
+
+  mreg->name[0] = '\0';
+  if (armci_dbg_gmr_name_set)
+    snprintf(mreg->name, sizeof(mreg->name), "%s", armci_dbg_gmr_name);
+  memset(&mreg->stats, 0, sizeof(mreg->stats));
+
   /* Allocate my slice of the GMR */
   alloc_slices[alloc_me].size = local_size;
 
@@ -196,6 +214,7 @@ gmr_t *gmr_create(gmr_size_t local_size, void **base_ptrs, ARMCI_Group *group) {
     for (i = 0; i < alloc_nproc; i++)
       base_ptrs[i] = NULL;
 
+    ARMCI_FUNC_PROFILE_TIMING_END(gmr_create);
     return NULL;
   }
 
@@ -280,7 +299,6 @@ void gmr_destroy(gmr_t *mreg, ARMCI_Group *group) {
   int   world_me, world_nproc;
 
   ARMCI_FUNC_PROFILE_TIMING_START(gmr_destroy);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(gmr_destroy, 0);
 
   MPI_Comm_rank(group->comm, &alloc_me);
   MPI_Comm_size(group->comm, &alloc_nproc);
@@ -304,8 +322,10 @@ void gmr_destroy(gmr_t *mreg, ARMCI_Group *group) {
   MPI_Allreduce(&search_proc_in, &search_proc_out, 1, MPI_INT, MPI_MAX, group->comm);
 
   /* Everyone passed NULL.  Nothing to free. */
-  if (search_proc_out < 0)
+  if (search_proc_out < 0) {
+    ARMCI_FUNC_PROFILE_TIMING_END(gmr_destroy);
     return;
+  }
 
   /* Translate world rank to group rank */
   search_proc_out_grp = ARMCII_Translate_absolute_to_group(group, search_proc_out);
@@ -346,6 +366,8 @@ void gmr_destroy(gmr_t *mreg, ARMCI_Group *group) {
     }
   }
 
+  ARMCII_Alloc_stats_retire(mreg);
+
   free(mreg->slices);
   free(mreg);
 
@@ -467,6 +489,8 @@ int gmr_put_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype src_type,
               (MPI_Aint) disp, dst_count, dst_type, mreg->window);
   }
 
+  gmr_stats_record(mreg, ARMCIX_ALLOC_PUT, proc, gmr_type_bytes(src_count, src_type));
+
   return 0;
 }
 
@@ -541,6 +565,8 @@ int gmr_get_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype src_type,
               (MPI_Aint) disp, src_count, src_type, mreg->window);
   }
 
+  gmr_stats_record(mreg, ARMCIX_ALLOC_GET, proc, gmr_type_bytes(src_count, src_type));
+
   return 0;
 }
 
@@ -609,6 +635,8 @@ int gmr_accumulate_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype src
       // MPI_Info_free(&async_info);
   MPI_Accumulate(src, src_count, src_type, grp_proc, (MPI_Aint) disp, dst_count, dst_type, MPI_SUM, mreg->window);
 
+  gmr_stats_record(mreg, ARMCIX_ALLOC_ACC, proc, gmr_type_bytes(src_count, src_type));
+
   return 0;
 }
 
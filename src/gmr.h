@@ -9,6 +9,7 @@
 
 #include <armci.h>
 #include <armcix.h>
+#include <armci_internals.h>
 
 typedef armci_size_t gmr_size_t;
 
@@ -25,6 +26,10 @@ typedef struct gmr_s {
   struct gmr_s           *next;
   gmr_slice_t            *slices;         /* Array of GMR slices for this allocation                        */
   int                     nslices;
+  int                     leader;         /* World rank of the group leader that numbered this GMR, or -1   */
+  int                     seq;            /* Creation order of this GMR on its group leader, or -1          */
+  char                    name[MPI_MAX_OBJECT_NAME+1]; /* Debug name, empty if none was set                 */
+  armcix_alloc_stats_t    stats;          /* Traffic issued by this process on the GMR                      */
 } gmr_t;
 
 extern gmr_t *gmr_list;
@@ -40,6 +45,7 @@ int gmr_accumulate(gmr_t *mreg, void *src, void *dst, int count, MPI_Datatype ty
 int gmr_get_accumulate(gmr_t *mreg, void *src, void *out, void *dst, int count, MPI_Datatype type,
     MPI_Op op, int proc);
 int gmr_fetch_and_op(gmr_t *mreg, void *src, void *out, void *dst, MPI_Datatype type, MPI_Op op, int proc);
+int gmr_compare_and_swap(gmr_t *mreg, void *src, void *cmp, void *out, void *dst, MPI_Datatype type, int proc);
 
 int gmr_get_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype src_type,
     void *dst, int dst_count, MPI_Datatype dst_type, int proc);
@@ -59,4 +65,35 @@ int gmr_sync(gmr_t *mreg);
 
 void gmr_progress(void);
 
+void ARMCII_Alloc_stats_retire(gmr_t *mreg);
+void ARMCII_Alloc_stats_report(void);
+
+/** Number of bytes in count elements of an MPI datatype.  Contiguous
+  * transfers use MPI_BYTE and need no query; other types cost one call to
+  * MPI_Type_size per operation.
+  */
+static inline long gmr_type_bytes(int count, MPI_Datatype type) {
+  int size;
+
+  if (type == MPI_BYTE)
+    return count;
+
+  MPI_Type_size(type, &size);
+  return (long) count * size;
+}
+
+/** Count an operation issued by this process on a memory region.
+  *
+  * @param[in] mreg   Memory region
+  * @param[in] op     Operation type (see armcix_alloc_op_e)
+  * @param[in] proc   Absolute process id of the target
+  * @param[in] bytes  Number of bytes transferred
+  */
+static inline void gmr_stats_record(gmr_t *mreg, int op, int proc, long bytes) {
+  const int where = (proc == ARMCI_GROUP_WORLD.rank) ? ARMCIX_ALLOC_LOCAL : ARMCIX_ALLOC_REMOTE;
+
+  mreg->stats.ops[op][where]++;
+  mreg->stats.bytes[op][where] += bytes;
+}
+
 #endif /* HAVE_GMR_H */
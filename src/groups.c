@@ -18,6 +18,192 @@ ARMCI_Group ARMCI_GROUP_WORLD   = {0};
 ARMCI_Group ARMCI_GROUP_DEFAULT = {0};
 
 
+/** Cache of groups created by ARMCI_Group_create_child, keyed by the parent's
+  * identity (see armcii_rank_map_t) and the absolute ranks of the members.
+  * Unlike communicator handles, identities are the same on all members and
+  * are never reused.  Entries are reference
+  * counted.  An entry whose last reference is released is kept for reuse only
+  * if every member has room for it among group_cache_size unreferenced
+  * entries, and is otherwise freed right away.  Entries are thus only created,
+  * reused, and freed in calls that are collective on their members, so all
+  * members always agree on the contents of the cache for their group.
+  */
+typedef struct group_cache_entry_s {
+  struct group_cache_entry_s *next;
+  int            parent[2];   /* Identity of the parent group                       */
+  unsigned       hash;        /* Hash of the member list                            */
+  int            size;        /* Number of members                                  */
+  int           *members;     /* Absolute ranks of the members, in group order      */
+  int            refcount;    /* Number of live ARMCI_Group_create_child results    */
+  ARMCI_Group    group;       /* The cached group                                   */
+} group_cache_entry_t;
+
+static group_cache_entry_t *group_cache         = NULL;
+static int                  group_cache_nunused = 0;  /* Unreferenced entries */
+
+/* Number of groups created by this process as group rank 0 */
+static int                  group_seq           = 0;
+
+
+/** Compare (absolute rank, group rank) pairs by absolute rank.
+  */
+static int rank_map_compare(const void *a, const void *b) {
+  const int x = *(const int*)a;
+  const int y = *(const int*)b;
+
+  return (x > y) - (x < y);
+}
+
+
+/** Build the rank translation map for a group.  Strided groups cost constant
+  * space and irregular groups cost space proportional to the group size.  The
+  * identity of the group is chosen by group rank 0.  Collective on the group.
+  *
+  * @param[in] group Group, with its size set
+  * @return          Translation map, or NULL if the process is not a member
+  */
+static armcii_rank_map_t *ARMCII_Rank_map_create(ARMCI_Group *group) {
+  armcii_rank_map_t *map;
+  int               *grp_to_abs, *ranks, i, stride, increasing;
+  MPI_Group          world_group, sub_group;
+
+  if (group->comm == MPI_COMM_NULL)
+    return NULL;
+
+  grp_to_abs = malloc(sizeof(int)*group->size);
+  ranks      = malloc(sizeof(int)*group->size);
+  ARMCII_Assert(grp_to_abs != NULL && ranks != NULL);
+
+  for (i = 0; i < group->size; i++)
+    ranks[i] = i;
+
+  MPI_Comm_group(ARMCI_GROUP_WORLD.comm, &world_group);
+  MPI_Comm_group(group->comm, &sub_group);
+
+  MPI_Group_translate_ranks(sub_group, group->size, ranks, world_group, grp_to_abs);
+
+  MPI_Group_free(&world_group);
+  MPI_Group_free(&sub_group);
+
+  /* Check whether the members are evenly spaced */
+  stride     = group->size > 1 ? grp_to_abs[1] - grp_to_abs[0] : 1;
+  increasing = 1;
+
+  for (i = 1; i < group->size; i++) {
+    if (grp_to_abs[i] - grp_to_abs[i-1] != stride)
+      stride = 0;
+    if (grp_to_abs[i] < grp_to_abs[i-1])
+      increasing = 0;
+  }
+
+  map = malloc(sizeof(armcii_rank_map_t));
+  ARMCII_Assert(map != NULL);
+
+  map->first      = grp_to_abs[0];
+  map->stride     = stride;
+  map->size       = group->size;
+  map->grp_to_abs = NULL;
+  map->by_abs     = NULL;
+  map->id[0]      = grp_to_abs[0];
+  map->id[1]      = group_seq++;
+
+  MPI_Bcast(map->id, 2, MPI_INT, 0, group->comm);
+
+  if (stride != 0) {
+    free(grp_to_abs);
+    free(ranks);
+  }
+  else {
+    map->grp_to_abs = grp_to_abs;
+
+    if (increasing) {
+      free(ranks);
+    } else {
+      int *pairs = malloc(2*sizeof(int)*group->size);
+      ARMCII_Assert(pairs != NULL);
+
+      for (i = 0; i < group->size; i++) {
+        pairs[2*i]   = grp_to_abs[i];
+        pairs[2*i+1] = i;
+      }
+
+      qsort(pairs, group->size, 2*sizeof(int), rank_map_compare);
+
+      for (i = 0; i < group->size; i++)
+        ranks[i] = pairs[2*i+1];
+
+      free(pairs);
+      map->by_abs = ranks;
+    }
+  }
+
+  return map;
+}
+
+
+/** Free a rank translation map.
+  */
+static void ARMCII_Rank_map_free(armcii_rank_map_t *map) {
+  if (map == NULL)
+    return;
+
+  free(map->grp_to_abs);
+  free(map->by_abs);
+  free(map);
+}
+
+
+/** Translate an absolute rank to a group rank using a translation map.
+  * Constant time for strided maps, logarithmic in the group size otherwise.
+  *
+  * @param[in] map        Translation map of the group
+  * @param[in] world_rank Absolute rank
+  * @return               Group rank, or -1 if the process is not a member
+  */
+int ARMCII_Rank_map_to_group(armcii_rank_map_t *map, int world_rank) {
+  int lo, hi;
+
+  if (map->stride != 0) {
+    const int dist = world_rank - map->first;
+
+    if (dist % map->stride != 0 || dist / map->stride < 0 || dist / map->stride >= map->size)
+      return -1;
+
+    return dist / map->stride;
+  }
+
+  /* Binary search the members in order of absolute rank */
+  for (lo = 0, hi = map->size - 1; lo <= hi; ) {
+    const int mid  = lo + (hi - lo) / 2;
+    const int grp  = map->by_abs ? map->by_abs[mid] : mid;
+    const int abs  = map->grp_to_abs[grp];
+
+    if (abs == world_rank)
+      return grp;
+    else if (abs < world_rank)
+      lo = mid + 1;
+    else
+      hi = mid - 1;
+  }
+
+  return -1;
+}
+
+
+/** Translate a group rank to an absolute rank using a translation map.
+  *
+  * @param[in] map        Translation map of the group
+  * @param[in] group_rank Group rank, must be valid
+  * @return               Absolute rank
+  */
+int ARMCII_Rank_map_to_absolute(armcii_rank_map_t *map, int group_rank) {
+  if (map->stride != 0)
+    return map->first + group_rank*map->stride;
+  else
+    return map->grp_to_abs[group_rank];
+}
+
+
 /** Initialize an ARMCI group's remaining fields using the communicator field.
   */
 void ARMCII_Group_init_from_comm(ARMCI_Group *group) {
@@ -30,49 +216,101 @@ void ARMCII_Group_init_from_comm(ARMCI_Group *group) {
     group->size =  0;
   }
 
-  /* If noncollective groups are in use, create a separate communicator that
-    can be used for noncollective group creation with this group as the parent.
-    This ensures that calls to MPI_Intercomm_create can't clash with any user
-    communication. */
+  /* If intercommunicator-based noncollective groups are in use, create a
+    separate communicator that can be used for noncollective group creation
+    with this group as the parent.  This ensures that calls to
+    MPI_Intercomm_create can't clash with any user communication.
+    MPI_Comm_create_group tags can't clash with user communication, so that
+    method doesn't need it. */
 
-  if (ARMCII_GLOBAL_STATE.noncollective_groups && group->comm != MPI_COMM_NULL)
+  if (ARMCII_GLOBAL_STATE.noncollective_groups && ARMCII_GLOBAL_STATE.noncoll_method == ARMCII_NONCOLL_INTERCOMM
+      && group->comm != MPI_COMM_NULL)
     MPI_Comm_dup(group->comm, &group->noncoll_pgroup_comm);
   else
     group->noncoll_pgroup_comm = MPI_COMM_NULL;
 
-  /* Check if translation caching is enabled */
-  if (ARMCII_GLOBAL_STATE.cache_rank_translation) {
-    if (group->comm != MPI_COMM_NULL) {
-      int      *ranks, i;
-      MPI_Group world_group, sub_group;
+  group->rank_map = ARMCII_Rank_map_create(group);
+}
+
 
-      group->abs_to_grp = malloc(sizeof(int)*ARMCI_GROUP_WORLD.size);
-      group->grp_to_abs = malloc(sizeof(int)*group->size);
-      ranks = malloc(sizeof(int)*ARMCI_GROUP_WORLD.size);
+/** Release the communicators and translation map of a group.
+  */
+static void ARMCII_Group_destroy(ARMCI_Group *group) {
+  if (group->comm != MPI_COMM_NULL) {
+    MPI_Comm_free(&group->comm);
 
-      ARMCII_Assert(group->abs_to_grp != NULL && group->grp_to_abs != NULL && ranks != NULL);
+    if (group->noncoll_pgroup_comm != MPI_COMM_NULL)
+      MPI_Comm_free(&group->noncoll_pgroup_comm);
+  }
 
-      for (i = 0; i < ARMCI_GROUP_WORLD.size; i++)
-        ranks[i] = i;
+  /* If the group has a translation map, free it */
+  ARMCII_Rank_map_free(group->rank_map);
+  group->rank_map = NULL;
 
-      MPI_Comm_group(ARMCI_GROUP_WORLD.comm, &world_group);
-      MPI_Comm_group(group->comm, &sub_group);
+  group->rank = -1;
+  group->size = 0;
+}
 
-      MPI_Group_translate_ranks(sub_group, group->size, ranks, world_group, group->grp_to_abs);
-      MPI_Group_translate_ranks(world_group, ARMCI_GROUP_WORLD.size, ranks, sub_group, group->abs_to_grp);
 
-      MPI_Group_free(&world_group);
-      MPI_Group_free(&sub_group);
+/** FNV-1a hash of a group's member list.
+  */
+static unsigned group_cache_hash(int size, const int *members) {
+  unsigned hash = 2166136261u;
+  int      i;
 
-      free(ranks);
-    }
+  for (i = 0; i < size; i++) {
+    hash ^= (unsigned) members[i];
+    hash *= 16777619u;
   }
-  
-  /* Translation caching is disabled */
-  else {
-    group->abs_to_grp = NULL;
-    group->grp_to_abs = NULL;
+
+  return hash;
+}
+
+
+/** Find a cached group with the given parent and members.
+  */
+static group_cache_entry_t *group_cache_lookup(const int *parent, unsigned hash, int size, const int *members) {
+  group_cache_entry_t *entry;
+  int                  i;
+
+  for (entry = group_cache; entry != NULL; entry = entry->next) {
+    if (entry->parent[0] != parent[0] || entry->parent[1] != parent[1] || entry->hash != hash
+        || entry->size != size)
+      continue;
+
+    for (i = 0; i < size && entry->members[i] == members[i]; i++)
+      ;
+
+    if (i == size)
+      return entry;
   }
+
+  return NULL;
+}
+
+
+/** Number of unreferenced groups the cache may keep.  Noncollective groups
+  * are only reused while referenced, so none are kept.
+  */
+static int group_cache_limit(void) {
+  return ARMCII_GLOBAL_STATE.noncollective_groups ? 0 : ARMCII_GLOBAL_STATE.group_cache_size;
+}
+
+
+/** Free all cached groups, including ones that are still referenced.  Called
+  * at finalize.
+  */
+void ARMCII_Group_cache_destroy_all(void) {
+  while (group_cache != NULL) {
+    group_cache_entry_t *entry = group_cache;
+
+    group_cache = entry->next;
+    ARMCII_Group_destroy(&entry->group);
+    free(entry->members);
+    free(entry);
+  }
+
+  group_cache_nunused = 0;
 }
 
 
@@ -177,6 +415,58 @@ static inline void ARMCI_Group_create_comm_noncollective(int grp_size, int *pid_
 }
 
 
+/** Create an ARMCI group that contains a subset of the nodes in the parent
+  * group using MPI_Comm_create_group. Collective across output group.
+  *
+  * @param[in]  grp_size         Number of entries in pid_list.
+  * @param[in]  pid_list         Sorted list of process ids that will be in the new group.
+  * @param[out] armci_grp_out    The new ARMCI group, only valid on group members.
+  * @param[in]  armci_grp_parent The parent of the new ARMCI group.
+  */
+static inline void ARMCI_Group_create_comm_create_group(int grp_size, int *pid_list, ARMCI_Group *armci_grp_out,
+    ARMCI_Group *armci_grp_parent) {
+
+#ifdef HAVE_MPI_COMM_CREATE_GROUP
+  const int CREATE_GROUP_TAG = 42;
+  int       i, grp_me, me;
+  MPI_Group mpi_grp_parent;
+  MPI_Group mpi_grp_child;
+
+  me = armci_grp_parent->rank;
+
+  /* CHECK: If I'm not a member, return COMM_NULL */
+  grp_me = -1;
+  for (i = 0; i < grp_size; i++) {
+    if (pid_list[i] == me) {
+      grp_me = i;
+      break;
+    }
+  }
+
+  if (grp_me < 0) {
+    armci_grp_out->comm = MPI_COMM_NULL;
+    return;
+  }
+
+  /* CASE: Group size 1 */
+  else if (grp_size == 1) {
+    MPI_Comm_dup(MPI_COMM_SELF, &armci_grp_out->comm);
+    return;
+  }
+
+  MPI_Comm_group(armci_grp_parent->comm, &mpi_grp_parent);
+  MPI_Group_incl(mpi_grp_parent, grp_size, pid_list, &mpi_grp_child);
+
+  MPI_Comm_create_group(armci_grp_parent->comm, mpi_grp_child, CREATE_GROUP_TAG, &armci_grp_out->comm);
+
+  MPI_Group_free(&mpi_grp_parent);
+  MPI_Group_free(&mpi_grp_child);
+#else
+  ARMCII_Error("MPI_Comm_create_group is not available");
+#endif
+}
+
+
 /** Create an ARMCI group that contains a subset of the nodes in the parent
   * group. Collective.
   *
@@ -188,35 +478,131 @@ static inline void ARMCI_Group_create_comm_noncollective(int grp_size, int *pid_
 void ARMCI_Group_create_child(int grp_size, int *pid_list, ARMCI_Group *armci_grp_out,
     ARMCI_Group *armci_grp_parent) {
 
-  if (ARMCII_GLOBAL_STATE.noncollective_groups)
+  int      *members = NULL, is_member = 0, i;
+  unsigned  hash    = 0;
+
+  /* Look for an earlier group with the same parent and members */
+  if (ARMCII_GLOBAL_STATE.group_cache) {
+    group_cache_entry_t *entry = NULL;
+
+    members = malloc(sizeof(int)*grp_size);
+    ARMCII_Assert(members != NULL);
+
+    for (i = 0; i < grp_size; i++) {
+      members[i] = ARMCI_Absolute_id(armci_grp_parent, pid_list[i]);
+      is_member |= (pid_list[i] == armci_grp_parent->rank);
+    }
+
+    hash = group_cache_hash(grp_size, members);
+
+    /* All members agree on the cache entry for their group */
+    if (is_member)
+      entry = group_cache_lookup(armci_grp_parent->rank_map->id, hash, grp_size, members);
+
+#ifndef HAVE_MPI_COMM_CREATE_GROUP
+    if (!ARMCII_GLOBAL_STATE.noncollective_groups) {
+      /* Non-members take part in MPI_Comm_create, so they must learn whether
+         the members reuse a cached group instead */
+      int hit = (!is_member || entry != NULL);
+
+      MPI_Allreduce(MPI_IN_PLACE, &hit, 1, MPI_INT, MPI_LAND, armci_grp_parent->comm);
+
+      if (hit && !is_member) {
+        free(members);
+        armci_grp_out->comm = MPI_COMM_NULL;
+        ARMCII_Group_init_from_comm(armci_grp_out);
+        return;
+      }
+    }
+#endif
+
+    if (entry != NULL) {
+      free(members);
+      if (entry->refcount++ == 0)
+        group_cache_nunused--;
+      *armci_grp_out = entry->group;
+      return;
+    }
+  }
+
+  if (ARMCII_GLOBAL_STATE.noncollective_groups && ARMCII_GLOBAL_STATE.noncoll_method == ARMCII_NONCOLL_CREATE_GROUP)
+    ARMCI_Group_create_comm_create_group(grp_size, pid_list, armci_grp_out, armci_grp_parent);
+  else if (ARMCII_GLOBAL_STATE.noncollective_groups)
     ARMCI_Group_create_comm_noncollective(grp_size, pid_list, armci_grp_out, armci_grp_parent);
+#ifdef HAVE_MPI_COMM_CREATE_GROUP
+  else if (ARMCII_GLOBAL_STATE.group_cache)
+    /* Only the members decide whether to reuse a cached group, so only they
+       may take part in creating a new one */
+    ARMCI_Group_create_comm_create_group(grp_size, pid_list, armci_grp_out, armci_grp_parent);
+#endif
   else
     ARMCI_Group_create_comm_collective(grp_size, pid_list, armci_grp_out, armci_grp_parent);
 
   ARMCII_Group_init_from_comm(armci_grp_out);
+
+  /* Add the new group to the cache */
+  if (members != NULL && armci_grp_out->comm != MPI_COMM_NULL) {
+    group_cache_entry_t *entry = malloc(sizeof(group_cache_entry_t));
+    ARMCII_Assert(entry != NULL);
+
+    entry->parent[0] = armci_grp_parent->rank_map->id[0];
+    entry->parent[1] = armci_grp_parent->rank_map->id[1];
+    entry->hash      = hash;
+    entry->size      = grp_size;
+    entry->members   = members;
+    entry->refcount  = 1;
+    entry->group     = *armci_grp_out;
+    entry->next      = group_cache;
+    group_cache      = entry;
+  }
+  else
+    free(members);
 }
 
 
-/** Free an ARMCI group.  Collective across group.
+/** Free an ARMCI group.  Collective across group.  Groups from the group
+  * cache are only released, and are freed once unreferenced unless the cache
+  * keeps them for reuse.
   *
   * @param[in] group The group to be freed
   */
 void ARMCI_Group_free(ARMCI_Group *group) {
-  if (group->comm != MPI_COMM_NULL) {
-    MPI_Comm_free(&group->comm);
-
-    if (ARMCII_GLOBAL_STATE.noncollective_groups)
-      MPI_Comm_free(&group->noncoll_pgroup_comm);
+  group_cache_entry_t *entry, **prev;
+
+  for (prev = &group_cache, entry = group_cache; entry != NULL && group->comm != MPI_COMM_NULL;
+       prev = &entry->next, entry = entry->next) {
+    if (entry->group.comm == group->comm) {
+      ARMCII_Assert(entry->refcount > 0);
+
+      group->comm                = MPI_COMM_NULL;
+      group->noncoll_pgroup_comm = MPI_COMM_NULL;
+      group->rank_map            = NULL;
+      group->rank                = -1;
+      group->size                = 0;
+
+      if (--entry->refcount == 0) {
+        const int limit = group_cache_limit();
+        int       keep  = (group_cache_nunused < limit);
+
+        /* Keep the group only if every member has room for it */
+        if (limit > 0)
+          MPI_Allreduce(MPI_IN_PLACE, &keep, 1, MPI_INT, MPI_LAND, entry->group.comm);
+
+        if (keep) {
+          group_cache_nunused++;
+        } else {
+          *prev = entry->next;
+          ARMCII_Group_destroy(&entry->group);
+          free(entry->members);
+          free(entry);
+        }
+      }
+
+      return;
+    }
   }
 
-  /* If the group has translation caches, free them */
-  if (group->abs_to_grp != NULL)
-    free(group->abs_to_grp);
-  if (group->grp_to_abs != NULL)
-    free(group->grp_to_abs);
-
-  group->rank = -1;
-  group->size = 0;
+  ARMCII_Group_destroy(group);
 }
 
 
@@ -289,9 +675,9 @@ int ARMCI_Absolute_id(ARMCI_Group *group, int group_rank) {
   if (group->comm == ARMCI_GROUP_WORLD.comm)
     world_rank = group_rank;
 
-  /* Check for translation cache */
-  else if (group->grp_to_abs != NULL)
-    world_rank = group->grp_to_abs[group_rank];
+  /* Check for translation map */
+  else if (group->rank_map != NULL)
+    world_rank = ARMCII_Rank_map_to_absolute(group->rank_map, group_rank);
 
   else {
     /* Translate the rank */
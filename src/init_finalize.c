@@ -114,13 +114,45 @@ int PARMCI_Init(void) {
       ARMCII_Warning("ARMCI_FLUSH_BARRIERS is deprecated.  Use ARMCI_SYNC_AT_BARRIERS instead. \n");
   }
   ARMCII_GLOBAL_STATE.verbose              = ARMCII_Getenv_bool("ARMCI_VERBOSE", 0);
+  ARMCII_GLOBAL_STATE.alloc_stats_top      = ARMCII_Getenv_int("ARMCI_ALLOC_STATS", 0);
 
   /* Group formation options */
 
-  ARMCII_GLOBAL_STATE.cache_rank_translation=ARMCII_Getenv_bool("ARMCI_CACHE_RANK_TRANSLATION", 1);
+  if (ARMCII_Getenv("ARMCI_CACHE_RANK_TRANSLATION"))
+    ARMCII_Warning("ARMCI_CACHE_RANK_TRANSLATION is deprecated.  Rank translation tables are always built.\n");
+  ARMCII_GLOBAL_STATE.group_cache      = ARMCII_Getenv_bool("ARMCI_GROUP_CACHE", 1);
+  ARMCII_GLOBAL_STATE.group_cache_size = ARMCII_Getenv_int("ARMCI_GROUP_CACHE_SIZE", 16);
+
+  if (ARMCII_GLOBAL_STATE.group_cache_size < 0) {
+    ARMCII_Warning("Ignoring invalid value for ARMCI_GROUP_CACHE_SIZE (%d)\n", ARMCII_GLOBAL_STATE.group_cache_size);
+    ARMCII_GLOBAL_STATE.group_cache_size = 16;
+  }
+
   if (ARMCII_Getenv("ARMCI_NONCOLLECTIVE_GROUPS"))
     ARMCII_GLOBAL_STATE.noncollective_groups = ARMCII_Getenv_bool("ARMCI_NONCOLLECTIVE_GROUPS", 0);
 
+#ifdef HAVE_MPI_COMM_CREATE_GROUP
+  ARMCII_GLOBAL_STATE.noncoll_method = ARMCII_NONCOLL_CREATE_GROUP;
+#else
+  ARMCII_GLOBAL_STATE.noncoll_method = ARMCII_NONCOLL_INTERCOMM;
+#endif
+
+  var = ARMCII_Getenv("ARMCI_NONCOLLECTIVE_GROUPS_METHOD");
+  if (var != NULL) {
+    if (strcmp(var, "CREATE_GROUP") == 0) {
+#ifdef HAVE_MPI_COMM_CREATE_GROUP
+      ARMCII_GLOBAL_STATE.noncoll_method = ARMCII_NONCOLL_CREATE_GROUP;
+#else
+      if (ARMCI_GROUP_WORLD.rank == 0)
+        ARMCII_Warning("MPI_Comm_create_group is not available, using INTERCOMM noncollective groups\n");
+#endif
+    }
+    else if (strcmp(var, "INTERCOMM") == 0)
+      ARMCII_GLOBAL_STATE.noncoll_method = ARMCII_NONCOLL_INTERCOMM;
+    else if (ARMCI_GROUP_WORLD.rank == 0)
+      ARMCII_Warning("Ignoring unknown value for ARMCI_NONCOLLECTIVE_GROUPS_METHOD (%s)\n", var);
+  }
+
   /* Check for IOV flags */
 
   ARMCII_GLOBAL_STATE.iov_checks           = ARMCII_Getenv_bool("ARMCI_IOV_CHECKS", 0);
@@ -131,6 +163,9 @@ int PARMCI_Init(void) {
     ARMCII_GLOBAL_STATE.iov_batched_limit = 0;
   }
 
+  ARMCII_GLOBAL_STATE.iov_batched_adaptive = ARMCII_Getenv_bool("ARMCI_IOV_BATCHED_ADAPTIVE", 1);
+  ARMCII_Iov_flush_ctl_init();
+
 #if defined(OPEN_MPI)
   ARMCII_GLOBAL_STATE.iov_method = ARMCII_IOV_BATCHED;
 #else
@@ -205,6 +240,28 @@ int PARMCI_Init(void) {
 
   ARMCII_GLOBAL_STATE.use_alloc_shm=ARMCII_Getenv_bool("ARMCI_USE_ALLOC_SHM", 1);
 
+  /* Biased (lazy-release) mutexes */
+
+  ARMCII_GLOBAL_STATE.mutex_biased=ARMCII_Getenv_bool("ARMCI_MUTEX_BIASED", 0);
+
+  /* Queue nodes per process in each mutex handle */
+
+  ARMCII_GLOBAL_STATE.mutex_qnodes=ARMCII_Getenv_int("ARMCI_MUTEX_QNODES", 64);
+
+  if (ARMCII_GLOBAL_STATE.mutex_qnodes <= 0) {
+    ARMCII_Warning("Ignoring invalid value for ARMCI_MUTEX_QNODES (%d)\n", ARMCII_GLOBAL_STATE.mutex_qnodes);
+    ARMCII_GLOBAL_STATE.mutex_qnodes = 64;
+  }
+
+  /* Two-level collectives */
+
+  ARMCII_GLOBAL_STATE.hier_coll_threshold=ARMCII_Getenv_int("ARMCI_HIER_COLL_THRESHOLD", 65536);
+
+  if (ARMCII_GLOBAL_STATE.hier_coll_threshold < 0) {
+    ARMCII_Warning("Ignoring invalid value for ARMCI_HIER_COLL_THRESHOLD (%d)\n", ARMCII_GLOBAL_STATE.hier_coll_threshold);
+    ARMCII_GLOBAL_STATE.hier_coll_threshold = 65536;
+  }
+
   /* Enable RMA element-wise atomicity */
 
   ARMCII_GLOBAL_STATE.rma_atomicity=ARMCII_Getenv_bool("ARMCI_RMA_ATOMICITY", 0);
@@ -225,8 +282,7 @@ int PARMCI_Init(void) {
 
   /* Create GOP operators */
 
-  MPI_Op_create(ARMCII_Absmin_op, 1 /* commute */, &MPI_ABSMIN_OP);
-  MPI_Op_create(ARMCII_Absmax_op, 1 /* commute */, &MPI_ABSMAX_OP);
+  ARMCII_Gop_ops_create();
 
   MPI_Op_create(ARMCII_Msg_sel_min_op, 1 /* commute */, &MPI_SELMIN_OP);
   MPI_Op_create(ARMCII_Msg_sel_max_op, 1 /* commute */, &MPI_SELMAX_OP);
@@ -234,6 +290,7 @@ int PARMCI_Init(void) {
   ARMCII_GLOBAL_STATE.init_count++;
 
   ARMCI_PROFILE_INIT();
+  ARMCII_Comm_matrix_init();
 
   if (ARMCII_GLOBAL_STATE.verbose) {
     if (ARMCI_GROUP_WORLD.rank == 0) {
@@ -274,14 +331,23 @@ int PARMCI_Init(void) {
           printf("  IOV_BATCHED_LIMIT      = %d\n", ARMCII_GLOBAL_STATE.iov_batched_limit);
         else
           printf("  IOV_BATCHED_LIMIT      = UNLIMITED\n");
+        printf("  IOV_BATCHED_ADAPTIVE   = %s\n", ARMCII_GLOBAL_STATE.iov_batched_adaptive   ? "TRUE" : "FALSE");
       }
 
       printf("  IOV_CHECKS             = %s\n", ARMCII_GLOBAL_STATE.iov_checks             ? "TRUE" : "FALSE");
       printf("  SHR_BUF_METHOD         = %s\n", ARMCII_Shr_buf_methods_str[ARMCII_GLOBAL_STATE.shr_buf_method]);
       printf("  NONCOLLECTIVE_GROUPS   = %s\n", ARMCII_GLOBAL_STATE.noncollective_groups   ? "TRUE" : "FALSE");
-      printf("  CACHE_RANK_TRANSLATION = %s\n", ARMCII_GLOBAL_STATE.cache_rank_translation ? "TRUE" : "FALSE");
+      if (ARMCII_GLOBAL_STATE.noncollective_groups)
+        printf("  NONCOLL_GROUPS_METHOD  = %s\n", ARMCII_Noncoll_methods_str[ARMCII_GLOBAL_STATE.noncoll_method]);
+      if (ARMCII_GLOBAL_STATE.group_cache)
+        printf("  GROUP_CACHE_SIZE       = %d\n", ARMCII_GLOBAL_STATE.group_cache_size);
+      else
+        printf("  GROUP_CACHE            = FALSE\n");
       printf("  DEBUG_ALLOC            = %s\n", ARMCII_GLOBAL_STATE.debug_alloc            ? "TRUE" : "FALSE");
       printf("  RMA_ATOMICITY          = %s\n", ARMCII_GLOBAL_STATE.rma_atomicity          ? "TRUE" : "FALSE");
+      printf("  MUTEX_BIASED           = %s\n", ARMCII_GLOBAL_STATE.mutex_biased           ? "TRUE" : "FALSE");
+      printf("  MUTEX_QNODES           = %d\n", ARMCII_GLOBAL_STATE.mutex_qnodes);
+      printf("  HIER_COLL_THRESHOLD    = %d\n", ARMCII_GLOBAL_STATE.hier_coll_threshold);
       printf("\n");
       fflush(NULL);
     }
@@ -371,8 +437,6 @@ int PARMCI_Finalize(void) {
     return 0;
   }
 
-  ARMCI_PROFILE_DESTROY();
-
   ARMCII_GLOBAL_STATE.init_count--;
 
   /* Only finalize on the last matching call */
@@ -380,6 +444,10 @@ int PARMCI_Finalize(void) {
     return 0;
   }
 
+  ARMCI_PROFILE_DESTROY();
+  ARMCII_Comm_matrix_finalize();
+  ARMCII_Alloc_stats_report();
+
 #ifdef HAVE_PTHREADS
     /* Destroy the asynchronous progress thread */
     {
@@ -400,15 +468,16 @@ int PARMCI_Finalize(void) {
 
   /* Free GOP operators */
 
-  MPI_Op_free(&MPI_ABSMIN_OP);
-  MPI_Op_free(&MPI_ABSMAX_OP);
+  ARMCII_Gop_ops_free();
 
   MPI_Op_free(&MPI_SELMIN_OP);
   MPI_Op_free(&MPI_SELMAX_OP);
 
   ARMCI_Cleanup();
 
+  ARMCII_Group_cache_destroy_all();
   ARMCI_Group_free(&ARMCI_GROUP_WORLD);
+  ARMCII_Msg_hier_finalize();
 
   return 0;
 }
@@ -19,6 +19,7 @@ global_state_t ARMCII_GLOBAL_STATE = { 0 };
 char ARMCII_Strided_methods_str[][10] = { "IOV", "DIRECT" };
 char ARMCII_Iov_methods_str[][10]     = { "AUTO", "CONSRV", "BATCHED", "DIRECT" };
 char ARMCII_Shr_buf_methods_str[][10] = { "COPY", "NOGUARD" };
+char ARMCII_Noncoll_methods_str[][13] = { "CREATE_GROUP", "INTERCOMM" };
 
 /** Raise an internal fatal ARMCI error.
   *
@@ -66,9 +67,9 @@ int ARMCII_Translate_absolute_to_group(ARMCI_Group *group, int world_rank) {
   if (group->comm == ARMCI_GROUP_WORLD.comm) {
     group_rank = world_rank;
   }
-  /* Check for translation cache */
-  else if (group->grp_to_abs != NULL) {
-    group_rank = group->abs_to_grp[world_rank];
+  /* Check for translation map */
+  else if (group->rank_map != NULL) {
+    return ARMCII_Rank_map_to_group(group->rank_map, world_rank);
   }
   else {
     /* Translate the rank */
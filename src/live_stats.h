@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+/*
+ * live_stats.h
+ *  Layout of the shared-memory segment through which profiling builds
+ *  publish their running per-operation counters when ARMCI_LIVE_STATS is
+ *  set.  There is one segment per node, named ARMCII_LIVE_PREFIX.JOB.NODE,
+ *  with one slot per process on the node.  Each process is the only writer
+ *  of its slot and updates each counter with a relaxed atomic store, so
+ *  readers see every counter whole, though not all of a slot at the same
+ *  instant.  Shared by the library and armci-top, so it must not depend on
+ *  MPI.
+ */
+
+#ifndef HAVE_LIVE_STATS_H
+#define HAVE_LIVE_STATS_H
+
+#include <stdint.h>
+
+#define ARMCII_LIVE_PREFIX   "armci_stats"
+#define ARMCII_LIVE_MAGIC    0x41524d43494c5653ULL  /* "ARMCILVS" */
+#define ARMCII_LIVE_VERSION  1
+#define ARMCII_LIVE_NAME_LEN 32
+
+/* The header is followed by nfuncs operation names and then nslots slots */
+typedef struct {
+  uint64_t magic;           /* ARMCII_LIVE_MAGIC, set once the segment is complete        */
+  uint32_t version;         /* ARMCII_LIVE_VERSION                                        */
+  uint32_t nslots;          /* Number of processes on the node                            */
+  uint32_t nfuncs;          /* Number of operations per slot                              */
+  uint32_t slot_size;       /* Bytes per slot                                             */
+  uint64_t names_offset;    /* Offset of the operation names from the start of the segment */
+  uint64_t slots_offset;    /* Offset of the first slot                                   */
+  double   clock_hz;        /* Tick rate of the time counters                             */
+} armcii_live_header_t;
+
+typedef struct {
+  uint64_t calls;           /* Completed calls                                            */
+  uint64_t bytes;           /* Bytes transferred                                          */
+  uint64_t ticks;           /* Time spent in the operation                                */
+} armcii_live_func_t;
+
+typedef struct {
+  int32_t            rank;  /* World rank, -1 until the process has attached              */
+  int32_t            pid;
+  armcii_live_func_t funcs[];
+} armcii_live_slot_t;
+
+#define ARMCII_LIVE_SLOT_SIZE(nfuncs) \
+  ((sizeof(armcii_live_slot_t) + (nfuncs) * sizeof(armcii_live_func_t) + 63) & ~(uint64_t) 63)
+
+#endif /* HAVE_LIVE_STATS_H */
@@ -31,7 +31,16 @@
   * @param[in]       size Number of bytes to allocate on the local process.
   */
 int PARMCI_Malloc(void **ptr_arr, armci_size_t bytes) {
-  return ARMCI_Malloc_group(ptr_arr, bytes, &ARMCI_GROUP_WORLD);
+  int err;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Malloc);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Malloc, -1, bytes);
+
+  err = ARMCI_Malloc_group(ptr_arr, bytes, &ARMCI_GROUP_WORLD);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Malloc);
+
+  return err;
 }
 
 
@@ -50,7 +59,15 @@ int PARMCI_Malloc(void **ptr_arr, armci_size_t bytes) {
   * @param[in] ptr Pointer to the local patch of the allocation
   */
 int PARMCI_Free(void *ptr) {
-  return ARMCI_Free_group(ptr, &ARMCI_GROUP_WORLD);
+  int err;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Free);
+
+  err = ARMCI_Free_group(ptr, &ARMCI_GROUP_WORLD);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Free);
+
+  return err;
 }
 
 
@@ -128,12 +145,17 @@ int ARMCI_Free_group(void *ptr, ARMCI_Group *group) {
 void *PARMCI_Malloc_local(armci_size_t size) {
   void *buf;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Malloc_local);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Malloc_local, -1, size);
+
   MPI_Alloc_mem((MPI_Aint) size, MPI_INFO_NULL, &buf);
 
   if (ARMCII_GLOBAL_STATE.debug_alloc) {
     ARMCII_Bzero(buf, size);
   }
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Malloc_local);
+
   return buf;
 }
 
@@ -153,6 +175,10 @@ void *PARMCI_Malloc_local(armci_size_t size) {
   * @param[in] buf Pointer to local buffer to free
   */
 int PARMCI_Free_local(void *buf) {
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Free_local);
+
   MPI_Free_mem(buf);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Free_local);
   return 0;
 }
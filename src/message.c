@@ -5,12 +5,99 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <math.h>
 #include <mpi.h>
 
 #include <debug.h>
 #include <armci.h>
 #include <armci_internals.h>
 
+/** Attribute key for the node hierarchy of a communicator.
+  */
+static int ARMCII_Msg_hier_keyval = MPI_KEYVAL_INVALID;
+
+
+/** Attribute delete callback for the node hierarchy.
+  */
+static int ARMCII_Msg_hier_delete(MPI_Comm comm, int keyval, void *attr, void *extra_state) {
+  ARMCII_Msg_hier_t *hier = attr;
+
+  MPI_Comm_free(&hier->node_comm);
+  if (hier->leader_comm != MPI_COMM_NULL)
+    MPI_Comm_free(&hier->leader_comm);
+
+  free(hier->node_of);
+  free(hier->node_rank_of);
+  free(hier);
+
+  return MPI_SUCCESS;
+}
+
+
+/** Fetch the node hierarchy of a group, building it on first use.  Collective
+  * on the group.
+  *
+  * @param[in] group Group to query
+  * @return          Node hierarchy of the group
+  */
+ARMCII_Msg_hier_t *ARMCII_Msg_hier_get(ARMCI_Group *group) {
+  ARMCII_Msg_hier_t *hier;
+  int                flag, node_rank, i, mine[2], *all;
+
+  if (ARMCII_Msg_hier_keyval == MPI_KEYVAL_INVALID)
+    MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, ARMCII_Msg_hier_delete, &ARMCII_Msg_hier_keyval, NULL);
+
+  MPI_Comm_get_attr(group->comm, ARMCII_Msg_hier_keyval, &hier, &flag);
+  if (flag)
+    return hier;
+
+  hier = malloc(sizeof(ARMCII_Msg_hier_t));
+  ARMCII_Assert(hier != NULL);
+
+  MPI_Comm_split_type(group->comm, MPI_COMM_TYPE_SHARED, group->rank, MPI_INFO_NULL, &hier->node_comm);
+  MPI_Comm_rank(hier->node_comm, &node_rank);
+  MPI_Comm_split(group->comm, node_rank == 0 ? 0 : MPI_UNDEFINED, group->rank, &hier->leader_comm);
+
+  /* Node leaders number the nodes and tell the rest of their node */
+  if (hier->leader_comm != MPI_COMM_NULL) {
+    MPI_Comm_rank(hier->leader_comm, &mine[0]);
+    MPI_Comm_size(hier->leader_comm, &mine[1]);
+  }
+
+  MPI_Bcast(mine, 2, MPI_INT, 0, hier->node_comm);
+  hier->nnodes = mine[1];
+  mine[1]      = node_rank;
+
+  all                = malloc(2*sizeof(int)*group->size);
+  hier->node_of      = malloc(sizeof(int)*group->size);
+  hier->node_rank_of = malloc(sizeof(int)*group->size);
+  ARMCII_Assert(all != NULL && hier->node_of != NULL && hier->node_rank_of != NULL);
+
+  MPI_Allgather(mine, 2, MPI_INT, all, 2, MPI_INT, group->comm);
+
+  for (i = 0; i < group->size; i++) {
+    hier->node_of[i]      = all[2*i];
+    hier->node_rank_of[i] = all[2*i+1];
+  }
+
+  free(all);
+
+  MPI_Comm_set_attr(group->comm, ARMCII_Msg_hier_keyval, hier);
+
+  return hier;
+}
+
+
+/** Free the node hierarchy attribute key.  Called at finalize, after the
+  * groups have been freed.
+  */
+void ARMCII_Msg_hier_finalize(void) {
+  if (ARMCII_Msg_hier_keyval != MPI_KEYVAL_INVALID)
+    MPI_Comm_free_keyval(&ARMCII_Msg_hier_keyval);
+}
+
+
 /** Query process rank from messaging (MPI) layer.
   */
 int armci_msg_me(void) {
@@ -139,30 +226,63 @@ void parmci_msg_group_barrier(ARMCI_Group *group) {
   * @param[in]    group ARMCI group on which to perform communication
   */
 void armci_msg_group_bcast_scope(int scope, void *buf_in, int len, int abs_root, ARMCI_Group *group) {
-  int    grp_root;
-  void **buf;
+  int                grp_root;
+  void             **buf;
+  ARMCII_Msg_hier_t *hier = NULL;
 
-  if (scope == SCOPE_ALL || scope == SCOPE_MASTERS) {
-    /* Is the buffer an input or an output? */
-    if (ARMCI_GROUP_WORLD.rank == abs_root)
-      ARMCII_Buf_prepare_read_vec(&buf_in, &buf, 1, len);
-    else
-      ARMCII_Buf_prepare_write_vec(&buf_in, &buf, 1, len);
+  grp_root = ARMCII_Translate_absolute_to_group(group, abs_root);
+  ARMCII_Assert(grp_root >= 0 && grp_root < group->size);
 
-    grp_root = ARMCII_Translate_absolute_to_group(group, abs_root);
-    ARMCII_Assert(grp_root >= 0 && grp_root < group->size);
+  if (scope != SCOPE_ALL || (ARMCII_GLOBAL_STATE.hier_coll_threshold > 0 && len >= ARMCII_GLOBAL_STATE.hier_coll_threshold))
+    hier = ARMCII_Msg_hier_get(group);
 
-    MPI_Bcast(buf[0], len, MPI_BYTE, grp_root, group->comm);
+  /* Only node masters take part in SCOPE_MASTERS */
+  if (scope == SCOPE_MASTERS && hier->leader_comm == MPI_COMM_NULL)
+    return;
+
+  /* Is the buffer an input or an output? */
+  if (ARMCI_GROUP_WORLD.rank == abs_root)
+    ARMCII_Buf_prepare_read_vec(&buf_in, &buf, 1, len);
+  else
+    ARMCII_Buf_prepare_write_vec(&buf_in, &buf, 1, len);
+
+  if (scope == SCOPE_NODE) {
+    ARMCII_Assert_msg(hier->node_of[grp_root] == hier->node_of[group->rank], "SCOPE_NODE root is not on this node");
+    MPI_Bcast(buf[0], len, MPI_BYTE, hier->node_rank_of[grp_root], hier->node_comm);
+  }
+
+  else if (scope == SCOPE_MASTERS) {
+    ARMCII_Assert_msg(hier->node_rank_of[grp_root] == 0, "SCOPE_MASTERS root is not a node master");
+    MPI_Bcast(buf[0], len, MPI_BYTE, hier->node_of[grp_root], hier->leader_comm);
+  }
+
+  /* Two-level broadcast: root to its node leader, among leaders, then within
+     each node */
+  else if (hier != NULL && hier->nnodes > 1 && hier->nnodes < group->size) {
+    const int root_node = hier->node_of[grp_root];
+    const int root_rank = hier->node_rank_of[grp_root];
+
+    if (root_rank != 0 && hier->node_of[group->rank] == root_node) {
+      if (group->rank == grp_root)
+        MPI_Send(buf[0], len, MPI_BYTE, 0, 0, hier->node_comm);
+      else if (hier->node_rank_of[group->rank] == 0)
+        MPI_Recv(buf[0], len, MPI_BYTE, root_rank, 0, hier->node_comm, MPI_STATUS_IGNORE);
+    }
 
-    if (ARMCI_GROUP_WORLD.rank == abs_root)
-      ARMCII_Buf_finish_read_vec(&buf_in, buf, 1, len);
-    else
-      ARMCII_Buf_finish_write_vec(&buf_in, buf, 1, len);
-  } else /* SCOPE_NODE */ {
-    grp_root = 0;
+    if (hier->leader_comm != MPI_COMM_NULL)
+      MPI_Bcast(buf[0], len, MPI_BYTE, root_node, hier->leader_comm);
 
-    /* This is a self-broadcast, which is a no-op. */
+    MPI_Bcast(buf[0], len, MPI_BYTE, 0, hier->node_comm);
   }
+
+  else {
+    MPI_Bcast(buf[0], len, MPI_BYTE, grp_root, group->comm);
+  }
+
+  if (ARMCI_GROUP_WORLD.rank == abs_root)
+    ARMCII_Buf_finish_read_vec(&buf_in, buf, 1, len);
+  else
+    ARMCII_Buf_finish_write_vec(&buf_in, buf, 1, len);
 }
 
 
@@ -226,16 +346,6 @@ int armci_msg_rcvany(int tag, void *buf_out, int nbytes_buf, int *nbytes_msg) {
 }
 
 
-void armci_msg_reduce(void *x, int n, char *op, int type) {
-  armci_msg_reduce_scope(SCOPE_ALL, x, n, op, type);
-}
-
-
-void armci_msg_reduce_scope(int scope, void *x, int n, char *op, int type) {
-  ARMCII_Error("unimplemented"); // TODO
-}
-
-
 /** Map process IDs onto a binary tree.
   *
   * @param[in]  scope Scope of processes involved
@@ -380,6 +490,65 @@ void ARMCII_Msg_sel_max_op(void *data_in, void *data_inout, int *len, MPI_Dataty
 }
 
 
+/** Select on a value followed by a single int index using MPI_MINLOC or
+  * MPI_MAXLOC, which MPI can optimize or offload, rather than the opaque
+  * select operations.  Non-contributing processes supply a value that can
+  * only win if nobody contributes.  Ties are broken by the lowest index.
+  *
+  * Only the packed layout is recognized: a padded struct has the same size as
+  * a value followed by a long index, which MPI pair types would truncate.
+  *
+  * @param[in]    comm       Communicator on which to select
+  * @param[inout] x          Value-index pair, contains input and will contain output
+  * @param[in]    n          Size of x in bytes, a packed value and int index
+  * @param[in]    is_min     Select the minimum (1) or the maximum (0)
+  * @param[in]    type       Data type of the value
+  * @param[in]    contribute Whether this process contributes x
+  * @return                  Non-zero if the selection was performed
+  */
+static int ARMCII_Msg_sel_loc(MPI_Comm comm, void *x, int n, int is_min, int type, int contribute) {
+
+#define MSG_SEL_LOC(TYPE,MPI_PAIR,LO,HI)                                                 \
+  do {                                                                                  \
+    struct { TYPE val; int idx; } in, out;                                              \
+    const int len = sizeof(TYPE) + sizeof(int);                                         \
+                                                                                        \
+    if (n != len)                                                                       \
+      return 0;                                                                         \
+                                                                                        \
+    if (contribute) {                                                                   \
+      ARMCI_Copy(x, &in, len);                                                          \
+    } else {                                                                            \
+      in.val = is_min ? (HI) : (LO);                                                    \
+      in.idx = INT_MAX;                                                                 \
+    }                                                                                   \
+                                                                                        \
+    MPI_Allreduce(&in, &out, 1, MPI_PAIR, is_min ? MPI_MINLOC : MPI_MAXLOC, comm);      \
+    ARMCI_Copy(&out, x, len);                                                           \
+  } while (0)
+
+  switch (type) {
+    case ARMCI_INT:
+      MSG_SEL_LOC(int, MPI_2INT, INT_MIN, INT_MAX);
+      return 1;
+    case ARMCI_LONG:
+      MSG_SEL_LOC(long, MPI_LONG_INT, LONG_MIN, LONG_MAX);
+      return 1;
+    case ARMCI_FLOAT:
+      MSG_SEL_LOC(float, MPI_FLOAT_INT, -INFINITY, INFINITY);
+      return 1;
+    case ARMCI_DOUBLE:
+      MSG_SEL_LOC(double, MPI_DOUBLE_INT, -INFINITY, INFINITY);
+      return 1;
+    default:
+      /* There is no MPI pair type for long long */
+      return 0;
+  }
+
+#undef MSG_SEL_LOC
+}
+
+
 /** Collective index selection reduce operation.
   */
 void armci_msg_sel(void *x, int n, char *op, int type, int contribute) {
@@ -393,6 +562,7 @@ void armci_msg_sel_scope(int scope, void *x, int n, char* op, int type, int cont
   MPI_Comm    sel_comm;
   sel_data_t *data_in, *data_out;
   void      **x_buf;
+  int         is_min = 0;
 
   /*
   printf("[%d] armci_msg_sel_scope(scope=%d, x=%p, n=%d, op=%s, type=%d, contribute=%d)\n",
@@ -400,33 +570,47 @@ void armci_msg_sel_scope(int scope, void *x, int n, char* op, int type, int cont
   */
 
   /* Determine the scope of the collective operation */
-  if (scope == SCOPE_ALL || scope == SCOPE_MASTERS)
+  if (scope == SCOPE_NODE)
+    sel_comm = ARMCII_Msg_hier_get(&ARMCI_GROUP_WORLD)->node_comm;
+  else if (scope == SCOPE_MASTERS)
+    sel_comm = ARMCII_Msg_hier_get(&ARMCI_GROUP_WORLD)->leader_comm;
+  else
     sel_comm = ARMCI_GROUP_WORLD.comm;
+
+  /* Only node masters take part in SCOPE_MASTERS */
+  if (sel_comm == MPI_COMM_NULL)
+    return;
+
+  if (strncmp(op, "min", 3) == 0)
+    is_min = 1;
+  else if (strncmp(op, "max", 3) == 0)
+    is_min = 0;
   else
-    sel_comm = MPI_COMM_SELF;
+    ARMCII_Error("Invalid operation (%s)", op);
+
+  ARMCII_Buf_prepare_read_vec(&x, &x_buf, 1, n);
+
+  /* Fast path: a value followed by one int index */
+  if (ARMCII_Msg_sel_loc(sel_comm, x_buf[0], n, is_min, type, contribute)) {
+    ARMCII_Buf_finish_write_vec(&x, x_buf, 1, n);
+    return;
+  }
 
   data_in  = malloc(sizeof(sel_data_t)+n-1);
   data_out = malloc(sizeof(sel_data_t)+n-1);
 
   ARMCII_Assert(data_in != NULL && data_out != NULL);
 
-  ARMCII_Buf_prepare_read_vec(&x, &x_buf, 1, n);
-
   data_in->contribute = contribute;
   data_in->type       = type;
 
   if (contribute)
-    ARMCI_Copy(x, data_in->data, n);
-
-  if (strncmp(op, "min", 3) == 0) {
-    MPI_Allreduce(data_in, data_out, sizeof(sel_data_t)+n-1, MPI_BYTE, MPI_SELMIN_OP, sel_comm);
-  } else if (strncmp(op, "max", 3) == 0) {
-    MPI_Allreduce(data_in, data_out, sizeof(sel_data_t)+n-1, MPI_BYTE, MPI_SELMAX_OP, sel_comm);
-  } else {
-      ARMCII_Error("Invalid operation (%s)", op);
-  }
+    ARMCI_Copy(x_buf[0], data_in->data, n);
+
+  MPI_Allreduce(data_in, data_out, sizeof(sel_data_t)+n-1, MPI_BYTE,
+                is_min ? MPI_SELMIN_OP : MPI_SELMAX_OP, sel_comm);
 
-  ARMCI_Copy(data_out->data, x, n);
+  ARMCI_Copy(data_out->data, x_buf[0], n);
 
   ARMCII_Buf_finish_write_vec(&x, x_buf, 1, n);
 
@@ -9,10 +9,11 @@
 
 /** Note on scopes:
   *
-  * SCOPE_NODE    - Include all processes on the current node.  In the current
-  *                 implementation we use MPI_COMM_SELF for this.
-  * SCOPE_MASTERS - Includes one rank from every node.  Currently the same as
-                    SCOPE_ALL.
+  * SCOPE_NODE    - Include all processes on the current node.  Each node
+  *                 performs a separate operation.
+  * SCOPE_MASTERS - Includes one rank (the lowest) from every node.  All
+  *                 processes make the call, but only node masters contribute
+  *                 and receive the result.
   * SCOPE_ALL     - Includes all processes.
   */
 enum armci_scope_e { SCOPE_ALL, SCOPE_NODE, SCOPE_MASTERS}; 
@@ -44,9 +45,6 @@ void armci_msg_bcast_scope(int scope, void *buffer, int len, int root);
 void armci_msg_brdcst(void *buffer, int len, int root);
 void armci_msg_group_bcast_scope(int scope, void *buf, int len, int root, ARMCI_Group *group);
 
-/* TODO */ void armci_msg_reduce(void *x, int n, char *op, int type); 
-/* TODO */ void armci_msg_reduce_scope(int scope, void *x, int n, char *op, int type); 
-
 void armci_msg_sel(void *x, int n, char *op, int type, int contribute);
 void armci_msg_sel_scope(int scope, void *x, int n, char *op, int type, int contribute);
 
@@ -78,4 +76,32 @@ void armci_msg_group_llgop(long long *x, int n, char *op, ARMCI_Group *group);
 void armci_msg_group_fgop(float *x, int n, char *op, ARMCI_Group *group);
 void armci_msg_group_dgop(double *x, int n,char *op, ARMCI_Group *group);
 
+/* Reductions to the first process in the scope only */
+
+void armci_msg_reduce(void *x, int n, char *op, int type);
+void armci_msg_reduce_scope(int scope, void *x, int n, char *op, int type);
+void armci_msg_group_reduce_scope(int scope, void *x, int n, char *op, int type, ARMCI_Group *group);
+
+/* Non-blocking Global Operations: the buffer must not be accessed until the
+ * operation is completed with armci_msg_wait or armci_msg_test. */
+
+typedef struct armci_msg_hdl_s *armci_msg_hdl_t;
+
+void armci_msg_gop_scope_nb(int scope, void *x, int n, char *op, int type, armci_msg_hdl_t *hdl);
+void armci_msg_igop_nb(int *x, int n, char *op, armci_msg_hdl_t *hdl);
+void armci_msg_lgop_nb(long *x, int n, char *op, armci_msg_hdl_t *hdl);
+void armci_msg_llgop_nb(long long *x, int n, char *op, armci_msg_hdl_t *hdl);
+void armci_msg_fgop_nb(float *x, int n, char *op, armci_msg_hdl_t *hdl);
+void armci_msg_dgop_nb(double *x, int n, char *op, armci_msg_hdl_t *hdl);
+
+void armci_msg_group_gop_scope_nb(int scope, void *x, int n, char *op, int type, ARMCI_Group *group,
+                                  armci_msg_hdl_t *hdl);
+
+void armci_msg_reduce_scope_nb(int scope, void *x, int n, char *op, int type, armci_msg_hdl_t *hdl);
+void armci_msg_group_reduce_scope_nb(int scope, void *x, int n, char *op, int type, ARMCI_Group *group,
+                                     armci_msg_hdl_t *hdl);
+
+void armci_msg_wait(armci_msg_hdl_t *hdl);
+int  armci_msg_test(armci_msg_hdl_t *hdl);
+
 #endif /* HAVE_ARMCI_MSG_H */
@@ -5,209 +5,425 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <mpi.h>
 
 #include <debug.h>
 #include <armci.h>
 #include <armci_internals.h>
+#include <gmr.h>
 
-/* MPI Operations, registered in Init */
-MPI_Op MPI_ABSMIN_OP;
-MPI_Op MPI_ABSMAX_OP;
-
-#define IABS(X)  (((X) > 0  ) ? X : -X)
-#define FABS(X)  (((X) > 0.0) ? X : -X)
-#define MIN(X,Y) (((X) < (Y)) ? X : Y)
-#define MAX(X,Y) (((X) > (Y)) ? X : Y)
-
-#define ABSMIN(IN,INOUT,COUNT,DTYPE,ABSOP)      \
-      do {                                      \
-        int i;                                  \
-        DTYPE *in = (DTYPE *)IN;                \
-        DTYPE *io = (DTYPE *)INOUT;             \
-        for (i = 0; i < COUNT; i++) {           \
-          const DTYPE x = ABSOP(in[i]);         \
-          const DTYPE y = ABSOP(io[i]);         \
-          io[i] = MIN(x,y);                     \
-        }                                       \
-      } while (0)
-
-/** MPI reduction operator that computes the minimum absolute value.
+/* Per-datatype ABSMIN/ABSMAX operations, indexed by ARMCI type and created in
+ * Init */
+MPI_Op ARMCII_Absmin_ops[ARMCII_GOP_NTYPES];
+MPI_Op ARMCII_Absmax_ops[ARMCII_GOP_NTYPES];
+
+#define IABS(X)  (((X) > 0) ? (X) : -(X))
+#define MIN(X,Y) (((X) < (Y)) ? (X) : (Y))
+#define MAX(X,Y) (((X) > (Y)) ? (X) : (Y))
+
+/** Floating point absolute values clear the sign bit, so that the loops below
+  * compile to vector masks.
   */
-void ARMCII_Absmin_op(void *invec, void *inoutvec, int *len, MPI_Datatype *datatype) {
-  const int    count = *len;
-  MPI_Datatype dt    = *datatype;
-
-  if (dt == MPI_INT) {
-      ABSMIN(invec, inoutvec, count, int, IABS);
-  } else if (dt == MPI_LONG) {
-      ABSMIN(invec, inoutvec, count, long, IABS);
-  } else if (dt == MPI_LONG_LONG) {
-      ABSMIN(invec, inoutvec, count, long long, IABS);
-  } else if (dt == MPI_FLOAT) {
-      ABSMIN(invec, inoutvec, count, float, FABS);
-  } else if (dt == MPI_DOUBLE) {
-      ABSMIN(invec, inoutvec, count, double, FABS);
-  } else {
-      ARMCII_Error("unknown type (%d)", *datatype);
-  }
+static inline float FABSF(float x) {
+  union { float f; uint32_t u; } v = { x };
+  v.u &= 0x7fffffffu;
+  return v.f;
 }
 
-#undef ABSMIN
+static inline double FABS(double x) {
+  union { double f; uint64_t u; } v = { x };
+  v.u &= 0x7fffffffffffffffull;
+  return v.f;
+}
 
+/** Generate the ABSMIN, ABSMAX, and ABSV kernels for one data type.  Each
+  * kernel is a branch-free loop over restrict-qualified vectors, which the
+  * compiler can vectorize.
+  */
+#define ABS_KERNELS(NAME,DTYPE,ABSOP)                                                           \
+static void ARMCII_Absmin_##NAME(void *invec, void *inoutvec, int *len, MPI_Datatype *datatype) { \
+  const DTYPE *restrict in = (const DTYPE *) invec;                                            \
+  DTYPE       *restrict io = (DTYPE *) inoutvec;                                               \
+  int i;                                                                                       \
+  for (i = 0; i < *len; i++)                                                                   \
+    io[i] = MIN(ABSOP(in[i]), ABSOP(io[i]));                                                   \
+}                                                                                              \
+static void ARMCII_Absmax_##NAME(void *invec, void *inoutvec, int *len, MPI_Datatype *datatype) { \
+  const DTYPE *restrict in = (const DTYPE *) invec;                                            \
+  DTYPE       *restrict io = (DTYPE *) inoutvec;                                               \
+  int i;                                                                                       \
+  for (i = 0; i < *len; i++)                                                                   \
+    io[i] = MAX(ABSOP(in[i]), ABSOP(io[i]));                                                   \
+}                                                                                              \
+static void ARMCII_Absv_##NAME(void *inoutvec, int count) {                                    \
+  DTYPE *restrict io = (DTYPE *) inoutvec;                                                     \
+  int i;                                                                                       \
+  for (i = 0; i < count; i++)                                                                  \
+    io[i] = ABSOP(io[i]);                                                                      \
+}
+
+ABS_KERNELS(int,       int,       IABS)
+ABS_KERNELS(long,      long,      IABS)
+ABS_KERNELS(long_long, long long, IABS)
+ABS_KERNELS(float,     float,     FABSF)
+ABS_KERNELS(double,    double,    FABS)
 
-#define ABSMAX(IN,INOUT,COUNT,DTYPE,ABSOP)      \
-      do {                                      \
-        int i;                                  \
-        DTYPE *in = (DTYPE *)IN;                \
-        DTYPE *io = (DTYPE *)INOUT;             \
-        for (i = 0; i < COUNT; i++) {           \
-          const DTYPE x = ABSOP(in[i]);         \
-          const DTYPE y = ABSOP(io[i]);         \
-          io[i] = MAX(x,y);                     \
-        }                                       \
-      } while (0)
+#undef ABS_KERNELS
 
-/** MPI reduction operator that computes the maximum absolute value.
+/** Kernel tables, indexed by ARMCI type.
   */
-void ARMCII_Absmax_op(void *invec, void *inoutvec, int *len, MPI_Datatype *datatype) {
-  const int    count = *len;
-  MPI_Datatype dt    = *datatype;
-
-  if (dt == MPI_INT) {
-      ABSMAX(invec, inoutvec, count, int, IABS);
-  } else if (dt == MPI_LONG) {
-      ABSMAX(invec, inoutvec, count, long, IABS);
-  } else if (dt == MPI_LONG_LONG) {
-      ABSMAX(invec, inoutvec, count, long long, IABS);
-  } else if (dt == MPI_FLOAT) {
-      ABSMAX(invec, inoutvec, count, float, FABS);
-  } else if (dt == MPI_DOUBLE) {
-      ABSMAX(invec, inoutvec, count, double, FABS);
-  } else {
-      ARMCII_Error("unknown type (%d)", *datatype);
-  }
-}
+static MPI_User_function * const ARMCII_Absmin_fns[ARMCII_GOP_NTYPES] = {
+  ARMCII_Absmin_int, ARMCII_Absmin_long, ARMCII_Absmin_long_long, ARMCII_Absmin_float, ARMCII_Absmin_double };
 
-#undef ABSMAX
+static MPI_User_function * const ARMCII_Absmax_fns[ARMCII_GOP_NTYPES] = {
+  ARMCII_Absmax_int, ARMCII_Absmax_long, ARMCII_Absmax_long_long, ARMCII_Absmax_float, ARMCII_Absmax_double };
 
+static void (* const ARMCII_Absv_fns[ARMCII_GOP_NTYPES])(void *, int) = {
+  ARMCII_Absv_int, ARMCII_Absv_long, ARMCII_Absv_long_long, ARMCII_Absv_float, ARMCII_Absv_double };
 
-#define ABSV(IN,INOUT,COUNT,DTYPE,ABSOP)        \
-      do {                                      \
-        int i;                                  \
-        DTYPE *in = (DTYPE *)IN;                \
-        DTYPE *io = (DTYPE *)INOUT;             \
-        for (i = 0; i < COUNT; i++)             \
-          io[i] = ABSOP(in[i]);                 \
-      } while (0)
 
-/** Compute the absolute value.
+/** Create the per-datatype ABSMIN/ABSMAX operations.  Called in Init.
   */
-void ARMCII_Absv_op(void *invec, void *inoutvec, int *len, MPI_Datatype *datatype) {
-  const int    count = *len;
-  MPI_Datatype dt    = *datatype;
-
-  if (dt == MPI_INT) {
-      ABSV(invec, inoutvec, count, int, IABS);
-  } else if (dt == MPI_LONG) {
-      ABSV(invec, inoutvec, count, long, IABS);
-  } else if (dt == MPI_LONG_LONG) {
-      ABSV(invec, inoutvec, count, long long, IABS);
-  } else if (dt == MPI_FLOAT) {
-      ABSV(invec, inoutvec, count, float, FABS);
-  } else if (dt == MPI_DOUBLE) {
-      ABSV(invec, inoutvec, count, double, FABS);
-  } else {
-      ARMCII_Error("unknown type (%d)", *datatype);
+void ARMCII_Gop_ops_create(void) {
+  int i;
+
+  for (i = 0; i < ARMCII_GOP_NTYPES; i++) {
+    MPI_Op_create(ARMCII_Absmin_fns[i], 1 /* commute */, &ARMCII_Absmin_ops[i]);
+    MPI_Op_create(ARMCII_Absmax_fns[i], 1 /* commute */, &ARMCII_Absmax_ops[i]);
   }
 }
 
-#undef ABSV
 
+/** Free the per-datatype ABSMIN/ABSMAX operations.  Called in Finalize.
+  */
+void ARMCII_Gop_ops_free(void) {
+  int i;
 
-/** General ARMCI global operation (reduction).  Collective on group.
+  for (i = 0; i < ARMCII_GOP_NTYPES; i++) {
+    MPI_Op_free(&ARMCII_Absmin_ops[i]);
+    MPI_Op_free(&ARMCII_Absmax_ops[i]);
+  }
+}
+
+
+/** Replace each element of a vector with its absolute value.
   *
-  * @param[in]    scope Scope in which to perform the GOP (only SCOPE_ALL is supported)
-  * @param[inout] x     Vector of n data elements, contains input and will contain output.
+  * @param[inout] x     Vector of n data elements
   * @param[in]    n     Length of x
-  * @param[in]    op    One of '+', '*', 'max', 'min', 'absmax', 'absmin'
   * @param[in]    type  Data type of x (e.g. ARMCI_INT, ...)
-  * @param[in]    group Group on which to perform the GOP
   */
-void armci_msg_group_gop_scope(int scope, void *x, int n, char *op, int type, ARMCI_Group *group) {
-  void        *out, **x_buf;
-  MPI_Op       mpi_op;
-  MPI_Datatype mpi_type;
-  MPI_Comm     comm;
-  int          mpi_type_size;
-
-  /* FIXME: scope argument presently ignored */
-  if (scope == SCOPE_ALL || scope == SCOPE_MASTERS)
-    comm = group->comm;
-  else
-    comm = MPI_COMM_SELF;
+void ARMCII_Absv(void *x, int n, int type) {
+  ARMCII_Assert(type >= 0 && type < ARMCII_GOP_NTYPES);
+  ARMCII_Absv_fns[type](x, n);
+}
 
-  if (op[0] == '+') {
-    mpi_op = MPI_SUM;
-  } else if (op[0] == '*') {
-    mpi_op = MPI_PROD;
-  } else if (strncmp(op, "max", 3) == 0) {
-    mpi_op = MPI_MAX;
-  } else if (strncmp(op, "min", 3) == 0) {
-    mpi_op = MPI_MIN;
-  } else if (strncmp(op, "or", 2) == 0) {
-    mpi_op = MPI_BOR;
-  } else if (strncmp(op, "absmax", 6) == 0) {
-    mpi_op = MPI_ABSMAX_OP;
-  } else if (strncmp(op, "absmin", 6) == 0) {
-    mpi_op = MPI_ABSMIN_OP;
-  } else {
-    ARMCII_Error("unknown operation \'%s\'", op);
-    return;
-  }
+
+/** Translate an ARMCI GOP operation and data type into MPI ones.
+  *
+  * @param[in]  op       One of '+', '*', 'max', 'min', 'or', 'absmax', 'absmin'
+  * @param[in]  type     Data type (e.g. ARMCI_INT, ...)
+  * @param[out] mpi_op   MPI operation
+  * @param[out] mpi_type MPI data type
+  */
+static void ARMCII_Gop_translate(char *op, int type, MPI_Op *mpi_op, MPI_Datatype *mpi_type) {
+  *mpi_op   = MPI_OP_NULL;
+  *mpi_type = MPI_DATATYPE_NULL;
 
   switch(type) {
     case ARMCI_INT:
-      mpi_type = MPI_INT;
+      *mpi_type = MPI_INT;
       break;
     case ARMCI_LONG:
-      mpi_type = MPI_LONG;
+      *mpi_type = MPI_LONG;
       break;
     case ARMCI_LONG_LONG:
-      mpi_type = MPI_LONG_LONG;
+      *mpi_type = MPI_LONG_LONG;
       break;
     case ARMCI_FLOAT:
-      mpi_type = MPI_FLOAT;
+      *mpi_type = MPI_FLOAT;
       break;
     case ARMCI_DOUBLE:
-      mpi_type = MPI_DOUBLE;
+      *mpi_type = MPI_DOUBLE;
       break;
     default:
       ARMCII_Error("unknown type (%d)", type);
       return;
   }
 
+  if (op[0] == '+') {
+    *mpi_op = MPI_SUM;
+  } else if (op[0] == '*') {
+    *mpi_op = MPI_PROD;
+  } else if (strncmp(op, "max", 3) == 0) {
+    *mpi_op = MPI_MAX;
+  } else if (strncmp(op, "min", 3) == 0) {
+    *mpi_op = MPI_MIN;
+  } else if (strncmp(op, "or", 2) == 0) {
+    *mpi_op = MPI_BOR;
+  } else if (strncmp(op, "absmax", 6) == 0) {
+    *mpi_op = ARMCII_Absmax_ops[type];
+  } else if (strncmp(op, "absmin", 6) == 0) {
+    *mpi_op = ARMCII_Absmin_ops[type];
+  } else {
+    ARMCII_Error("unknown operation \'%s\'", op);
+    return;
+  }
+}
+
+
+/** State of a non-blocking global operation.
+  */
+struct armci_msg_hdl_s {
+  MPI_Request   request;        /* Request of the reduction                            */
+  void         *x;              /* User's buffer                                       */
+  void        **x_buf;          /* Private copy of x if it is in shared space, or NULL */
+  int           size;           /* Size of x in bytes                                  */
+  int           result;         /* Whether x receives the result                       */
+};
+
+
+/** Start a global operation in place on a private copy of x.  The reduction
+  * is performed directly in x unless x is in shared space.  Collective on
+  * group.  With root_only, only the first process in the scope receives the
+  * result and x is left unchanged on the others.
+  *
+  * @param[in]    scope   Scope in which to perform the GOP
+  * @param[inout] x       Vector of n data elements, contains input and will contain output.
+  * @param[in]    n       Length of x
+  * @param[in]    op      One of '+', '*', 'max', 'min', 'absmax', 'absmin'
+  * @param[in]    type    Data type of x (e.g. ARMCI_INT, ...)
+  * @param[in]    group   Group on which to perform the GOP
+  * @param[out]   hdl     State of the operation
+  * @param[in]    blocking Complete the reduction before returning
+  * @param[in]    root_only Reduce to the first process in the scope only
+  */
+static void ARMCII_Gop_start(int scope, void *x, int n, char *op, int type, ARMCI_Group *group,
+                             struct armci_msg_hdl_s *hdl, int blocking, int root_only) {
+  MPI_Op             mpi_op;
+  MPI_Datatype       mpi_type;
+  MPI_Comm           comm;
+  int                mpi_type_size, comm_size, comm_rank;
+  void              *buf;
+  ARMCII_Msg_hier_t *hier = NULL;
+
+  ARMCII_Gop_translate(op, type, &mpi_op, &mpi_type);
   MPI_Type_size(mpi_type, &mpi_type_size);
 
-  ARMCII_Buf_prepare_read_vec(&x, &x_buf, 1, n*mpi_type_size);
+  hdl->request = MPI_REQUEST_NULL;
+  hdl->x       = x;
+  hdl->x_buf   = NULL;
+  hdl->size    = n*mpi_type_size;
+  hdl->result  = 0;
+
+  if (scope == SCOPE_NODE) {
+    comm = ARMCII_Msg_hier_get(group)->node_comm;
+  }
+  else if (scope == SCOPE_MASTERS) {
+    comm = ARMCII_Msg_hier_get(group)->leader_comm;
+
+    /* Only node masters take part in SCOPE_MASTERS */
+    if (comm == MPI_COMM_NULL)
+      return;
+  }
+  else {
+    comm = group->comm;
+
+    /* Large blocking reductions use the two-level algorithm */
+    if (blocking && ARMCII_GLOBAL_STATE.hier_coll_threshold > 0
+        && hdl->size >= ARMCII_GLOBAL_STATE.hier_coll_threshold)
+    {
+      hier = ARMCII_Msg_hier_get(group);
+
+      if (hier->nnodes == 1 || hier->nnodes == group->size)
+        hier = NULL;
+    }
+  }
+
+  MPI_Comm_size(comm, &comm_size);
+  MPI_Comm_rank(comm, &comm_rank);
+
+  hdl->result = !root_only || comm_rank == 0;
+
+  /* Only buffers in shared space need to be staged through a private copy */
+  if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD
+      && gmr_lookup(x, ARMCI_GROUP_WORLD.rank) != NULL)
+  {
+    ARMCII_Buf_prepare_read_vec(&hdl->x, &hdl->x_buf, 1, hdl->size);
+    buf = hdl->x_buf[0];
+  }
+  else
+    buf = x;
 
   // ABS MAX/MIN are unary as well as binary.  We need to also apply abs in the
   // single processor case when reduce would normally just be a no-op.
-  if (group->size == 1 && (mpi_op == MPI_ABSMAX_OP || mpi_op == MPI_ABSMIN_OP)) {
-    ARMCII_Absv_op(x_buf[0], x_buf[0], &n, &mpi_type);
+  if (comm_size == 1 && (mpi_op == ARMCII_Absmax_ops[type] || mpi_op == ARMCII_Absmin_ops[type])) {
+    ARMCII_Absv(buf, n, type);
+  }
+
+  /* Two-level reduction: reduce to the node leader, reduce among leaders,
+     then broadcast within the node unless only the root needs the result.
+     There is more than one node, so the leader reduction applies ABS MAX/MIN
+     to every element.  The root is the leader of its node and the first
+     leader. */
+  else if (hier != NULL) {
+    const int leader = (hier->leader_comm != MPI_COMM_NULL);
+
+    MPI_Reduce(leader ? MPI_IN_PLACE : buf, buf, n, mpi_type, mpi_op, 0, hier->node_comm);
+
+    if (leader && root_only)
+      MPI_Reduce(hdl->result ? MPI_IN_PLACE : buf, buf, n, mpi_type, mpi_op, 0, hier->leader_comm);
+    else if (leader)
+      MPI_Allreduce(MPI_IN_PLACE, buf, n, mpi_type, mpi_op, hier->leader_comm);
+
+    if (!root_only)
+      MPI_Bcast(buf, n, mpi_type, 0, hier->node_comm);
+  }
+
+  else if (root_only && blocking) {
+    MPI_Reduce(hdl->result ? MPI_IN_PLACE : buf, buf, n, mpi_type, mpi_op, 0, comm);
+  }
+
+  else if (root_only) {
+    MPI_Ireduce(hdl->result ? MPI_IN_PLACE : buf, buf, n, mpi_type, mpi_op, 0, comm, &hdl->request);
+  }
+
+  else if (blocking) {
+    MPI_Allreduce(MPI_IN_PLACE, buf, n, mpi_type, mpi_op, comm);
   }
 
   else {
-    out = malloc(n*mpi_type_size);
-    ARMCII_Assert(out != NULL);
+    MPI_Iallreduce(MPI_IN_PLACE, buf, n, mpi_type, mpi_op, comm, &hdl->request);
+  }
+}
 
-    MPI_Allreduce(x_buf[0], out, n, mpi_type, mpi_op, comm);
 
-    ARMCI_Copy(out, x_buf[0], n*mpi_type_size);
-    free(out);
+/** Finish a global operation once its reduction has completed.
+  */
+static void ARMCII_Gop_finish(struct armci_msg_hdl_s *hdl) {
+  if (hdl->x_buf == NULL)
+    return;
+
+  if (hdl->result)
+    ARMCII_Buf_finish_write_vec(&hdl->x, hdl->x_buf, 1, hdl->size);
+  else
+    ARMCII_Buf_finish_read_vec(&hdl->x, hdl->x_buf, 1, hdl->size);
+}
+
+
+/** General ARMCI global operation (reduction).  Collective on group.
+  *
+  * @param[in]    scope Scope in which to perform the GOP
+  * @param[inout] x     Vector of n data elements, contains input and will contain output.
+  * @param[in]    n     Length of x
+  * @param[in]    op    One of '+', '*', 'max', 'min', 'absmax', 'absmin'
+  * @param[in]    type  Data type of x (e.g. ARMCI_INT, ...)
+  * @param[in]    group Group on which to perform the GOP
+  */
+void armci_msg_group_gop_scope(int scope, void *x, int n, char *op, int type, ARMCI_Group *group) {
+  struct armci_msg_hdl_s hdl;
+
+  ARMCII_Gop_start(scope, x, n, op, type, group, &hdl, 1, 0);
+  ARMCII_Gop_finish(&hdl);
+}
+
+
+/** Start a non-blocking global operation (reduction).  Collective on group.
+  * x must not be accessed until the operation is completed by
+  * armci_msg_wait or armci_msg_test.  Always uses a flat reduction for
+  * SCOPE_ALL.
+  *
+  * @param[in]    scope Scope in which to perform the GOP
+  * @param[inout] x     Vector of n data elements, contains input and will contain output.
+  * @param[in]    n     Length of x
+  * @param[in]    op    One of '+', '*', 'max', 'min', 'absmax', 'absmin'
+  * @param[in]    type  Data type of x (e.g. ARMCI_INT, ...)
+  * @param[in]    group Group on which to perform the GOP
+  * @param[out]   hdl   Handle for the operation
+  */
+void armci_msg_group_gop_scope_nb(int scope, void *x, int n, char *op, int type, ARMCI_Group *group,
+                                  armci_msg_hdl_t *hdl) {
+  *hdl = malloc(sizeof(struct armci_msg_hdl_s));
+  ARMCII_Assert(*hdl != NULL);
+
+  ARMCII_Gop_start(scope, x, n, op, type, group, *hdl, 0, 0);
+}
+
+
+/** General ARMCI reduction to a single process.  The result is stored in x
+  * on the first process in the scope: rank 0 of the group for SCOPE_ALL and
+  * SCOPE_MASTERS, and the node master for SCOPE_NODE.  x is unchanged on the
+  * other processes.  Collective on group.
+  *
+  * @param[in]    scope Scope in which to perform the reduction
+  * @param[inout] x     Vector of n data elements, contains input and will contain output on the root.
+  * @param[in]    n     Length of x
+  * @param[in]    op    One of '+', '*', 'max', 'min', 'absmax', 'absmin'
+  * @param[in]    type  Data type of x (e.g. ARMCI_INT, ...)
+  * @param[in]    group Group on which to perform the reduction
+  */
+void armci_msg_group_reduce_scope(int scope, void *x, int n, char *op, int type, ARMCI_Group *group) {
+  struct armci_msg_hdl_s hdl;
+
+  ARMCII_Gop_start(scope, x, n, op, type, group, &hdl, 1, 1);
+  ARMCII_Gop_finish(&hdl);
+}
+
+
+/** Start a non-blocking reduction to a single process.  Collective on group.
+  * x must not be accessed until the operation is completed by
+  * armci_msg_wait or armci_msg_test.  Always uses a flat reduction for
+  * SCOPE_ALL.
+  *
+  * @param[in]    scope Scope in which to perform the reduction
+  * @param[inout] x     Vector of n data elements, contains input and will contain output on the root.
+  * @param[in]    n     Length of x
+  * @param[in]    op    One of '+', '*', 'max', 'min', 'absmax', 'absmin'
+  * @param[in]    type  Data type of x (e.g. ARMCI_INT, ...)
+  * @param[in]    group Group on which to perform the reduction
+  * @param[out]   hdl   Handle for the operation
+  */
+void armci_msg_group_reduce_scope_nb(int scope, void *x, int n, char *op, int type, ARMCI_Group *group,
+                                     armci_msg_hdl_t *hdl) {
+  *hdl = malloc(sizeof(struct armci_msg_hdl_s));
+  ARMCII_Assert(*hdl != NULL);
+
+  ARMCII_Gop_start(scope, x, n, op, type, group, *hdl, 0, 1);
+}
+
+
+/** Wait for a non-blocking global operation to complete.  The handle is freed
+  * and set to NULL.
+  *
+  * @param[inout] hdl Handle for the operation
+  */
+void armci_msg_wait(armci_msg_hdl_t *hdl) {
+  MPI_Wait(&(*hdl)->request, MPI_STATUS_IGNORE);
+  ARMCII_Gop_finish(*hdl);
+
+  free(*hdl);
+  *hdl = NULL;
+}
+
+
+/** Test whether a non-blocking global operation has completed.  If it has,
+  * the handle is freed and set to NULL.
+  *
+  * @param[inout] hdl Handle for the operation
+  * @return           Non-zero if the operation has completed
+  */
+int armci_msg_test(armci_msg_hdl_t *hdl) {
+  int flag;
+
+  MPI_Test(&(*hdl)->request, &flag, MPI_STATUS_IGNORE);
+
+  if (flag) {
+    ARMCII_Gop_finish(*hdl);
+    free(*hdl);
+    *hdl = NULL;
   }
 
-  ARMCII_Buf_finish_write_vec(&x, x_buf, 1, n*mpi_type_size);
+  return flag;
 }
 
 void armci_msg_group_igop(int *x, int n, char *op, ARMCI_Group *group) {
@@ -254,3 +470,40 @@ void armci_msg_dgop(double *x, int n, char *op) {
   armci_msg_gop_scope(SCOPE_ALL, x, n, op, ARMCI_DOUBLE);
 }
 
+
+void armci_msg_gop_scope_nb(int scope, void *x, int n, char *op, int type, armci_msg_hdl_t *hdl) {
+  armci_msg_group_gop_scope_nb(scope, x, n, op, type, &ARMCI_GROUP_WORLD, hdl);
+}
+
+void armci_msg_igop_nb(int *x, int n, char *op, armci_msg_hdl_t *hdl) {
+  armci_msg_gop_scope_nb(SCOPE_ALL, x, n, op, ARMCI_INT, hdl);
+}
+
+void armci_msg_lgop_nb(long *x, int n, char *op, armci_msg_hdl_t *hdl) {
+  armci_msg_gop_scope_nb(SCOPE_ALL, x, n, op, ARMCI_LONG, hdl);
+}
+
+void armci_msg_llgop_nb(long long *x, int n, char *op, armci_msg_hdl_t *hdl) {
+  armci_msg_gop_scope_nb(SCOPE_ALL, x, n, op, ARMCI_LONG_LONG, hdl);
+}
+
+void armci_msg_fgop_nb(float *x, int n, char *op, armci_msg_hdl_t *hdl) {
+  armci_msg_gop_scope_nb(SCOPE_ALL, x, n, op, ARMCI_FLOAT, hdl);
+}
+
+void armci_msg_dgop_nb(double *x, int n, char *op, armci_msg_hdl_t *hdl) {
+  armci_msg_gop_scope_nb(SCOPE_ALL, x, n, op, ARMCI_DOUBLE, hdl);
+}
+
+
+void armci_msg_reduce(void *x, int n, char *op, int type) {
+  armci_msg_reduce_scope(SCOPE_ALL, x, n, op, type);
+}
+
+void armci_msg_reduce_scope(int scope, void *x, int n, char *op, int type) {
+  armci_msg_group_reduce_scope(scope, x, n, op, type, &ARMCI_GROUP_WORLD);
+}
+
+void armci_msg_reduce_scope_nb(int scope, void *x, int n, char *op, int type, armci_msg_hdl_t *hdl) {
+  armci_msg_group_reduce_scope_nb(scope, x, n, op, type, &ARMCI_GROUP_WORLD, hdl);
+}
@@ -37,11 +37,15 @@ static armcix_mutex_hdl_t armci_mutex_hdl = NULL;
   * @param[in] count Number of mutexes to create on the calling process
   */
 int PARMCI_Create_mutexes(int count) {
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Create_mutexes);
+
   if (armci_mutex_hdl != NULL)
     ARMCII_Error("attempted to create ARMCI mutexes multiple times");
 
   armci_mutex_hdl = ARMCIX_Create_mutexes_hdl(count, &ARMCI_GROUP_WORLD);
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Create_mutexes);
+
   if (armci_mutex_hdl != NULL)
     return 0;
   else
@@ -64,12 +68,16 @@ int PARMCI_Create_mutexes(int count) {
 int PARMCI_Destroy_mutexes(void) {
   int err;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Destroy_mutexes);
+
   if (armci_mutex_hdl == NULL)
     ARMCII_Error("attempted to free unallocated ARMCI mutexes");
   
   err = ARMCIX_Destroy_mutexes_hdl(armci_mutex_hdl);
   armci_mutex_hdl = NULL;
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Destroy_mutexes);
+
   return err;
 }
 
@@ -90,10 +98,15 @@ int PARMCI_Destroy_mutexes(void) {
   * @param[in] proc  Target process for the lock operation
   */
 void PARMCI_Lock(int mutex, int proc) {
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Lock);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Lock, proc, 0);
+
   if (armci_mutex_hdl == NULL)
     ARMCII_Error("attempted to lock on unallocated ARMCI mutexes");
   
   ARMCIX_Lock_hdl(armci_mutex_hdl, mutex, proc);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Lock);
 }
 
 
@@ -113,8 +126,13 @@ void PARMCI_Lock(int mutex, int proc) {
   * @param[in] proc  Target process for the unlock operation
   */
 void PARMCI_Unlock(int mutex, int proc) {
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Unlock);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Unlock, proc, 0);
+
   if (armci_mutex_hdl == NULL)
     ARMCII_Error("attempted to unlock on unallocated ARMCI mutexes");
   
   ARMCIX_Unlock_hdl(armci_mutex_hdl, mutex, proc);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Unlock);
 }
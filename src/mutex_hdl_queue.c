@@ -2,8 +2,47 @@
  * Copyright (C) 2010. See COPYRIGHT in top-level directory.
  */
 
+/* These mutexes are MCS queue locks built on MPI-3 atomics.  All mutexes in a
+ * group live in a single window that is locked with lock_all for the lifetime
+ * of the group.  Each process exposes a pool of queue nodes; a queue node is
+ * named by an integer code built from its rank, slot and generation (see
+ * MCS_CODE), with 0 meaning none.
+ *
+ * function lock(mutex, p):
+ *
+ *   me.locked = 1, me.next = 0
+ *   pred = fetch_and_op(tail(mutex, p), REPLACE, me)
+ *   if (pred != 0) {
+ *     pred.next = me
+ *     while (me.locked) ;    // Spin locally on my own queue node
+ *   }
+ *
+ * function unlock(mutex, p):
+ *
+ *   if (me.next == 0) {
+ *     if (compare_and_swap(tail(mutex, p), me, 0) == me) return
+ *     while (me.next == 0) ;
+ *   }
+ *   me.next.locked = 0
+ *
+ * Acquire and release take O(1) remote operations, and trylock is a single
+ * compare-and-swap on the tail.
+ *
+ * In biased mode (ARMCI_MUTEX_BIASED), unlock leaves the holder's queue node
+ * in the queue and marks it CACHED, so that the holder can take the mutex
+ * back by swapping its own node from CACHED to HELD.  A process that queues
+ * up behind a CACHED node revokes it by swapping it to REVOKED, and then holds
+ * the mutex without waiting.  Trylock revokes through the intermediate
+ * REVOKING state, because it may have to pass the mutex on to a process that
+ * queued up behind the revoked node.  The holder reclaims a revoked node once
+ * it sees it REVOKED.  Queue node codes and bias words carry the generation of
+ * the node, so that a late revocation cannot hit a node that has since been
+ * reused.
+ */
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <mpi.h>
 
 #include <armci.h>
@@ -11,9 +50,249 @@
 #include <armcix.h>
 #include <debug.h>
 
-#define ARMCI_MUTEX_TAG 100
+/* The number of queue nodes per process (hdl->nqnodes, set by
+ * ARMCI_MUTEX_QNODES) bounds the number of mutexes a process can hold, wait
+ * for or keep cached at once within one mutex group */
+#define MCS_GEN_BITS     6
+#define MCS_GEN_MASK     ((1 << MCS_GEN_BITS) - 1)
+
+/* Queue node layout, following the tails of the process' mutexes */
+#define MCS_LOCKED       0
+#define MCS_NEXT         1
+#define MCS_BIAS         2
+#define MCS_QNODE_SIZE   3
+
+#define MCS_CODE(hdl, rank, slot, gen) (((((rank)*(hdl)->nqnodes + (slot)) << MCS_GEN_BITS) | (gen)) + 1)
+#define MCS_RANK(hdl, code)   ((((code) - 1) >> MCS_GEN_BITS) / (hdl)->nqnodes)
+#define MCS_SLOT(hdl, code)   ((((code) - 1) >> MCS_GEN_BITS) % (hdl)->nqnodes)
+#define MCS_GEN(code)         (((code) - 1) & MCS_GEN_MASK)
+
+/* The bias word of a queue node holds its generation and one of these states */
+enum { MCS_BIAS_HELD = 0, MCS_BIAS_CACHED, MCS_BIAS_REVOKING, MCS_BIAS_REVOKED };
+
+#define MCS_BIAS_WORD(gen, state) (((gen) << 2) | (state))
+#define MCS_BIAS_STATE(word)      ((word) & 3)
+
+/* Local states of a queue node in the table of held mutexes */
+enum { MCS_SLOT_FREE = 0, MCS_SLOT_HELD, MCS_SLOT_CACHED, MCS_SLOT_ZOMBIE };
+
+/* The table holds the mutex, process, state and generation of each queue
+ * node, followed by the slot at which to start looking for a free node */
+#define MCS_HELD_SIZE         4
+#define MCS_MUTEX(hdl, slot)  ((hdl)->held[MCS_HELD_SIZE*(slot)])
+#define MCS_PROC(hdl, slot)   ((hdl)->held[MCS_HELD_SIZE*(slot)+1])
+#define MCS_STATE(hdl, slot)  ((hdl)->held[MCS_HELD_SIZE*(slot)+2])
+#define MCS_SGEN(hdl, slot)   ((hdl)->held[MCS_HELD_SIZE*(slot)+3])
+#define MCS_CURSOR(hdl)       ((hdl)->held[MCS_HELD_SIZE*(hdl)->nqnodes])
+
+
+/** Displacement of a queue node field in the mutex window.
+  */
+static MPI_Aint mcs_qnode_disp(armcix_mutex_hdl_t hdl, int slot, int field) {
+  return hdl->max_count + slot*MCS_QNODE_SIZE + field;
+}
+
+
+/** Atomically read an integer in the mutex window.
+  */
+static int mcs_read(armcix_mutex_hdl_t hdl, int proc, MPI_Aint disp) {
+  int val, dummy = 0;
+
+  MPI_Fetch_and_op(&dummy, &val, MPI_INT, proc, disp, MPI_NO_OP, hdl->window);
+  MPI_Win_flush(proc, hdl->window);
+
+  return val;
+}
+
+
+/** Atomically write an integer in the mutex window.
+  */
+static void mcs_write(armcix_mutex_hdl_t hdl, int proc, MPI_Aint disp, int val) {
+  MPI_Accumulate(&val, 1, MPI_INT, proc, disp, 1, MPI_INT, MPI_REPLACE, hdl->window);
+  MPI_Win_flush(proc, hdl->window);
+}
+
+
+/** Atomically compare-and-swap an integer in the mutex window and return its
+  * old value.
+  */
+static int mcs_cas(armcix_mutex_hdl_t hdl, int proc, MPI_Aint disp, int cmp, int val) {
+  int out;
+
+  MPI_Compare_and_swap(&val, &cmp, &out, MPI_INT, proc, disp, hdl->window);
+  MPI_Win_flush(proc, hdl->window);
+
+  return out;
+}
+
+
+/** Return a queue node to the pool.
+  */
+static void mcs_slot_free(armcix_mutex_hdl_t hdl, int slot) {
+  MCS_MUTEX(hdl, slot) = -1;
+  MCS_PROC(hdl, slot)  = -1;
+  MCS_STATE(hdl, slot) = MCS_SLOT_FREE;
+}
+
+
+/** Find the queue node used for a mutex, or -1 if there is none.
+  */
+static int mcs_slot_find(armcix_mutex_hdl_t hdl, int mutex, int proc) {
+  int slot;
+
+  for (slot = 0; slot < hdl->nqnodes; slot++)
+    if (MCS_MUTEX(hdl, slot) == mutex && MCS_PROC(hdl, slot) == proc &&
+        (MCS_STATE(hdl, slot) == MCS_SLOT_HELD || MCS_STATE(hdl, slot) == MCS_SLOT_CACHED))
+      return slot;
+
+  return -1;
+}
+
+
+/** Pass a held mutex on to my successor, or mark its queue empty.
+  */
+static void mcs_release(armcix_mutex_hdl_t hdl, int slot, int mutex, int proc) {
+  const int me = MCS_CODE(hdl, hdl->grp.rank, slot, MCS_SGEN(hdl, slot));
+  int next, tail;
+
+  next = mcs_read(hdl, hdl->grp.rank, mcs_qnode_disp(hdl, slot, MCS_NEXT));
+
+  if (next == 0) {
+    /* No known successor: try to mark the queue empty */
+    tail = mcs_cas(hdl, proc, mutex, me, 0);
+
+    /* A successor has enqueued itself: wait for it to link behind me */
+    if (tail != me) {
+      while ((next = mcs_read(hdl, hdl->grp.rank, mcs_qnode_disp(hdl, slot, MCS_NEXT))) == 0)
+        ;
+    }
+  }
+
+  if (next != 0) {
+    ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "notifying %d [proc = %d, mutex = %d]\n", MCS_RANK(hdl, next), proc, mutex);
+    mcs_write(hdl, MCS_RANK(hdl, next), mcs_qnode_disp(hdl, MCS_SLOT(hdl, next), MCS_LOCKED), 0);
+  }
+}
+
+
+/** Take back a cached mutex.  Returns 1 on success; otherwise the mutex was
+  * revoked and the queue node is released or left as a zombie until the
+  * revoking process is done with it.
+  */
+static int mcs_reclaim(armcix_mutex_hdl_t hdl, int slot) {
+  const int gen  = MCS_SGEN(hdl, slot);
+  const int bias = mcs_cas(hdl, hdl->grp.rank, mcs_qnode_disp(hdl, slot, MCS_BIAS),
+                           MCS_BIAS_WORD(gen, MCS_BIAS_CACHED), MCS_BIAS_WORD(gen, MCS_BIAS_HELD));
+
+  if (MCS_BIAS_STATE(bias) == MCS_BIAS_CACHED) {
+    MCS_STATE(hdl, slot) = MCS_SLOT_HELD;
+    return 1;
+  }
+
+  if (MCS_BIAS_STATE(bias) == MCS_BIAS_REVOKED)
+    mcs_slot_free(hdl, slot);
+  else
+    MCS_STATE(hdl, slot) = MCS_SLOT_ZOMBIE;
+
+  return 0;
+}
+
+
+/** Make room in the queue node pool by releasing cached mutexes and
+  * collecting zombies.
+  */
+static void mcs_slot_collect(armcix_mutex_hdl_t hdl) {
+  int slot;
+
+  for (slot = 0; slot < hdl->nqnodes; slot++) {
+    const int mutex = MCS_MUTEX(hdl, slot);
+    const int proc  = MCS_PROC(hdl, slot);
+
+    if (MCS_STATE(hdl, slot) == MCS_SLOT_CACHED) {
+      if (mcs_reclaim(hdl, slot)) {
+        mcs_release(hdl, slot, mutex, proc);
+        mcs_slot_free(hdl, slot);
+      }
+    }
+    else if (MCS_STATE(hdl, slot) == MCS_SLOT_ZOMBIE) {
+      if (MCS_BIAS_STATE(mcs_read(hdl, hdl->grp.rank, mcs_qnode_disp(hdl, slot, MCS_BIAS))) == MCS_BIAS_REVOKED)
+        mcs_slot_free(hdl, slot);
+    }
+  }
+}
+
+
+/** Take a free queue node, prepare it for enqueueing and record the mutex it
+  * is used for.  Free nodes are taken round-robin, so that a node is reused
+  * as rarely as possible.
+  */
+static int mcs_qnode_init(armcix_mutex_hdl_t hdl, int mutex, int proc) {
+  int slot = -1, pass, i;
+
+  for (pass = 0; pass < 2 && slot < 0; pass++) {
+    for (i = 0; i < hdl->nqnodes; i++) {
+      const int s = (MCS_CURSOR(hdl) + i) % hdl->nqnodes;
+
+      if (MCS_STATE(hdl, s) == MCS_SLOT_FREE) {
+        slot = s;
+        break;
+      }
+    }
+
+    if (slot < 0)
+      mcs_slot_collect(hdl);
+  }
+
+  if (slot < 0)
+    ARMCII_Error("too many mutexes held at once (max %d, see ARMCI_MUTEX_QNODES)", hdl->nqnodes);
+
+  MCS_CURSOR(hdl)      = (slot + 1) % hdl->nqnodes;
+  MCS_MUTEX(hdl, slot) = mutex;
+  MCS_PROC(hdl, slot)  = proc;
+  MCS_STATE(hdl, slot) = MCS_SLOT_HELD;
+  MCS_SGEN(hdl, slot)  = (MCS_SGEN(hdl, slot) + 1) & MCS_GEN_MASK;
+
+  mcs_write(hdl, hdl->grp.rank, mcs_qnode_disp(hdl, slot, MCS_LOCKED), 1);
+  mcs_write(hdl, hdl->grp.rank, mcs_qnode_disp(hdl, slot, MCS_NEXT), 0);
+
+  if (hdl->biased)
+    mcs_write(hdl, hdl->grp.rank, mcs_qnode_disp(hdl, slot, MCS_BIAS),
+              MCS_BIAS_WORD(MCS_SGEN(hdl, slot), MCS_BIAS_HELD));
+
+  return slot;
+}
+
+
+/** Try to revoke the cached ownership of the queue node with the given code.
+  * Returns 1 if the node was CACHED and is now in the given state.
+  */
+static int mcs_revoke(armcix_mutex_hdl_t hdl, int code, int state) {
+  const int gen = MCS_GEN(code);
+
+  return MCS_BIAS_CACHED == MCS_BIAS_STATE(
+      mcs_cas(hdl, MCS_RANK(hdl, code), mcs_qnode_disp(hdl, MCS_SLOT(hdl, code), MCS_BIAS),
+              MCS_BIAS_WORD(gen, MCS_BIAS_CACHED), MCS_BIAS_WORD(gen, state)));
+}
+
+
+/** Try to take a mutex back from my cache.  Returns 1 if I hold it.
+  */
+static int mcs_try_cached(armcix_mutex_hdl_t hdl, int mutex, int proc) {
+  int slot;
+
+  if (!hdl->biased)
+    return 0;
+
+  slot = mcs_slot_find(hdl, mutex, proc);
+
+  if (slot >= 0 && MCS_STATE(hdl, slot) == MCS_SLOT_CACHED && mcs_reclaim(hdl, slot)) {
+    ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "lock reacquired from cache [proc = %d, mutex = %d]\n", proc, mutex);
+    return 1;
+  }
+
+  return 0;
+}
 
-/* TODO: Make these all no-ops for sequential runs */
 
 /** Create a group of ARMCI mutexes.  Collective onthe ARMCI group.
   *
@@ -22,7 +301,7 @@
   * @return           Handle to the mutex group.
   */
 armcix_mutex_hdl_t ARMCIX_Create_mutexes_hdl(int my_count, ARMCI_Group *pgroup) {
-  int rank, nproc, max_count, i;
+  int max_count, sizes[2], i;
   armcix_mutex_hdl_t hdl;
 
   hdl = malloc(sizeof(struct armcix_mutex_hdl_s));
@@ -30,42 +309,43 @@ armcix_mutex_hdl_t ARMCIX_Create_mutexes_hdl(int my_count, ARMCI_Group *pgroup)
 
   ARMCIX_Group_dup(pgroup, &hdl->grp);
 
-  MPI_Comm_rank(hdl->grp.comm, &rank);
-  MPI_Comm_size(hdl->grp.comm, &nproc);
-
   hdl->my_count = my_count;
-
-  /* Find the max. count to determine how many windows we need. */
-  MPI_Allreduce(&my_count, &max_count, 1, MPI_INT, MPI_MAX, hdl->grp.comm);
+  hdl->biased   = ARMCII_GLOBAL_STATE.mutex_biased;
+
+  /* Every process uses the same layout so that queue nodes can be found
+     without communication: max_count tails followed by the queue nodes. */
+  sizes[0] = my_count;
+  sizes[1] = ARMCII_GLOBAL_STATE.mutex_qnodes;
+  MPI_Allreduce(MPI_IN_PLACE, sizes, 2, MPI_INT, MPI_MAX, hdl->grp.comm);
+  max_count = sizes[0];
   ARMCII_Assert_msg(max_count > 0, "Invalid number of mutexes");
 
   hdl->max_count = max_count;
-  hdl->windows = malloc(sizeof(MPI_Win)*max_count);
+  hdl->nqnodes   = sizes[1];
 
-  if (my_count > 0) {
-    hdl->bases = malloc(sizeof(uint8_t*)*my_count);
-  } else {
-    hdl->bases = NULL;
-  }
+  MPI_Win_allocate((max_count + hdl->nqnodes*MCS_QNODE_SIZE)*sizeof(int), sizeof(int), MPI_INFO_NULL,
+                   hdl->grp.comm, &hdl->base, &hdl->window);
 
-  /* We need multiple windows here: one for each mutex.  Otherwise
-     performance will suffer due to exclusive access epochs. */
-  for (i = 0; i < max_count; i++) {
-    int   size = 0;
-    void *base = NULL;
+  for (i = 0; i < max_count + hdl->nqnodes*MCS_QNODE_SIZE; i++)
+    hdl->base[i] = 0;
 
-    if (i < my_count) {
-      MPI_Alloc_mem(nproc, MPI_INFO_NULL, &hdl->bases[i]);
-      ARMCII_Assert(hdl->bases[i] != NULL);
-      ARMCII_Bzero(hdl->bases[i], nproc);
+  ARMCII_Assert_msg(hdl->grp.size <= (INT_MAX >> MCS_GEN_BITS) / hdl->nqnodes - 1,
+                    "Too many processes for queue mutexes");
 
-      base = hdl->bases[i];
-      size = nproc;
-    }
+  hdl->held = malloc((MCS_HELD_SIZE*hdl->nqnodes + 1)*sizeof(int));
+  ARMCII_Assert(hdl->held != NULL);
 
-    MPI_Win_create(base, size, sizeof(uint8_t), MPI_INFO_NULL, hdl->grp.comm, &hdl->windows[i]);
+  for (i = 0; i < hdl->nqnodes; i++) {
+    mcs_slot_free(hdl, i);
+    MCS_SGEN(hdl, i) = 0;
   }
 
+  MCS_CURSOR(hdl) = 0;
+
+  MPI_Win_lock_all(0, hdl->window);
+  MPI_Win_sync(hdl->window);
+  MPI_Barrier(hdl->grp.comm);
+
   return hdl;
 }
 
@@ -76,21 +356,11 @@ armcix_mutex_hdl_t ARMCIX_Create_mutexes_hdl(int my_count, ARMCI_Group *pgroup)
   * @return        Zero on success, non-zero otherwise.
   */
 int ARMCIX_Destroy_mutexes_hdl(armcix_mutex_hdl_t hdl) {
-  int i;
-
-  for (i = 0; i < hdl->max_count; i++) {
-    MPI_Win_free(&hdl->windows[i]);
-  }
-    
-  if (hdl->bases != NULL) {
-    for (i = 0; i < hdl->my_count; i++)
-      MPI_Free_mem(hdl->bases[i]);
-
-    free(hdl->bases);
-  }
+  MPI_Win_unlock_all(hdl->window);
+  MPI_Win_free(&hdl->window);
 
   ARMCI_Group_free(&hdl->grp);
-  free(hdl->windows);
+  free(hdl->held);
   free(hdl);
 
   return 0;
@@ -98,132 +368,144 @@ int ARMCIX_Destroy_mutexes_hdl(armcix_mutex_hdl_t hdl) {
 
 
 /** Lock a mutex.
-  * 
+  *
   * @param[in] hdl        Mutex group that the mutex belongs to.
   * @param[in] mutex      Desired mutex number [0..count-1]
   * @param[in] world_proc Absolute ID of process where the mutex lives
   */
 void ARMCIX_Lock_hdl(armcix_mutex_hdl_t hdl, int mutex, int world_proc) {
-  int       rank, nproc, already_locked, i, proc;
-  uint8_t *buf;
+  int proc, slot, me, pred;
 
   ARMCII_Assert(mutex >= 0 && mutex < hdl->max_count);
 
-  MPI_Comm_rank(hdl->grp.comm, &rank);
-  MPI_Comm_size(hdl->grp.comm, &nproc);
-
   /* User gives us the absolute ID.  Translate to the rank in the mutex's group. */
   proc = ARMCII_Translate_absolute_to_group(&hdl->grp, world_proc);
   ARMCII_Assert(proc >= 0);
 
-  buf = malloc(nproc*sizeof(uint8_t));
-  ARMCII_Assert(buf != NULL);
+  if (mcs_try_cached(hdl, mutex, proc))
+    return;
 
-  buf[rank] = 1;
+  slot = mcs_qnode_init(hdl, mutex, proc);
+  me   = MCS_CODE(hdl, hdl->grp.rank, slot, MCS_SGEN(hdl, slot));
 
-  /* Get all data from the lock_buf, except the byte belonging to
-   * me. Set the byte belonging to me to 1. */
-  MPI_Win_lock(MPI_LOCK_EXCLUSIVE, proc, 0, hdl->windows[mutex]);
-  
-  MPI_Put(&buf[rank], 1, MPI_BYTE, proc, rank, 1, MPI_BYTE, hdl->windows[mutex]);
+  /* Append my queue node to the tail of the queue */
+  MPI_Fetch_and_op(&me, &pred, MPI_INT, proc, mutex, MPI_REPLACE, hdl->window);
+  MPI_Win_flush(proc, hdl->window);
 
-  /* Get data to the left of rank */
-  if (rank > 0) {
-    MPI_Get(buf, rank, MPI_BYTE, proc, 0, rank, MPI_BYTE, hdl->windows[mutex]);
-  }
-
-  /* Get data to the right of rank */
-  if (rank < nproc - 1) {
-    MPI_Get(&buf[rank+1], nproc-1-rank, MPI_BYTE, proc, rank + 1, nproc-1-rank, MPI_BYTE, hdl->windows[mutex]);
-  }
-  
-  MPI_Win_unlock(proc, hdl->windows[mutex]);
+  /* Link behind my predecessor and wait for it to hand the mutex over */
+  if (pred != 0) {
+    mcs_write(hdl, MCS_RANK(hdl, pred), mcs_qnode_disp(hdl, MCS_SLOT(hdl, pred), MCS_NEXT), me);
 
-  ARMCII_Assert(buf[rank] == 1);
-
-  for (i = already_locked = 0; i < nproc; i++)
-    if (buf[i] && i != rank)
-      already_locked = 1;
+    /* An idle predecessor that kept the mutex cached loses it to me */
+    if (hdl->biased && mcs_revoke(hdl, pred, MCS_BIAS_REVOKED)) {
+      ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "revoked from %d [proc = %d, mutex = %d]\n", MCS_RANK(hdl, pred), proc, mutex);
+    }
+    else {
+      ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "waiting for notification [proc = %d, mutex = %d]\n", proc, mutex);
 
-  /* Wait for notification */
-  if (already_locked) {
-    MPI_Status status;
-    ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "waiting for notification [proc = %d, mutex = %d]\n", proc, mutex);
-    MPI_Recv(NULL, 0, MPI_BYTE, MPI_ANY_SOURCE, ARMCI_MUTEX_TAG+mutex, hdl->grp.comm, &status);
+      while (mcs_read(hdl, hdl->grp.rank, mcs_qnode_disp(hdl, slot, MCS_LOCKED)) != 0)
+        ;
+    }
   }
 
   ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "lock acquired [proc = %d, mutex = %d]\n", proc, mutex);
-  free(buf);
 }
 
 
-/** Attempt to lock a mutex (implemented as a blocking call).
-  * 
+/** Attempt to lock a mutex.  Returns immediately if the mutex is held or
+  * contended.
+  *
   * @param[in] hdl   Mutex group that the mutex belongs to.
   * @param[in] mutex Desired mutex number [0..count-1]
   * @param[in] world_proc Absolute ID of process where the mutex lives
   * @return          0 on success, non-zero on failure
   */
 int ARMCIX_Trylock_hdl(armcix_mutex_hdl_t hdl, int mutex, int world_proc) {
+  int proc, slot, me, pred, tail, next;
+
   ARMCII_Assert(mutex >= 0 && mutex < hdl->max_count);
 
-  ARMCIX_Lock_hdl(hdl, mutex, world_proc);
-  return 0;
+  proc = ARMCII_Translate_absolute_to_group(&hdl->grp, world_proc);
+  ARMCII_Assert(proc >= 0);
+
+  if (mcs_try_cached(hdl, mutex, proc))
+    return 0;
+
+  slot = mcs_qnode_init(hdl, mutex, proc);
+  me   = MCS_CODE(hdl, hdl->grp.rank, slot, MCS_SGEN(hdl, slot));
+
+  /* Enqueue only if the queue is empty */
+  pred = mcs_cas(hdl, proc, mutex, 0, me);
+
+  if (pred == 0) {
+    ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "lock acquired [proc = %d, mutex = %d]\n", proc, mutex);
+    return 0;
+  }
+
+  /* The mutex may be held by an idle process that kept it cached */
+  if (hdl->biased && mcs_revoke(hdl, pred, MCS_BIAS_REVOKING)) {
+    /* I now hold the mutex in place of my predecessor: replace it as the tail */
+    tail = mcs_cas(hdl, proc, mutex, pred, me);
+
+    if (tail != pred) {
+      /* Others queued up behind the revoked node: pass the mutex on */
+      while ((next = mcs_read(hdl, MCS_RANK(hdl, pred), mcs_qnode_disp(hdl, MCS_SLOT(hdl, pred), MCS_NEXT))) == 0)
+        ;
+
+      mcs_write(hdl, MCS_RANK(hdl, next), mcs_qnode_disp(hdl, MCS_SLOT(hdl, next), MCS_LOCKED), 0);
+    }
+
+    mcs_write(hdl, MCS_RANK(hdl, pred), mcs_qnode_disp(hdl, MCS_SLOT(hdl, pred), MCS_BIAS),
+              MCS_BIAS_WORD(MCS_GEN(pred), MCS_BIAS_REVOKED));
+
+    if (tail == pred) {
+      ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "lock acquired by revocation [proc = %d, mutex = %d]\n", proc, mutex);
+      return 0;
+    }
+  }
+
+  mcs_slot_free(hdl, slot);
+  return 1;
 }
 
 
 /** Unlock a mutex.
-  * 
+  *
   * @param[in] hdl   Mutex group that the mutex belongs to.
   * @param[in] mutex Desired mutex number [0..count-1]
   * @param[in] world_proc Absolute ID of process where the mutex lives
   */
 void ARMCIX_Unlock_hdl(armcix_mutex_hdl_t hdl, int mutex, int world_proc) {
-  int      rank, nproc, i, proc;
-  uint8_t *buf;
+  int proc, slot;
 
   ARMCII_Assert(mutex >= 0 && mutex < hdl->max_count);
 
-  MPI_Comm_rank(hdl->grp.comm, &rank);
-  MPI_Comm_size(hdl->grp.comm, &nproc);
-
   proc = ARMCII_Translate_absolute_to_group(&hdl->grp, world_proc);
   ARMCII_Assert(proc >= 0);
 
-  buf = malloc(nproc*sizeof(uint8_t));
-
-  buf[rank] = 0;
+  slot = mcs_slot_find(hdl, mutex, proc);
 
-  /* Get all data from the lock_buf, except the byte belonging to
-   * me. Set the byte belonging to me to 0. */
-  MPI_Win_lock(MPI_LOCK_EXCLUSIVE, proc, 0, hdl->windows[mutex]);
-  
-  MPI_Put(&buf[rank], 1, MPI_BYTE, proc, rank, 1, MPI_BYTE, hdl->windows[mutex]);
+  if (slot < 0 || MCS_STATE(hdl, slot) != MCS_SLOT_HELD)
+    ARMCII_Error("attempted to unlock a mutex that is not held [proc = %d, mutex = %d]", proc, mutex);
 
-  /* Get data to the left of rank */
-  if (rank > 0) {
-    MPI_Get(buf, rank, MPI_BYTE, proc, 0, rank, MPI_BYTE, hdl->windows[mutex]);
-  }
+  if (hdl->biased) {
+    /* Keep the mutex unless a successor has already linked behind me.  A
+       successor that links after the check revokes the cached node. */
+    mcs_write(hdl, hdl->grp.rank, mcs_qnode_disp(hdl, slot, MCS_BIAS),
+              MCS_BIAS_WORD(MCS_SGEN(hdl, slot), MCS_BIAS_CACHED));
+    MCS_STATE(hdl, slot) = MCS_SLOT_CACHED;
 
-  /* Get data to the right of rank */
-  if (rank < nproc - 1) {
-    MPI_Get(&buf[rank+1], nproc-1-rank, MPI_BYTE, proc, rank + 1, nproc-1-rank, MPI_BYTE, hdl->windows[mutex]);
-  }
-  
-  MPI_Win_unlock(proc, hdl->windows[mutex]);
-
-  ARMCII_Assert(buf[rank] == 0);
-
-  /* Notify the next waiting process, starting to my right for fairness */
-  for (i = 1; i < nproc; i++) {
-    int p = (rank + i) % nproc;
-    if (buf[p] == 1) {
-      ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "notifying %d [proc = %d, mutex = %d]\n", p, proc, mutex);
-      MPI_Send(NULL, 0, MPI_BYTE, p, ARMCI_MUTEX_TAG+mutex, hdl->grp.comm);
-      break;
+    if (mcs_read(hdl, hdl->grp.rank, mcs_qnode_disp(hdl, slot, MCS_NEXT)) == 0) {
+      ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "lock cached [proc = %d, mutex = %d]\n", proc, mutex);
+      return;
     }
+
+    if (!mcs_reclaim(hdl, slot))
+      return;
   }
 
+  mcs_release(hdl, slot, mutex, proc);
+  mcs_slot_free(hdl, slot);
+
   ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "lock released [proc = %d, mutex = %d]\n", proc, mutex);
-  free(buf);
 }
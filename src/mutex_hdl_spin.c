@@ -2,32 +2,29 @@
  * Copyright (C) 2010. See COPYRIGHT in top-level directory.
  */
 
-/* These mutexes are built using only MPI-2 atomic accumulate.  The only
- * drawback is that they are vulnerable to livelock.  Here's how the lock
- * algorithm works:
- *
- * Let mutex be an integer that is initially 0.  I hold the mutex when after
- * adding my rank to it, it is equal to my rank.
+/* These mutexes are ticket locks built on MPI-3 atomics.  All mutexes in a
+ * group live in a single window that is locked with lock_all for the lifetime
+ * of the group.  Each mutex is a pair of unsigned integers, the next ticket
+ * and the ticket now being served:
  *
  * function lock(mutex, p):
  *
- *   acc(mutex, p, me)      // mutex = mutex + me
- *
- *   while (get(mutex, p) != me) {
- *     acc(mutex, p, -1*me) // -1*me is the value to be accumulated
- *     sleep(random)        // Try to avoid livelock/do some backoff
- *     acc(mutex, p, me)
+ *   (ticket, serving) = get_accumulate(mutex, p, SUM, (1, 0))
+ *   while (serving != ticket) {
+ *     delay(ticket - serving)
+ *     serving = get(mutex.serving, p)
  *   }
  *
  * function unlock(mutex, p)
- *   acc(mutex, p, -1*me)
+ *   acc(mutex.serving, p, 1)
+ *
+ * Acquiring an uncontended mutex takes a single atomic operation, and waiting
+ * processes are served in FIFO order.  Waiters back off in proportion to their
+ * distance from the head of the queue (see ARMCII_Backoff).
  */
 
-// TODO: Should each mutex be in a different window?
-
 #include <stdio.h>
 #include <stdlib.h>
-#include <unistd.h>
 #include <mpi.h>
 
 #include <debug.h>
@@ -35,41 +32,59 @@
 #include <armcix.h>
 #include <armci_internals.h>
 
-#define MAX_TIMEOUT 1000
-#define TIMEOUT_MUL 2
-#define MIN(A,B) (((A) < (B)) ? (A) : (B))
+
+/* Layout of each mutex in the window */
+#define TICKET_NEXT         0
+#define TICKET_SERVING      1
+#define TICKET_NWORDS       2
+
+
+/** Atomically read the ticket now being served.
+  */
+static unsigned ticket_serving(armcix_mutex_hdl_t hdl, int mutex, int proc) {
+  unsigned out, dummy = 0;
+
+  MPI_Fetch_and_op(&dummy, &out, MPI_UNSIGNED, proc, mutex*TICKET_NWORDS + TICKET_SERVING,
+                   MPI_NO_OP, hdl->window);
+  MPI_Win_flush(proc, hdl->window);
+
+  return out;
+}
 
 
 /** Create a mutex group.  Collective.
   *
-  * @param[in] count Number of mutexes to create on the calling process
-  * @return          Handle to the mutex group
+  * @param[in] count  Number of mutexes to create on the calling process
+  * @param[in] pgroup ARMCI group on which to create mutexes
+  * @return           Handle to the mutex group
   */
 armcix_mutex_hdl_t ARMCIX_Create_mutexes_hdl(int count, ARMCI_Group *pgroup) {
-  int         ierr, i;
+  int i, max_count;
   armcix_mutex_hdl_t hdl;
 
   hdl = malloc(sizeof(struct armcix_mutex_hdl_s));
   ARMCII_Assert(hdl != NULL);
 
-  MPI_Comm_dup(pgroup->comm, &hdl->comm);
+  ARMCIX_Group_dup(pgroup, &hdl->grp);
 
-  if (count > 0) {
-    MPI_Alloc_mem(count*sizeof(long), MPI_INFO_NULL, &hdl->base);
-    ARMCII_Assert(hdl->base != NULL);
-  } else {
-    hdl->base = NULL;
-  }
+  MPI_Allreduce(&count, &max_count, 1, MPI_INT, MPI_MAX, hdl->grp.comm);
+  ARMCII_Assert_msg(max_count > 0, "Invalid number of mutexes");
 
-  hdl->count = count;
+  hdl->my_count  = count;
+  hdl->max_count = max_count;
+  hdl->held      = NULL;
+  hdl->biased    = 0;
+
+  MPI_Win_allocate(count*TICKET_NWORDS*sizeof(int), sizeof(int) /* displacement size */, MPI_INFO_NULL,
+                   hdl->grp.comm, &hdl->base, &hdl->window);
 
   // Initialize mutexes to 0
-  for (i = 0; i < count; i++)
+  for (i = 0; i < count*TICKET_NWORDS; i++)
     hdl->base[i] = 0;
 
-  ierr = MPI_Win_create(hdl->base, count*sizeof(long), sizeof(long) /* displacement size */,
-                        MPI_INFO_NULL, hdl->comm, &hdl->window);
-  ARMCII_Assert(ierr == MPI_SUCCESS);
+  MPI_Win_lock_all(0, hdl->window);
+  MPI_Win_sync(hdl->window);
+  MPI_Barrier(hdl->grp.comm);
 
   return hdl;
 }
@@ -80,13 +95,10 @@ armcix_mutex_hdl_t ARMCIX_Create_mutexes_hdl(int count, ARMCI_Group *pgroup) {
   * @param[in] hdl Group to destroy
   */
 int ARMCIX_Destroy_mutexes_hdl(armcix_mutex_hdl_t hdl) {
+  MPI_Win_unlock_all(hdl->window);
   MPI_Win_free(&hdl->window);
-  
-  if (hdl->base) 
-    MPI_Free_mem(hdl->base);
-
-  MPI_Comm_free(&hdl->comm);
 
+  ARMCI_Group_free(&hdl->grp);
   free(hdl);
   
   return 0;
@@ -100,54 +112,27 @@ int ARMCIX_Destroy_mutexes_hdl(armcix_mutex_hdl_t hdl) {
   * @param[in] world_proc  Absolute ID of process where the mutex lives
   */
 void ARMCIX_Lock_hdl(armcix_mutex_hdl_t hdl, int mutex, int world_proc) {
-  int       rank, nproc, proc;
-  long      lock_val, unlock_val, lock_out;
-  int       timeout = 1;
+  int       proc;
+  unsigned  take[TICKET_NWORDS] = { 1, 0 }, out[TICKET_NWORDS], serving;
 
-  MPI_Comm_rank(hdl->comm, &rank);
-  MPI_Comm_size(hdl->comm, &nproc);
+  ARMCII_Assert(mutex >= 0 && mutex < hdl->max_count);
 
   /* User gives us the absolute ID.  Translate to the rank in the mutex's group. */
-  proc = ARMCII_Translate_absolute_to_group(hdl->comm, world_proc);
+  proc = ARMCII_Translate_absolute_to_group(&hdl->grp, world_proc);
   ARMCII_Assert(proc >= 0);
 
-  lock_val   = rank+1;    // Map into range 1..nproc
-  unlock_val = -1 * (rank+1);
-
-  /* mutex <- mutex + rank */
-  MPI_Win_lock(MPI_LOCK_EXCLUSIVE, proc, 0, hdl->window);
-  MPI_Accumulate(&lock_val, 1, MPI_LONG, proc, mutex, 1, MPI_LONG, MPI_SUM, hdl->window);
-  MPI_Win_unlock(proc, hdl->window);
-
-  for (;;) {
-    /* read mutex value */
-    MPI_Win_lock(MPI_LOCK_EXCLUSIVE, proc, 0, hdl->window);
-    MPI_Get(&lock_out, 1, MPI_LONG, proc, mutex, 1, MPI_LONG, hdl->window);
-    MPI_Win_unlock(proc, hdl->window);
-
-    ARMCII_Assert(lock_out > 0);
-    ARMCII_Assert(lock_out <= nproc*(nproc+1)/2); // Must be < sum of all ranks
-
-    /* We are holding the mutex */
-    if (lock_out == rank+1)
-      break;
-
-    /* mutex <- mutex - rank */
-    MPI_Win_lock(MPI_LOCK_EXCLUSIVE, proc, 0, hdl->window);
-    MPI_Accumulate(&unlock_val, 1, MPI_LONG, proc, mutex, 1, MPI_LONG, MPI_SUM, hdl->window);
-    MPI_Win_unlock(proc, hdl->window);
-
-    /* Exponential backoff */
-    usleep(timeout + rand()%timeout);
-    timeout = MIN(timeout*TIMEOUT_MUL, MAX_TIMEOUT);
-    if (rand() % nproc == 0) // Chance to reset timeout
-      timeout = 1;
-
-    /* mutex <- mutex + rank */
-    MPI_Win_lock(MPI_LOCK_EXCLUSIVE, proc, 0, hdl->window);
-    MPI_Accumulate(&lock_val, 1, MPI_LONG, proc, mutex, 1, MPI_LONG, MPI_SUM, hdl->window);
-    MPI_Win_unlock(proc, hdl->window);
+  /* Take a ticket and read the ticket now being served in one operation */
+  MPI_Get_accumulate(take, TICKET_NWORDS, MPI_UNSIGNED, out, TICKET_NWORDS, MPI_UNSIGNED,
+                     proc, mutex*TICKET_NWORDS, TICKET_NWORDS, MPI_UNSIGNED, MPI_SUM, hdl->window);
+  MPI_Win_flush(proc, hdl->window);
+
+  for (serving = out[TICKET_SERVING]; serving != out[TICKET_NEXT]; ) {
+    ARMCII_Backoff(out[TICKET_NEXT] - serving);
+    serving = ticket_serving(hdl, mutex, proc);
   }
+
+  ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "lock acquired [proc = %d, mutex = %d, ticket = %u]\n",
+                   proc, mutex, out[TICKET_NEXT]);
 }
 
 
@@ -159,44 +144,31 @@ void ARMCIX_Lock_hdl(armcix_mutex_hdl_t hdl, int mutex, int world_proc) {
   * @return                0 on success, non-zero on failure
   */
 int ARMCIX_Trylock_hdl(armcix_mutex_hdl_t hdl, int mutex, int world_proc) {
-  int       rank, nproc, proc;
-  long      lock_val, unlock_val, lock_out;
-
-  ARMCII_Assert(mutex >= 0);
+  int       proc;
+  unsigned  zero[TICKET_NWORDS] = { 0, 0 }, out[TICKET_NWORDS], next, ticket;
 
-  MPI_Comm_rank(hdl->comm, &rank);
-  MPI_Comm_size(hdl->comm, &nproc);
+  ARMCII_Assert(mutex >= 0 && mutex < hdl->max_count);
 
   /* User gives us the absolute ID.  Translate to the rank in the mutex's group. */
-  proc = ARMCII_Translate_absolute_to_group(hdl->comm, world_proc);
+  proc = ARMCII_Translate_absolute_to_group(&hdl->grp, world_proc);
   ARMCII_Assert(proc >= 0);
 
-  lock_val   = rank+1;
-  unlock_val = -1 * (rank+1);
+  MPI_Get_accumulate(zero, TICKET_NWORDS, MPI_UNSIGNED, out, TICKET_NWORDS, MPI_UNSIGNED,
+                     proc, mutex*TICKET_NWORDS, TICKET_NWORDS, MPI_UNSIGNED, MPI_NO_OP, hdl->window);
+  MPI_Win_flush(proc, hdl->window);
 
-  /* mutex <- mutex + rank */
-  MPI_Win_lock(MPI_LOCK_EXCLUSIVE, proc, 0, hdl->window);
-  MPI_Accumulate(&lock_val, 1, MPI_LONG, proc, mutex, 1, MPI_LONG, MPI_SUM, hdl->window);
-  MPI_Win_unlock(proc, hdl->window);
+  if (out[TICKET_NEXT] != out[TICKET_SERVING])
+    return 1;
 
-  /* read mutex value */
-  MPI_Win_lock(MPI_LOCK_EXCLUSIVE, proc, 0, hdl->window);
-  MPI_Get(&lock_out, 1, MPI_LONG, proc, mutex, 1, MPI_LONG, hdl->window);
-  MPI_Win_unlock(proc, hdl->window);
+  /* The mutex is free: take the next ticket unless someone else got it first */
+  ticket = out[TICKET_NEXT];
+  next   = ticket + 1;
 
-  ARMCII_Assert(lock_out > 0);
-  ARMCII_Assert(lock_out <= nproc*(nproc+1)/2); // Must be < sum of all ranks
+  MPI_Compare_and_swap(&next, &ticket, &out[TICKET_NEXT], MPI_UNSIGNED, proc,
+                       mutex*TICKET_NWORDS + TICKET_NEXT, hdl->window);
+  MPI_Win_flush(proc, hdl->window);
 
-  /* We are holding the mutex */
-  if (lock_out == rank+1)
-    return 0;
-
-  /* mutex <- mutex - rank */
-  MPI_Win_lock(MPI_LOCK_EXCLUSIVE, proc, 0, hdl->window);
-  MPI_Accumulate(&unlock_val, 1, MPI_LONG, proc, mutex, 1, MPI_LONG, MPI_SUM, hdl->window);
-  MPI_Win_unlock(proc, hdl->window);
-
-  return 1;
+  return out[TICKET_NEXT] != ticket;
 }
 
 
@@ -207,23 +179,17 @@ int ARMCIX_Trylock_hdl(armcix_mutex_hdl_t hdl, int mutex, int world_proc) {
   * @param[in] world_proc  Absolute ID of process where the mutex lives
   */
 void ARMCIX_Unlock_hdl(armcix_mutex_hdl_t hdl, int mutex, int world_proc) {
-  int       rank, nproc, proc;
-  long      unlock_val;
-
-  ARMCII_Assert(mutex >= 0);
+  int       proc;
+  unsigned  one = 1;
 
-  MPI_Comm_rank(hdl->comm, &rank);
-  MPI_Comm_size(hdl->comm, &nproc);
+  ARMCII_Assert(mutex >= 0 && mutex < hdl->max_count);
 
   /* User gives us the absolute ID.  Translate to the rank in the mutex's group. */
-  proc = ARMCII_Translate_absolute_to_group(hdl->comm, world_proc);
+  proc = ARMCII_Translate_absolute_to_group(&hdl->grp, world_proc);
   ARMCII_Assert(proc >= 0);
 
-  unlock_val = -1 * (rank+1);
-
-  /* mutex <- mutex - rank */
-  MPI_Win_lock(MPI_LOCK_EXCLUSIVE, proc, 0, hdl->window);
-  MPI_Accumulate(&unlock_val, 1, MPI_LONG, proc, mutex, 1, MPI_LONG, MPI_SUM, hdl->window);
-  MPI_Win_unlock(proc, hdl->window);
+  /* Serve the next ticket */
+  MPI_Accumulate(&one, 1, MPI_UNSIGNED, proc, mutex*TICKET_NWORDS + TICKET_SERVING, 1, MPI_UNSIGNED,
+                 MPI_SUM, hdl->window);
+  MPI_Win_flush(proc, hdl->window);
 }
-
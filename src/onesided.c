@@ -31,10 +31,14 @@
 void PARMCI_Access_begin(void *ptr) {
   gmr_t *mreg;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Access_begin);
+
   mreg = gmr_lookup(ptr, ARMCI_GROUP_WORLD.rank);
   ARMCII_Assert_msg(mreg != NULL, "Invalid remote pointer");
 
   gmr_sync(mreg);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Access_begin);
 }
 
 
@@ -59,10 +63,14 @@ void PARMCI_Access_begin(void *ptr) {
 void PARMCI_Access_end(void *ptr) {
   gmr_t *mreg;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Access_end);
+
   mreg = gmr_lookup(ptr, ARMCI_GROUP_WORLD.rank);
   ARMCII_Assert_msg(mreg != NULL, "Invalid remote pointer");
 
   gmr_sync(mreg);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Access_end);
 }
 
 
@@ -88,7 +96,8 @@ int PARMCI_Get(void *src, void *dst, int size, int target) {
   gmr_t *src_mreg, *dst_mreg;
 
   ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Get);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Get, target);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Get, target, size);
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_GET, target, size);
 
   src_mreg = gmr_lookup(src, target);
 
@@ -103,6 +112,7 @@ int PARMCI_Get(void *src, void *dst, int size, int target) {
   /* Local operation */
   if (target == ARMCI_GROUP_WORLD.rank && dst_mreg == NULL) {
     ARMCI_Copy(src, dst, size);
+    gmr_stats_record(src_mreg, ARMCIX_ALLOC_GET, target, size);
   }
 
   /* Origin buffer is private */
@@ -155,6 +165,10 @@ int PARMCI_Get(void *src, void *dst, int size, int target) {
 int PARMCI_Put(void *src, void *dst, int size, int target) {
   gmr_t *src_mreg, *dst_mreg;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Put);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Put, target, size);
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_PUT, target, size);
+
   dst_mreg = gmr_lookup(dst, target);
 
   /* If NOGUARD is set, assume the buffer is not shared */
@@ -168,6 +182,7 @@ int PARMCI_Put(void *src, void *dst, int size, int target) {
   /* Local operation */
   if (target == ARMCI_GROUP_WORLD.rank && src_mreg == NULL) {
     ARMCI_Copy(src, dst, size);
+    gmr_stats_record(dst_mreg, ARMCIX_ALLOC_PUT, target, size);
   }
 
   /* Origin buffer is private */
@@ -193,6 +208,8 @@ int PARMCI_Put(void *src, void *dst, int size, int target) {
     MPI_Free_mem(src_buf);
   }
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Put);
+
   return 0;
 }
 
@@ -225,7 +242,8 @@ int PARMCI_Acc(int datatype, void *scale, void *src, void *dst, int bytes, int p
   gmr_t *src_mreg, *dst_mreg;
 
   ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Acc);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Acc, proc);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Acc, proc, bytes);
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_ACC, proc, bytes);
 
   /* If NOGUARD is set, assume the buffer is not shared */
   if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD)
@@ -303,9 +321,14 @@ int PARMCI_Acc(int datatype, void *scale, void *src, void *dst, int bytes, int p
 int PARMCI_Put_flag(void *src, void* dst, int size, int *flag, int value, int proc) {
   /* TODO: This can be optimized with a more direct implementation, especially in the
    *       case where RMA is ordered; in that case, the Fence (Flush) is not necessary. */
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Put_flag);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Put_flag, proc, size);
+
   PARMCI_Put(src, dst, size, proc);
   PARMCI_Fence(proc);
   PARMCI_Put(&value, flag, sizeof(int), proc);
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Put_flag);
+
   return 0;
 }
@@ -61,6 +61,10 @@ void ARMCI_UNSET_AGGREGATE_HANDLE(armci_hdl_t *handle) {
 int PARMCI_NbPut(void *src, void *dst, int size, int target, armci_hdl_t *handle) {
   gmr_t *src_mreg, *dst_mreg;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_NbPut);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbPut, target, size);
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_PUT, target, size);
+
   dst_mreg = gmr_lookup(dst, target);
 
   /* If NOGUARD is set, assume the buffer is not shared */
@@ -74,6 +78,7 @@ int PARMCI_NbPut(void *src, void *dst, int size, int target, armci_hdl_t *handle
   /* Local operation */
   if (target == ARMCI_GROUP_WORLD.rank && src_mreg == NULL) {
       ARMCI_Copy(src, dst, size);
+      gmr_stats_record(dst_mreg, ARMCIX_ALLOC_PUT, target, size);
   }
   else {
       gmr_put(dst_mreg, src, dst, size, target);
@@ -88,6 +93,8 @@ int PARMCI_NbPut(void *src, void *dst, int size, int target, armci_hdl_t *handle
   gmr_progress();
 #endif
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_NbPut);
+
   return 0;
 }
 
@@ -108,7 +115,8 @@ int PARMCI_NbGet(void *src, void *dst, int size, int target, armci_hdl_t *handle
   gmr_t *src_mreg, *dst_mreg;
 
   ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_NbGet);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbGet, target);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbGet, target, size);
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_GET, target, size);
 
   src_mreg = gmr_lookup(src, target);
 
@@ -123,6 +131,7 @@ int PARMCI_NbGet(void *src, void *dst, int size, int target, armci_hdl_t *handle
   /* Local operation */
   if (target == ARMCI_GROUP_WORLD.rank && dst_mreg == NULL) {
     ARMCI_Copy(src, dst, size);
+    gmr_stats_record(src_mreg, ARMCIX_ALLOC_GET, target, size);
   }
   else {
     gmr_get(src_mreg, src, dst, size, target);
@@ -161,6 +170,10 @@ int PARMCI_NbAcc(int datatype, void *scale, void *src, void *dst, int bytes, int
   MPI_Datatype type;
   gmr_t *src_mreg, *dst_mreg;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_NbAcc);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbAcc, target, bytes);
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_ACC, target, bytes);
+
   /* If NOGUARD is set, assume the buffer is not shared */
   if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD)
     src_mreg = gmr_lookup(src, ARMCI_GROUP_WORLD.rank);
@@ -218,6 +231,8 @@ int PARMCI_NbAcc(int datatype, void *scale, void *src, void *dst, int bytes, int
   gmr_progress();
 #endif
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_NbAcc);
+
   return 0;
 }
 
@@ -237,7 +252,6 @@ int PARMCI_NbAcc(int datatype, void *scale, void *src, void *dst, int bytes, int
 int PARMCI_Wait(armci_hdl_t* handle) {
   gmr_t *cur_mreg = gmr_list;
   ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Wait);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Wait, 0);
 
   if(handle->aggregate > 0
 #ifdef CHECK_AGGREGATE_TARGET_IN_WAIT
@@ -275,7 +289,15 @@ int PARMCI_Wait(armci_hdl_t* handle) {
 /** Check if a non-blocking operation has finished.
   */
 int PARMCI_Test(armci_hdl_t* handle) {
-  return PARMCI_Wait(handle);
+  int flag;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Test);
+
+  flag = PARMCI_Wait(handle);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Test);
+
+  return flag;
 }
 
 
@@ -294,10 +316,15 @@ int PARMCI_Test(armci_hdl_t* handle) {
 int PARMCI_WaitProc(int proc) {
   gmr_t *cur_mreg = gmr_list;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_WaitProc);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_WaitProc, proc, 0);
+
   while (cur_mreg) {
     gmr_flush(cur_mreg, proc, 1); /* local only */
     cur_mreg = cur_mreg->next;
   }
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_WaitProc);
   return 0;
 }
 
@@ -318,7 +345,6 @@ int PARMCI_WaitAll(void) {
   gmr_t *cur_mreg = gmr_list;
 
   ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_WaitAll);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_WaitAll, 0);
 
   while (cur_mreg) {
     gmr_flushall(cur_mreg, 1); /* local only */
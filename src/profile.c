@@ -1,13 +1,30 @@
 /*
  * profile.c
- *  <FILE_DESC>
- * 	
+ *  Profiling of ARMCI operations.  Each process keeps per-operation totals
+ *  and histograms, and a sparse table of per-target counters that grows with
+ *  the number of distinct (operation, target) pairs actually used.  At
+ *  finalize, the statistics are aggregated across processes and written as a
+ *  JSON or CSV report.
+ *
+ *  When ARMCI_TRACE is set, each process also records a timestamped event
+ *  per call into a fixed-size buffer that is appended to a per-process file
+ *  whenever it fills and at finalize.  The buffer is private to the process
+ *  and written without locks, so recording costs a few stores per call.
+ *
+ *  When ARMCI_LIVE_STATS is set, the running totals are also published in a
+ *  per-node shared-memory segment (see live_stats.h) for armci-top, and a
+ *  signal can request a snapshot of them in a per-process file.
+ *
  *  Author: Min Si
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include <mpi.h>
 
 #include <armci.h>
@@ -15,6 +32,8 @@
 #include <debug.h>
 #include <gmr.h>
 #include "profile.h"
+#include "trace.h"
+#include "live_stats.h"
 
 #ifdef ENABLE_PROFILE
 
@@ -23,30 +42,100 @@ extern void CSP_Profile_reset_flush_counter(MPI_Win win);
 extern void CSP_Profile_print_flush_counter(MPI_Win win);
 #endif
 
+#define ARMCII_PROF_NAME(func, cat) #func,
 const char *ARMCI_Profile_func_names[PROF_MAX_NUM_PROFILE_FUNC] = {
-    "PARMCI_GetS",
-    "PARMCI_Get",
-    "PARMCI_AccS",
-    "PARMCI_Acc",
-    "PARMCI_NbGetS",
-    "PARMCI_NbGet",
-    "PARMCI_Rmw",
-    "PARMCI_Barrier",
-    "PARMCI_AllFence",
-    "PARMCI_WaitAll",
-    "PARMCI_Wait",
-    "gmr_create",
-    "gmr_destroy",
-    "gmr_flushall_trans",
-    "gmr_flushall",
-    "gmr_flush_trans",
-    "gmr_flush",
+    ARMCII_PROF_FUNCS(ARMCII_PROF_NAME)
 };
+#undef ARMCII_PROF_NAME
 
-int profile_global_var_nproc = 0;
-int prof_counters[MAX_NPROC * PROF_MAX_NUM_PROFILE_FUNC];
-double prof_timings[PROF_MAX_NUM_PROFILE_FUNC];
-static int env_print_per_rank = -1;
+#define ARMCII_PROF_CAT(func, cat) cat,
+static const int prof_func_cats[PROF_MAX_NUM_PROFILE_FUNC] = {
+    ARMCII_PROF_FUNCS(ARMCII_PROF_CAT)
+};
+#undef ARMCII_PROF_CAT
+
+static const struct {
+    const char *name;
+    int         mask;
+} prof_cat_names[] = {
+    { "rma",    PROF_CAT_RMA    },
+    { "nb",     PROF_CAT_NB     },
+    { "sync",   PROF_CAT_SYNC   },
+    { "atomic", PROF_CAT_ATOMIC },
+    { "alloc",  PROF_CAT_ALLOC  },
+    { "gmr",    PROF_CAT_GMR    },
+    { "all",    ~0              },
+};
+
+/* Per-operation statistics */
+typedef struct {
+    uint64_t calls;
+    uint64_t xfers;                     /* Calls that recorded a transfer */
+    uint64_t bytes;
+    uint64_t ticks;
+    uint64_t size_hist[PROF_NBINS];     /* log2 of bytes per transfer     */
+    uint64_t lat_hist[PROF_NBINS];      /* log2 of nanoseconds per call   */
+} prof_func_t;
+
+/* Entry of the sparse per-target table, key 0 marks an empty slot */
+typedef struct {
+    uint64_t key;
+    uint64_t count;
+    uint64_t bytes;
+} prof_target_t;
+
+/* Metrics aggregated in the report, after the histograms */
+enum { PROF_M_CALLS, PROF_M_BYTES, PROF_M_TIME, PROF_M_TARGETS, PROF_M_MAX_TARGET_BYTES, PROF_NSCALAR };
+#define PROF_NMETRIC (PROF_NSCALAR + 2*PROF_NBINS)
+
+static const char *prof_metric_names[PROF_NSCALAR] = {
+    "calls", "bytes", "time", "targets", "max_target_bytes"
+};
+
+char ARMCII_Prof_enabled[PROF_MAX_NUM_PROFILE_FUNC];
+
+static prof_func_t    prof_funcs[PROF_MAX_NUM_PROFILE_FUNC];
+static prof_target_t *prof_targets      = NULL;
+static size_t         prof_targets_size = 0;   /* Number of slots, a power of two */
+static size_t         prof_targets_used = 0;
+static double         prof_ns_per_tick  = 1.0;
+static double         prof_tick_hz      = 1.0e9;
+static int            env_print_per_rank = -1;
+
+/* Fields of the next trace event of each operation, filled in by the counter
+ * and window hooks while the operation is in progress */
+typedef struct {
+    uint64_t calls;                     /* Calls seen, for sampling       */
+    int64_t  bytes;
+    int32_t  target;
+    int32_t  window;
+} prof_pending_t;
+
+int                          ARMCII_Prof_tracing = 0;
+
+static prof_pending_t        prof_pending[PROF_MAX_NUM_PROFILE_FUNC];
+static armcii_trace_event_t *prof_trace        = NULL;
+static int                   prof_trace_len    = 0;
+static int                   prof_trace_cap    = 0;
+static int                   prof_trace_sample = 1;
+static FILE                 *prof_trace_file   = NULL;
+
+/* Relaxed atomic store, for counters read concurrently by other processes */
+#if defined(__GNUC__) || defined(__clang__)
+#  define PROF_STORE_RELAXED(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELAXED)
+#else
+#  define PROF_STORE_RELAXED(ptr, val) (*(volatile uint64_t *) (ptr) = (val))
+#endif
+
+static void                 *prof_live_seg  = NULL;   /* Node segment, NULL when not attached   */
+static size_t                prof_live_size = 0;
+static int                   prof_live_on   = 0;      /* Node agreed to publish live counters   */
+static char                  prof_live_name[256];
+static armcii_live_func_t   *prof_live      = NULL;   /* This process's counters in the segment */
+
+static int                   prof_signal    = 0;      /* Snapshot signal, 0 if none             */
+static struct sigaction      prof_signal_old;
+static volatile sig_atomic_t prof_snapshot_pending = 0;
 
 static inline void read_tpi_env()
 {
@@ -63,29 +152,726 @@ static inline void read_tpi_env()
     }
 }
 
-void ARMCI_Profile_init()
+
+/** Index of the log2 histogram bin holding value.
+  */
+static inline int prof_bin(uint64_t value)
 {
-    int rank, i;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &profile_global_var_nproc);
-    if (profile_global_var_nproc > MAX_NPROC) {
-        fprintf(stderr, "nproc %d > max profile nproc %d\n", profile_global_var_nproc, MAX_NPROC);
-        MPI_Abort(MPI_COMM_WORLD, 1);
+    int bin = 0;
+
+    while (value != 0 && bin < PROF_NBINS - 1) {
+        value >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
+
+
+/** Set the enable mask from a comma-separated list of categories and
+  * operation names.  "none" disables profiling.
+  */
+static void prof_parse_mask(const char *spec)
+{
+    char *list, *tok, *save;
+    int   i, j;
+
+    memset(ARMCII_Prof_enabled, 0, sizeof(ARMCII_Prof_enabled));
+
+    list = strdup(spec);
+    ARMCII_Assert(list != NULL);
+
+    for (tok = strtok_r(list, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save)) {
+        int found = 0;
+
+        if (strcasecmp(tok, "none") == 0)
+            continue;
+
+        for (j = 0; j < (int) (sizeof(prof_cat_names)/sizeof(prof_cat_names[0])); j++) {
+            if (strcasecmp(tok, prof_cat_names[j].name) == 0) {
+                for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++)
+                    if (prof_func_cats[i] & prof_cat_names[j].mask)
+                        ARMCII_Prof_enabled[i] = 1;
+                found = 1;
+            }
+        }
+
+        for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC && !found; i++) {
+            if (strcasecmp(tok, ARMCI_Profile_func_names[i]) == 0) {
+                ARMCII_Prof_enabled[i] = 1;
+                found = 1;
+            }
+        }
+
+        if (!found)
+            ARMCII_Warning("Ignoring unknown ARMCI_PROFILE entry (%s)\n", tok);
+    }
+
+    free(list);
+}
+
+
+/** Measure the clock rate against MPI_Wtime.
+  */
+static void prof_calibrate(void)
+{
+    armcii_prof_tick_t t0;
+    double             w0, w1;
+
+    w0 = MPI_Wtime();
+    t0 = ARMCII_Prof_ticks();
+    do {
+        w1 = MPI_Wtime();
+    } while (w1 - w0 < 0.01);
+
+    prof_tick_hz     = (double) (ARMCII_Prof_ticks() - t0) / (w1 - w0);
+    prof_ns_per_tick = 1.0e9 / prof_tick_hz;
+}
+
+
+/** Append the buffered trace events to the trace file and empty the buffer.
+  */
+static void prof_trace_flush(void)
+{
+    if (prof_trace_len > 0 &&
+        fwrite(prof_trace, sizeof(armcii_trace_event_t), prof_trace_len, prof_trace_file)
+            != (size_t) prof_trace_len)
+        ARMCII_Warning("Trace events lost, unable to write trace file\n");
+
+    prof_trace_len = 0;
+}
+
+
+/** Record a trace event for a call, if it is sampled.
+  */
+static inline void prof_trace_event(int func, armcii_prof_tick_t start, armcii_prof_tick_t end)
+{
+    prof_pending_t *p = &prof_pending[func];
+
+    if (p->calls++ % prof_trace_sample == 0) {
+        armcii_trace_event_t *ev;
+
+        if (prof_trace_len == prof_trace_cap)
+            prof_trace_flush();
+
+        ev         = &prof_trace[prof_trace_len++];
+        ev->start  = start;
+        ev->end    = end;
+        ev->bytes  = p->bytes;
+        ev->target = p->target;
+        ev->window = p->window;
+        ev->func   = func;
+        ev->pad    = 0;
+    }
+
+    p->bytes  = 0;
+    p->target = -1;
+    p->window = -1;
+}
+
+
+/** Append the current counters of this process to its snapshot file.
+  */
+static void prof_snapshot(void)
+{
+    const char *prefix = ARMCII_Getenv("ARMCI_PROFILE_SNAPSHOT");
+    char        path[1024];
+    FILE       *out;
+    int         f;
+
+    prof_snapshot_pending = 0;
+
+    snprintf(path, sizeof(path), "%s.%d.csv", prefix != NULL ? prefix : "armci_snapshot",
+             ARMCI_GROUP_WORLD.rank);
+
+    out = fopen(path, "a");
+    if (out == NULL) {
+        ARMCII_Warning("Unable to open snapshot file (%s)\n", path);
+        return;
+    }
+
+    if (ftell(out) == 0)
+        fprintf(out, "wtime,function,calls,bytes,time\n");
+
+    for (f = 0; f < PROF_MAX_NUM_PROFILE_FUNC; f++)
+        if (prof_funcs[f].calls > 0 || prof_funcs[f].bytes > 0)
+            fprintf(out, "%.6f,%s,%llu,%llu,%.9g\n", MPI_Wtime(), ARMCI_Profile_func_names[f],
+                    (unsigned long long) prof_funcs[f].calls, (unsigned long long) prof_funcs[f].bytes,
+                    prof_funcs[f].ticks / prof_tick_hz);
+
+    fclose(out);
+}
+
+
+/** Record the completion of a call that started and ended at the given
+  * tick counts.
+  */
+void ARMCII_Prof_record_time(int func, armcii_prof_tick_t start, armcii_prof_tick_t end)
+{
+    prof_func_t             *f     = &prof_funcs[func];
+    const armcii_prof_tick_t ticks = end - start;
+
+    f->calls++;
+    f->ticks += ticks;
+    f->lat_hist[prof_bin((uint64_t) (ticks * prof_ns_per_tick))]++;
+
+    if (ARMCII_Prof_tracing)
+        prof_trace_event(func, start, end);
+
+    if (prof_live != NULL) {
+        PROF_STORE_RELAXED(&prof_live[func].calls, f->calls);
+        PROF_STORE_RELAXED(&prof_live[func].ticks, f->ticks);
+    }
+
+    if (unlikely(prof_snapshot_pending))
+        prof_snapshot();
+}
+
+
+/** Record the window used by a call in progress, for its trace event.
+  */
+void ARMCII_Prof_record_window(int func, MPI_Win win)
+{
+    prof_pending[func].window = MPI_Win_c2f(win);
+}
+
+
+/** Find the per-target slot for key, inserting it if needed.
+  */
+static prof_target_t *prof_target_slot(uint64_t key)
+{
+    size_t i;
+
+    /* Keep the load factor below one half */
+    if (2 * (prof_targets_used + 1) > prof_targets_size) {
+        prof_target_t *old      = prof_targets;
+        size_t         old_size = prof_targets_size;
+
+        prof_targets_size = old_size ? 2 * old_size : 256;
+        prof_targets      = calloc(prof_targets_size, sizeof(prof_target_t));
+        ARMCII_Assert(prof_targets != NULL);
+
+        for (i = 0; i < old_size; i++) {
+            if (old[i].key != 0) {
+                size_t k = (old[i].key * 0x9E3779B97F4A7C15ULL) & (prof_targets_size - 1);
+
+                while (prof_targets[k].key != 0)
+                    k = (k + 1) & (prof_targets_size - 1);
+                prof_targets[k] = old[i];
+            }
+        }
+
+        free(old);
+    }
+
+    i = (key * 0x9E3779B97F4A7C15ULL) & (prof_targets_size - 1);
+
+    while (prof_targets[i].key != key && prof_targets[i].key != 0)
+        i = (i + 1) & (prof_targets_size - 1);
+
+    if (prof_targets[i].key == 0) {
+        prof_targets[i].key = key;
+        prof_targets_used++;
+    }
+
+    return &prof_targets[i];
+}
+
+
+/** Record a transfer of bytes to target, or -1 if the operation has no
+  * single target.
+  */
+void ARMCII_Prof_record_xfer(int func, int target, int64_t bytes)
+{
+    prof_func_t *f = &prof_funcs[func];
+
+    f->xfers++;
+    f->bytes += bytes;
+    f->size_hist[prof_bin(bytes)]++;
+
+    if (prof_live != NULL)
+        PROF_STORE_RELAXED(&prof_live[func].bytes, f->bytes);
+
+    if (target >= 0) {
+        prof_target_t *t = prof_target_slot(((uint64_t) func << 32 | (uint32_t) target) + 1);
+
+        t->count++;
+        t->bytes += bytes;
+    }
+
+    if (ARMCII_Prof_tracing) {
+        prof_pending[func].bytes  = bytes;
+        prof_pending[func].target = target;
+    }
+}
+
+
+/** Open this process's trace file and allocate the event buffer.  Collective
+  * on the world group, the barrier sets a common time origin.
+  */
+static void prof_trace_init(int rank, int nproc)
+{
+    armcii_trace_header_t hdr;
+    armcii_prof_tick_t    origin;
+    const char           *prefix = ARMCII_Getenv("ARMCI_TRACE_PREFIX");
+    char                  path[1024];
+    int                   i;
+
+    prof_trace_sample = ARMCII_Getenv_int("ARMCI_TRACE_SAMPLE", 1);
+    prof_trace_cap    = ARMCII_Getenv_int("ARMCI_TRACE_EVENTS", 65536);
+
+    if (prof_trace_sample < 1) prof_trace_sample = 1;
+    if (prof_trace_cap < 1)    prof_trace_cap    = 1;
+
+    for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++) {
+        prof_pending[i].calls  = 0;
+        prof_pending[i].bytes  = 0;
+        prof_pending[i].target = -1;
+        prof_pending[i].window = -1;
+    }
+
+    snprintf(path, sizeof(path), "%s.%d.bin", prefix != NULL ? prefix : "armci_trace", rank);
+    prof_trace_file = fopen(path, "wb");
+
+    MPI_Barrier(ARMCI_GROUP_WORLD.comm);
+    origin = ARMCII_Prof_ticks();
+
+    if (prof_trace_file == NULL) {
+        ARMCII_Warning("Unable to open trace file (%s), tracing disabled\n", path);
+        return;
+    }
+
+    prof_trace = malloc(prof_trace_cap * sizeof(armcii_trace_event_t));
+    ARMCII_Assert(prof_trace != NULL);
+    prof_trace_len = 0;
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, ARMCII_TRACE_MAGIC, sizeof(hdr.magic));
+    hdr.rank     = rank;
+    hdr.nproc    = nproc;
+    hdr.nfuncs   = PROF_MAX_NUM_PROFILE_FUNC;
+    hdr.sample   = prof_trace_sample;
+    hdr.clock_hz = prof_tick_hz;
+    hdr.origin   = origin;
+
+    fwrite(&hdr, sizeof(hdr), 1, prof_trace_file);
+
+    for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++) {
+        char name[ARMCII_TRACE_NAME_LEN] = { 0 };
+
+        strncpy(name, ARMCI_Profile_func_names[i], ARMCII_TRACE_NAME_LEN - 1);
+        fwrite(name, ARMCII_TRACE_NAME_LEN, 1, prof_trace_file);
+    }
+
+    ARMCII_Prof_tracing = 1;
+}
+
+
+/** Write out the remaining trace events and close the trace file.
+  */
+static void prof_trace_destroy(void)
+{
+    if (prof_trace_file != NULL) {
+        prof_trace_flush();
+        fclose(prof_trace_file);
     }
 
+    free(prof_trace);
+    prof_trace          = NULL;
+    prof_trace_file     = NULL;
+    prof_trace_cap      = 0;
+    ARMCII_Prof_tracing = 0;
+}
+
+
+/** Create or attach to the node's live statistics segment and publish this
+  * process's counters in it.  Collective on the world group.
+  */
+static void prof_live_init(int rank)
+{
+    ARMCII_Msg_hier_t    *hier = ARMCII_Msg_hier_get(&ARMCI_GROUP_WORLD);
+    armcii_live_header_t *hdr;
+    armcii_live_slot_t   *slot;
+    const uint64_t        names_off = (sizeof(armcii_live_header_t) + 63) & ~(uint64_t) 63;
+    const uint64_t        slots_off = (names_off + PROF_MAX_NUM_PROFILE_FUNC * ARMCII_LIVE_NAME_LEN + 63)
+                                      & ~(uint64_t) 63;
+    const uint64_t        slot_size = ARMCII_LIVE_SLOT_SIZE(PROF_MAX_NUM_PROFILE_FUNC);
+    int                   node_rank, node_size, job = getpid(), ok = 1, fd = -1, i;
+
+    MPI_Comm_rank(hier->node_comm, &node_rank);
+    MPI_Comm_size(hier->node_comm, &node_size);
+
+    /* Name the segment after the job (the pid of process 0) and the node */
+    MPI_Bcast(&job, 1, MPI_INT, 0, ARMCI_GROUP_WORLD.comm);
+    snprintf(prof_live_name, sizeof(prof_live_name), "/%s.%d.%d", ARMCII_LIVE_PREFIX, job,
+             hier->node_of[rank]);
+
+    prof_live_size = slots_off + node_size * slot_size;
+
+    if (node_rank == 0) {
+        fd = shm_open(prof_live_name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+        ok = (fd >= 0 && ftruncate(fd, prof_live_size) == 0);
+
+        if (!ok) {
+            ARMCII_Warning("Unable to create live statistics segment (%s)\n", prof_live_name);
+            if (fd >= 0) {
+                close(fd);
+                shm_unlink(prof_live_name);
+            }
+        }
+    }
+
+    MPI_Bcast(&ok, 1, MPI_INT, 0, hier->node_comm);
+
+    if (!ok)
+        return;
+
+    prof_live_on = 1;
+
+    if (node_rank != 0)
+        fd = shm_open(prof_live_name, O_RDWR, 0);
+
+    if (fd >= 0) {
+        prof_live_seg = mmap(NULL, prof_live_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+    }
+
+    if (fd < 0 || prof_live_seg == MAP_FAILED) {
+        ARMCII_Warning("Unable to attach to live statistics segment (%s)\n", prof_live_name);
+        prof_live_seg = NULL;
+    }
+
+    hdr = prof_live_seg;
+
+    if (node_rank == 0 && hdr != NULL) {
+        hdr->version      = ARMCII_LIVE_VERSION;
+        hdr->nslots       = node_size;
+        hdr->nfuncs       = PROF_MAX_NUM_PROFILE_FUNC;
+        hdr->slot_size    = slot_size;
+        hdr->names_offset = names_off;
+        hdr->slots_offset = slots_off;
+        hdr->clock_hz     = prof_tick_hz;
+
+        for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++)
+            strncpy((char *) hdr + names_off + i * ARMCII_LIVE_NAME_LEN, ARMCI_Profile_func_names[i],
+                    ARMCII_LIVE_NAME_LEN - 1);
+
+        for (i = 0; i < node_size; i++)
+            ((armcii_live_slot_t *) ((char *) hdr + slots_off + i * slot_size))->rank = -1;
+
+        __atomic_store_n(&hdr->magic, ARMCII_LIVE_MAGIC, __ATOMIC_RELEASE);
+    }
+
+    /* Slots are initialized before processes attach to them */
+    MPI_Barrier(hier->node_comm);
+
+    if (hdr != NULL) {
+        slot      = (armcii_live_slot_t *) ((char *) hdr + slots_off + node_rank * slot_size);
+        slot->pid = getpid();
+        prof_live = slot->funcs;
+        __atomic_store_n(&slot->rank, rank, __ATOMIC_RELEASE);
+    }
+}
+
+
+/** Detach from the live statistics segment, and remove it once every
+  * process on the node has detached.  Collective on the world group.
+  */
+static void prof_live_destroy(void)
+{
+    ARMCII_Msg_hier_t *hier;
+    int                node_rank;
+
+    if (!prof_live_on)
+        return;
+
+    hier = ARMCII_Msg_hier_get(&ARMCI_GROUP_WORLD);
+    MPI_Comm_rank(hier->node_comm, &node_rank);
+
+    if (prof_live_seg != NULL)
+        munmap(prof_live_seg, prof_live_size);
+
+    MPI_Barrier(hier->node_comm);
+
+    if (node_rank == 0)
+        shm_unlink(prof_live_name);
+
+    prof_live_seg = NULL;
+    prof_live     = NULL;
+    prof_live_on  = 0;
+}
+
+
+static void prof_signal_handler(int sig)
+{
+    prof_snapshot_pending = 1;
+}
+
+
+/** Install the snapshot signal handler given by ARMCI_PROFILE_SIGNAL, as a
+  * signal name (USR1, SIGUSR1, USR2, SIGUSR2) or number.
+  */
+static void prof_signal_init(void)
+{
+    const char      *spec = ARMCII_Getenv("ARMCI_PROFILE_SIGNAL");
+    struct sigaction act;
+
+    prof_signal = 0;
+
+    if (spec == NULL)
+        return;
+
+    if (strncasecmp(spec, "SIG", 3) == 0)
+        spec += 3;
+
+    if (strcasecmp(spec, "USR1") == 0)
+        prof_signal = SIGUSR1;
+    else if (strcasecmp(spec, "USR2") == 0)
+        prof_signal = SIGUSR2;
+    else
+        prof_signal = atoi(spec);
+
+    if (prof_signal <= 0) {
+        ARMCII_Warning("Ignoring invalid ARMCI_PROFILE_SIGNAL (%s)\n", ARMCII_Getenv("ARMCI_PROFILE_SIGNAL"));
+        prof_signal = 0;
+        return;
+    }
+
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = prof_signal_handler;
+    act.sa_flags   = SA_RESTART;
+    sigemptyset(&act.sa_mask);
+
+    if (sigaction(prof_signal, &act, &prof_signal_old) != 0) {
+        ARMCII_Warning("Unable to install handler for signal %d\n", prof_signal);
+        prof_signal = 0;
+    }
+}
+
+
+static void prof_signal_destroy(void)
+{
+    if (prof_signal > 0)
+        sigaction(prof_signal, &prof_signal_old, NULL);
+
+    prof_signal           = 0;
+    prof_snapshot_pending = 0;
+}
+
+
+void ARMCI_Profile_init()
+{
+    char *spec;
+    int   rank, nproc;
+
+    MPI_Comm_rank(ARMCI_GROUP_WORLD.comm, &rank);
+    MPI_Comm_size(ARMCI_GROUP_WORLD.comm, &nproc);
+
     read_tpi_env();
 
-    for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC * profile_global_var_nproc; i++)
-        prof_counters[i] = 0;
-    for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++)
-        prof_timings[i] = 0.0;
+    memset(prof_funcs, 0, sizeof(prof_funcs));
+    prof_targets_used = 0;
+    if (prof_targets != NULL)
+        memset(prof_targets, 0, prof_targets_size * sizeof(prof_target_t));
+
+    spec = ARMCII_Getenv("ARMCI_PROFILE");
+    prof_parse_mask(spec != NULL ? spec : "all");
+
+    prof_calibrate();
+
+    if (ARMCII_Getenv_bool("ARMCI_TRACE", 0))
+        prof_trace_init(rank, nproc);
+
+    if (ARMCII_Getenv_bool("ARMCI_LIVE_STATS", 0))
+        prof_live_init(rank);
+
+    prof_signal_init();
 
     if (rank == 0)
-        fprintf(stdout, "ARMCI PROFILE initialized\n");
+        fprintf(stdout, "ARMCI PROFILE initialized, clock %.3f GHz\n", prof_tick_hz * 1.0e-9);
 }
 
+
+/** Fill one row of local metrics per operation.
+  */
+static void prof_collect(double *local)
+{
+    size_t i;
+    int    f, b;
+
+    memset(local, 0, PROF_MAX_NUM_PROFILE_FUNC * PROF_NMETRIC * sizeof(double));
+
+    for (f = 0; f < PROF_MAX_NUM_PROFILE_FUNC; f++) {
+        double *row = &local[f * PROF_NMETRIC];
+
+        row[PROF_M_CALLS] = prof_funcs[f].calls;
+        row[PROF_M_BYTES] = prof_funcs[f].bytes;
+        row[PROF_M_TIME]  = prof_funcs[f].ticks / prof_tick_hz;
+
+        for (b = 0; b < PROF_NBINS; b++) {
+            row[PROF_NSCALAR + b]              = prof_funcs[f].size_hist[b];
+            row[PROF_NSCALAR + PROF_NBINS + b] = prof_funcs[f].lat_hist[b];
+        }
+    }
+
+    for (i = 0; i < prof_targets_size; i++) {
+        if (prof_targets[i].key != 0) {
+            double *row = &local[((prof_targets[i].key - 1) >> 32) * PROF_NMETRIC];
+
+            row[PROF_M_TARGETS] += 1;
+            if (prof_targets[i].bytes > row[PROF_M_MAX_TARGET_BYTES])
+                row[PROF_M_MAX_TARGET_BYTES] = prof_targets[i].bytes;
+        }
+    }
+}
+
+
+/** Print a histogram as a JSON array, trimming trailing empty bins.
+  */
+static void prof_json_hist(FILE *out, const char *name, const double *sum)
+{
+    int b, last = -1;
+
+    for (b = 0; b < PROF_NBINS; b++)
+        if (sum[b] > 0) last = b;
+
+    fprintf(out, ", \"%s\": [", name);
+    for (b = 0; b <= last; b++)
+        fprintf(out, "%s%.0f", b ? ", " : "", sum[b]);
+    fprintf(out, "]");
+}
+
+
+/** Write the report aggregated across processes.  Collective on the world
+  * group.
+  */
+static void prof_report(void)
+{
+    double *local, *mins, *maxs, *sums;
+    int     rank, nproc, f, m;
+    const int n = PROF_MAX_NUM_PROFILE_FUNC * PROF_NMETRIC;
+
+    MPI_Comm_rank(ARMCI_GROUP_WORLD.comm, &rank);
+    MPI_Comm_size(ARMCI_GROUP_WORLD.comm, &nproc);
+
+    local = malloc(4 * n * sizeof(double));
+    ARMCII_Assert(local != NULL);
+    mins = local + n;
+    maxs = local + 2*n;
+    sums = local + 3*n;
+
+    prof_collect(local);
+
+    MPI_Reduce(local, mins, n, MPI_DOUBLE, MPI_MIN, 0, ARMCI_GROUP_WORLD.comm);
+    MPI_Reduce(local, maxs, n, MPI_DOUBLE, MPI_MAX, 0, ARMCI_GROUP_WORLD.comm);
+    MPI_Reduce(local, sums, n, MPI_DOUBLE, MPI_SUM, 0, ARMCI_GROUP_WORLD.comm);
+
+    if (rank == 0) {
+        const char *format = ARMCII_Getenv("ARMCI_PROFILE_FORMAT");
+        const char *path   = ARMCII_Getenv("ARMCI_PROFILE_FILE");
+        int         csv    = (format != NULL && strcasecmp(format, "csv") == 0);
+        FILE       *out;
+
+        if (path == NULL)
+            path = csv ? "armci_profile.csv" : "armci_profile.json";
+
+        if (strcmp(path, "-") == 0)
+            out = stdout;
+        else
+            out = fopen(path, "w");
+
+        if (out == NULL) {
+            ARMCII_Warning("Unable to open profile report file (%s)\n", path);
+        }
+
+        else if (csv) {
+            fprintf(out, "function,metric,min,avg,max,total\n");
+
+            for (f = 0; f < PROF_MAX_NUM_PROFILE_FUNC; f++) {
+                const int row = f * PROF_NMETRIC;
+
+                if (sums[row + PROF_M_CALLS] == 0 && sums[row + PROF_M_BYTES] == 0)
+                    continue;
+
+                for (m = 0; m < PROF_NMETRIC; m++) {
+                    char name[32];
+
+                    if (m < PROF_NSCALAR)
+                        snprintf(name, sizeof(name), "%s", prof_metric_names[m]);
+                    else if (m < PROF_NSCALAR + PROF_NBINS)
+                        snprintf(name, sizeof(name), "size_bin_%d", m - PROF_NSCALAR);
+                    else
+                        snprintf(name, sizeof(name), "latency_ns_bin_%d", m - PROF_NSCALAR - PROF_NBINS);
+
+                    if (m >= PROF_NSCALAR && sums[row + m] == 0)
+                        continue;
+
+                    fprintf(out, "%s,%s,%.9g,%.9g,%.9g,%.9g\n", ARMCI_Profile_func_names[f], name,
+                            mins[row + m], sums[row + m] / nproc, maxs[row + m], sums[row + m]);
+                }
+            }
+        }
+
+        else {
+            int first = 1;
+
+            fprintf(out, "{\n  \"nproc\": %d,\n  \"clock_hz\": %.0f,\n", nproc, prof_tick_hz);
+            fprintf(out, "  \"histogram_bins\": \"bin b counts values in [2^(b-1), 2^b), bin 0 counts zeros\",\n");
+            fprintf(out, "  \"functions\": [");
+
+            for (f = 0; f < PROF_MAX_NUM_PROFILE_FUNC; f++) {
+                const int row = f * PROF_NMETRIC;
+
+                if (sums[row + PROF_M_CALLS] == 0 && sums[row + PROF_M_BYTES] == 0)
+                    continue;
+
+                fprintf(out, "%s\n    { \"name\": \"%s\"", first ? "" : ",", ARMCI_Profile_func_names[f]);
+                first = 0;
+
+                for (m = 0; m < PROF_NSCALAR; m++)
+                    fprintf(out, ", \"%s\": { \"min\": %.9g, \"avg\": %.9g, \"max\": %.9g, \"total\": %.9g }",
+                            prof_metric_names[m], mins[row + m], sums[row + m] / nproc, maxs[row + m],
+                            sums[row + m]);
+
+                prof_json_hist(out, "size_hist", &sums[row + PROF_NSCALAR]);
+                prof_json_hist(out, "latency_ns_hist", &sums[row + PROF_NSCALAR + PROF_NBINS]);
+                fprintf(out, " }");
+            }
+
+            fprintf(out, "\n  ]\n}\n");
+        }
+
+        if (out != NULL && out != stdout)
+            fclose(out);
+        else if (out == stdout)
+            fflush(stdout);
+
+    }
+
+    free(local);
+}
+
+
 void ARMCI_Profile_destroy()
 {
+    int i, any = 0;
+
+    for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++)
+        any |= ARMCII_Prof_enabled[i];
+
+    if (any)
+        prof_report();
+
+    prof_trace_destroy();
+    prof_live_destroy();
+    prof_signal_destroy();
+
+    memset(ARMCII_Prof_enabled, 0, sizeof(ARMCII_Prof_enabled));
+
+    free(prof_targets);
+    prof_targets      = NULL;
+    prof_targets_size = 0;
+    prof_targets_used = 0;
 }
 
 void ARMCI_Profile_reset_counter()
@@ -98,8 +884,19 @@ void ARMCI_Profile_reset_counter()
         fflush(stderr);
     }
 
-    for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC * profile_global_var_nproc; i++)
-        prof_counters[i] = 0;
+    for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++) {
+        prof_funcs[i].xfers = 0;
+        prof_funcs[i].bytes = 0;
+        memset(prof_funcs[i].size_hist, 0, sizeof(prof_funcs[i].size_hist));
+    }
+
+    if (prof_targets != NULL)
+        memset(prof_targets, 0, prof_targets_size * sizeof(prof_target_t));
+    prof_targets_used = 0;
+
+    ARMCII_IOV_FLUSH_CTL.nflushes = 0;
+    ARMCII_IOV_FLUSH_CTL.ngrow    = 0;
+    ARMCII_IOV_FLUSH_CTL.nshrink  = 0;
 
 #ifdef ENABLE_CSP_PROFILE
     gmr_t *cur_mreg = gmr_list;
@@ -120,29 +917,35 @@ void ARMCI_Profile_reset_timing()
         fflush(stderr);
     }
 
-    for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++)
-        prof_timings[i] = 0.0;
+    for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++) {
+        prof_funcs[i].calls = 0;
+        prof_funcs[i].ticks = 0;
+        memset(prof_funcs[i].lat_hist, 0, sizeof(prof_funcs[i].lat_hist));
+    }
 }
 
 void ARMCI_Profile_print_timing(char *name)
 {
     int i, rank, size;
-    double timers_avg[PROF_MAX_NUM_PROFILE_FUNC];
+    double timings[PROF_MAX_NUM_PROFILE_FUNC], timers_avg[PROF_MAX_NUM_PROFILE_FUNC];
 
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
+    for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++)
+        timings[i] = prof_funcs[i].ticks / prof_tick_hz;
+
     if (env_print_per_rank == 1) {
         for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++) {
-            if (prof_timings[i] > 0.0) {
+            if (timings[i] > 0.0) {
                 fprintf(stderr, "rank %d, %s %s : %lf\n", rank, name, ARMCI_Profile_func_names[i],
-                        prof_timings[i]);
+                        timings[i]);
             }
         }
         fflush(stderr);
     }
 
-    MPI_Reduce(prof_timings, timers_avg, PROF_MAX_NUM_PROFILE_FUNC, MPI_DOUBLE, MPI_SUM, 0,
+    MPI_Reduce(timings, timers_avg, PROF_MAX_NUM_PROFILE_FUNC, MPI_DOUBLE, MPI_SUM, 0,
                MPI_COMM_WORLD);
 
     if (rank == 0) {
@@ -157,52 +960,82 @@ void ARMCI_Profile_print_timing(char *name)
     }
 }
 
+/** Print the final BATCHED IOV flush window of each target tracked by the
+  * calling process.
+  */
+static void prof_print_iov_windows(const char *prefix, const char *name)
+{
+    int i;
+
+    for (i = 0; i < ARMCII_IOV_FLUSH_CTL_NTARGETS; i++) {
+        const armcii_iov_flush_target_t *ctl = &ARMCII_IOV_FLUSH_CTL.targets[i];
+
+        if (ctl->proc >= 0)
+            fprintf(stderr, "%s%s iov batched target %d = max_ops %d, max_bytes %ld\n", prefix, name,
+                    ctl->proc, ctl->max_ops, ctl->max_bytes);
+    }
+    fflush(stderr);
+}
+
 void ARMCI_Profile_print_counter(char *name)
 {
-    int i, dst, rank;
-    int counters_total[PROF_MAX_NUM_PROFILE_FUNC], counters_total_avg[PROF_MAX_NUM_PROFILE_FUNC];
+    int i, rank;
+    long counters_total[PROF_MAX_NUM_PROFILE_FUNC], counters_total_avg[PROF_MAX_NUM_PROFILE_FUNC];
 
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
-    memset(counters_total, 0, sizeof(int) * PROF_MAX_NUM_PROFILE_FUNC);
-    memset(counters_total_avg, 0, sizeof(int) * PROF_MAX_NUM_PROFILE_FUNC);
-
-    for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++) {
-        for (dst = 0; dst < profile_global_var_nproc; dst++)
-            counters_total[i] += prof_counters[dst * PROF_MAX_NUM_PROFILE_FUNC + i];
-    }
+    for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++)
+        counters_total[i] = prof_funcs[i].xfers;
 
     if (env_print_per_rank == 1) {
         for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++) {
 #if PROFILE_LEVEL == 2
-            for (dst = 0; dst < profile_global_var_nproc; dst++)
-                if (prof_counters[dst * PROF_MAX_NUM_PROFILE_FUNC + i] > 0)
-                    fprintf(stderr, "%d:%d ", dst,
-                            prof_counters[dst * PROF_MAX_NUM_PROFILE_FUNC + i]);
+            size_t t;
+
+            for (t = 0; t < prof_targets_size; t++)
+                if (prof_targets[t].key != 0 && (int) ((prof_targets[t].key - 1) >> 32) == i)
+                    fprintf(stderr, "%u:%lu ", (uint32_t) (prof_targets[t].key - 1),
+                            (unsigned long) prof_targets[t].count);
             fprintf(stderr, "\n");
             fflush(stderr);
 #else
             if (counters_total[i] > 0) {
-                fprintf(stderr, "rank %d, %s %s : %d\n", rank, name, ARMCI_Profile_func_names[i],
+                fprintf(stderr, "rank %d, %s %s : %ld\n", rank, name, ARMCI_Profile_func_names[i],
                         counters_total[i]);
                 fflush(stderr);
             }
 #endif
         }
+
+        if (ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_BATCHED
+            && ARMCII_GLOBAL_STATE.iov_batched_adaptive) {
+            char prefix[32];
+
+            snprintf(prefix, sizeof(prefix), "rank %d, ", rank);
+            prof_print_iov_windows(prefix, name);
+        }
     }
 
-    MPI_Reduce(counters_total, counters_total_avg, PROF_MAX_NUM_PROFILE_FUNC, MPI_INT, MPI_SUM, 0,
+    MPI_Reduce(counters_total, counters_total_avg, PROF_MAX_NUM_PROFILE_FUNC, MPI_LONG, MPI_SUM, 0,
                MPI_COMM_WORLD);
 
     if (rank == 0) {
         for (i = 0; i < PROF_MAX_NUM_PROFILE_FUNC; i++) {
             if (counters_total_avg[i] > 0) {
-                fprintf(stderr, "%s counters = %s : %d\n", name, ARMCI_Profile_func_names[i],
+                fprintf(stderr, "%s counters = %s : %ld\n", name, ARMCI_Profile_func_names[i],
                         counters_total_avg[i]);
                 fflush(stderr);
             }
         }
 
+        if (ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_BATCHED
+            && ARMCII_GLOBAL_STATE.iov_batched_adaptive) {
+            fprintf(stderr, "%s iov batched = flushes %ld, grow %ld, shrink %ld\n",
+                    name, ARMCII_IOV_FLUSH_CTL.nflushes, ARMCII_IOV_FLUSH_CTL.ngrow,
+                    ARMCII_IOV_FLUSH_CTL.nshrink);
+            prof_print_iov_windows("", name);
+        }
+
 #ifdef ENABLE_CSP_PROFILE
         gmr_t *cur_mreg = gmr_list;
         while (cur_mreg) {
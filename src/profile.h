@@ -1,40 +1,149 @@
 /*
  * profile.h
- *  <FILE_DESC>
- * 	
+ *  Profiling of ARMCI operations: per-operation call counts, byte volumes,
+ *  times, and log2 message-size and latency histograms, plus sparse
+ *  per-target counters, and an optional per-process event trace.  Enabled
+ *  with --enable-profile.
+ *
  *  Author: Min Si
  */
 
 #ifndef PROFILE_H_
 #define PROFILE_H_
+#include <stdint.h>
 #include "mpi.h"
+#include "armci.h"
+
+/** Number of bytes moved by a strided operation.
+  */
+static inline int64_t ARMCII_Prof_strided_bytes(int count[], int stride_levels) {
+    int64_t bytes = count[0];
+    int     i;
+
+    for (i = 1; i <= stride_levels; i++)
+        bytes *= count[i];
+
+    return bytes;
+}
+
+/** Number of bytes moved by a vector operation.
+  */
+static inline int64_t ARMCII_Prof_iov_bytes(armci_giov_t *iov, int iov_len) {
+    int64_t bytes = 0;
+    int     i;
+
+    for (i = 0; i < iov_len; i++)
+        bytes += (int64_t) iov[i].ptr_array_len * iov[i].bytes;
+
+    return bytes;
+}
 
 #ifdef ENABLE_PROFILE
-#define MAX_NPROC 4000
+
+/* Operation categories, used to build the runtime enable mask */
+#define PROF_CAT_RMA     0x01  /* Blocking put, get, accumulate, and value ops */
+#define PROF_CAT_NB      0x02  /* Non-blocking operations and their completion */
+#define PROF_CAT_SYNC    0x04  /* Barrier, fences, and direct access          */
+#define PROF_CAT_ATOMIC  0x08  /* Read-modify-write and mutexes               */
+#define PROF_CAT_ALLOC   0x10  /* Allocation                                  */
+#define PROF_CAT_GMR     0x20  /* Internal window operations                  */
+
+/* Every profiled operation and its category */
+#define ARMCII_PROF_FUNCS(X)                    \
+    X(PARMCI_Put,             PROF_CAT_RMA)     \
+    X(PARMCI_Get,             PROF_CAT_RMA)     \
+    X(PARMCI_Acc,             PROF_CAT_RMA)     \
+    X(PARMCI_Put_flag,        PROF_CAT_RMA)     \
+    X(PARMCI_PutS,            PROF_CAT_RMA)     \
+    X(PARMCI_GetS,            PROF_CAT_RMA)     \
+    X(PARMCI_AccS,            PROF_CAT_RMA)     \
+    X(PARMCI_PutS_flag,       PROF_CAT_RMA)     \
+    X(PARMCI_PutV,            PROF_CAT_RMA)     \
+    X(PARMCI_GetV,            PROF_CAT_RMA)     \
+    X(PARMCI_AccV,            PROF_CAT_RMA)     \
+    X(PARMCI_PutValueInt,     PROF_CAT_RMA)     \
+    X(PARMCI_PutValueLong,    PROF_CAT_RMA)     \
+    X(PARMCI_PutValueFloat,   PROF_CAT_RMA)     \
+    X(PARMCI_PutValueDouble,  PROF_CAT_RMA)     \
+    X(PARMCI_GetValueInt,     PROF_CAT_RMA)     \
+    X(PARMCI_GetValueLong,    PROF_CAT_RMA)     \
+    X(PARMCI_GetValueFloat,   PROF_CAT_RMA)     \
+    X(PARMCI_GetValueDouble,  PROF_CAT_RMA)     \
+    X(PARMCI_NbPut,           PROF_CAT_NB)      \
+    X(PARMCI_NbGet,           PROF_CAT_NB)      \
+    X(PARMCI_NbAcc,           PROF_CAT_NB)      \
+    X(PARMCI_NbPutS,          PROF_CAT_NB)      \
+    X(PARMCI_NbGetS,          PROF_CAT_NB)      \
+    X(PARMCI_NbAccS,          PROF_CAT_NB)      \
+    X(PARMCI_NbPutV,          PROF_CAT_NB)      \
+    X(PARMCI_NbGetV,          PROF_CAT_NB)      \
+    X(PARMCI_NbAccV,          PROF_CAT_NB)      \
+    X(PARMCI_NbPutValueInt,   PROF_CAT_NB)      \
+    X(PARMCI_NbPutValueLong,  PROF_CAT_NB)      \
+    X(PARMCI_NbPutValueFloat, PROF_CAT_NB)      \
+    X(PARMCI_NbPutValueDouble,PROF_CAT_NB)      \
+    X(PARMCI_Wait,            PROF_CAT_NB)      \
+    X(PARMCI_Test,            PROF_CAT_NB)      \
+    X(PARMCI_WaitProc,        PROF_CAT_NB)      \
+    X(PARMCI_WaitAll,         PROF_CAT_NB)      \
+    X(PARMCI_Barrier,         PROF_CAT_SYNC)    \
+    X(PARMCI_Fence,           PROF_CAT_SYNC)    \
+    X(PARMCI_AllFence,        PROF_CAT_SYNC)    \
+    X(ARMCIX_Barrier_group,   PROF_CAT_SYNC)    \
+    X(ARMCIX_AllFence_group,  PROF_CAT_SYNC)    \
+    X(PARMCI_Access_begin,    PROF_CAT_SYNC)    \
+    X(PARMCI_Access_end,      PROF_CAT_SYNC)    \
+    X(PARMCI_Rmw,             PROF_CAT_ATOMIC)  \
+    X(PARMCI_Create_mutexes,  PROF_CAT_ATOMIC)  \
+    X(PARMCI_Destroy_mutexes, PROF_CAT_ATOMIC)  \
+    X(PARMCI_Lock,            PROF_CAT_ATOMIC)  \
+    X(PARMCI_Unlock,          PROF_CAT_ATOMIC)  \
+    X(PARMCI_Malloc,          PROF_CAT_ALLOC)   \
+    X(PARMCI_Free,            PROF_CAT_ALLOC)   \
+    X(PARMCI_Malloc_local,    PROF_CAT_ALLOC)   \
+    X(PARMCI_Free_local,      PROF_CAT_ALLOC)   \
+    X(gmr_create,             PROF_CAT_GMR)     \
+    X(gmr_destroy,            PROF_CAT_GMR)     \
+    X(gmr_flushall_trans,     PROF_CAT_GMR)     \
+    X(gmr_flushall,           PROF_CAT_GMR)     \
+    X(gmr_flush_trans,        PROF_CAT_GMR)     \
+    X(gmr_flush,              PROF_CAT_GMR)
+
+#define ARMCII_PROF_ENUM(func, cat) PROF_##func,
 enum ARMCI_Profile_func {
-    PROF_PARMCI_GetS,
-    PROF_PARMCI_Get,
-    PROF_PARMCI_AccS,
-    PROF_PARMCI_Acc,
-    PROF_PARMCI_NbGetS,
-    PROF_PARMCI_NbGet,
-    PROF_PARMCI_Rmw,
-    PROF_PARMCI_Barrier,
-    PROF_PARMCI_AllFence,
-    PROF_PARMCI_WaitAll,
-    PROF_PARMCI_Wait,
-    PROF_gmr_create,
-    PROF_gmr_destroy,
-    PROF_gmr_flushall_trans,
-    PROF_gmr_flushall,
-    PROF_gmr_flush_trans,
-    PROF_gmr_flush,
+    ARMCII_PROF_FUNCS(ARMCII_PROF_ENUM)
     PROF_MAX_NUM_PROFILE_FUNC
 };
+#undef ARMCII_PROF_ENUM
 
-extern int profile_global_var_nproc;
-extern int prof_counters[MAX_NPROC * PROF_MAX_NUM_PROFILE_FUNC];
-extern double prof_timings[PROF_MAX_NUM_PROFILE_FUNC];
+/* Histogram bin b counts values in [2^(b-1), 2^b), bin 0 counts zeros */
+#define PROF_NBINS 48
+
+typedef uint64_t armcii_prof_tick_t;
+
+/** Read the cycle counter, or a nanosecond clock where there is none.
+  */
+static inline armcii_prof_tick_t ARMCII_Prof_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t lo, hi;
+    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+    return ((uint64_t) hi << 32) | lo;
+#elif defined(__aarch64__)
+    uint64_t t;
+    __asm__ __volatile__ ("mrs %0, cntvct_el0" : "=r" (t));
+    return t;
+#else
+    return (armcii_prof_tick_t) (MPI_Wtime() * 1.0e9);
+#endif
+}
+
+extern char ARMCII_Prof_enabled[PROF_MAX_NUM_PROFILE_FUNC];
+
+extern int  ARMCII_Prof_tracing;
+
+void ARMCII_Prof_record_time(int func, armcii_prof_tick_t start, armcii_prof_tick_t end);
+void ARMCII_Prof_record_xfer(int func, int target, int64_t bytes);
+void ARMCII_Prof_record_window(int func, MPI_Win win);
 
 extern void ARMCI_Profile_destroy();
 extern void ARMCI_Profile_init();
@@ -42,18 +151,30 @@ extern void ARMCI_Profile_init();
 #define ARMCI_PROFILE_INIT ARMCI_Profile_init
 #define ARMCI_PROFILE_DESTROY ARMCI_Profile_destroy
 
-#define ARMCI_FUNC_PROFILE_TIMING_START(func) double _profile_##func##_time_start = MPI_Wtime();
-#define ARMCI_FUNC_PROFILE_TIMING_END(func) {   \
-    ARMCII_Assert(PROF_##func < MAX_NPROC);	\
-    if (PROF_##func >= 0 && PROF_##func < PROF_MAX_NUM_PROFILE_FUNC) \
-        prof_timings[PROF_##func] += MPI_Wtime() - _profile_##func##_time_start;   \
-}
+#define ARMCI_FUNC_PROFILE_TIMING_START(func)                           \
+    armcii_prof_tick_t _profile_##func##_time_start =                   \
+        ARMCII_Prof_enabled[PROF_##func] ? ARMCII_Prof_ticks() : 0;
+
+#define ARMCI_FUNC_PROFILE_TIMING_END(func)                             \
+    do {                                                                \
+        if (ARMCII_Prof_enabled[PROF_##func])                           \
+            ARMCII_Prof_record_time(PROF_##func,                        \
+                _profile_##func##_time_start, ARMCII_Prof_ticks());     \
+    } while (0)
+
+/* Record a transfer of bytes to target (-1 for operations without one) */
+#define ARMCI_FUNC_PROFILE_COUNTER_INC(func, target, bytes)             \
+    do {                                                                \
+        if (ARMCII_Prof_enabled[PROF_##func])                           \
+            ARMCII_Prof_record_xfer(PROF_##func, target, bytes);        \
+    } while (0)
 
-#define ARMCI_FUNC_PROFILE_COUNTER_INC(func, target) {  \
-    	ARMCII_Assert(target * PROF_MAX_NUM_PROFILE_FUNC + PROF_##func < MAX_NPROC * PROF_MAX_NUM_PROFILE_FUNC);	\
-        if (PROF_##func >= 0 && PROF_##func < PROF_MAX_NUM_PROFILE_FUNC) \
-            prof_counters[target * PROF_MAX_NUM_PROFILE_FUNC + PROF_##func]++;   \
-    }
+/* Tag the traced event of an operation with the window it used */
+#define ARMCI_FUNC_PROFILE_WINDOW(func, win)                            \
+    do {                                                                \
+        if (ARMCII_Prof_tracing && ARMCII_Prof_enabled[PROF_##func])    \
+            ARMCII_Prof_record_window(PROF_##func, win);                \
+    } while (0)
 
 extern void ARMCI_Profile_reset_counter();
 extern void ARMCI_Profile_reset_timing();
@@ -64,7 +185,8 @@ extern void ARMCI_Profile_print_counter(char *name);
 #define ARMCI_PROFILE_DESTROY()
 #define ARMCI_FUNC_PROFILE_TIMING_START(func)
 #define ARMCI_FUNC_PROFILE_TIMING_END(func)
-#define ARMCI_FUNC_PROFILE_COUNTER_INC(func, target)
+#define ARMCI_FUNC_PROFILE_COUNTER_INC(func, target, bytes)
+#define ARMCI_FUNC_PROFILE_WINDOW(func, win)
 
 #endif
 #endif /* PROFILE_H_ */
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <armciconf.h>
 #include "profile.h"
 
 #ifdef ENABLE_PROFILE
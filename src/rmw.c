@@ -6,6 +6,7 @@
 #include <stdlib.h>
 
 #include <armci.h>
+#include <armcix.h>
 #include <armci_internals.h>
 #include <gmr.h>
 #include <debug.h>
@@ -45,7 +46,7 @@ int PARMCI_Rmw(int op, void *ploc, void *prem, int value, int proc) {
   gmr_t *src_mreg, *dst_mreg;
 
   ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Rmw);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Rmw, proc);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Rmw, proc, 0);
 
   /* If NOGUARD is set, assume the buffer is not shared */
   if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD)
@@ -68,6 +69,8 @@ int PARMCI_Rmw(int op, void *ploc, void *prem, int value, int proc) {
   else
     type = MPI_INT;
 
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_RMW, proc, is_long ? sizeof(long) : sizeof(int));
+
   if (op == ARMCI_SWAP || op == ARMCI_SWAP_LONG) {
     is_swap = 1;
     rop = MPI_REPLACE;
@@ -113,3 +116,236 @@ int PARMCI_Rmw(int op, void *ploc, void *prem, int value, int proc) {
 
   return 0;
 }
+
+
+/** One element of a batched read-modify-write operation.
+  */
+typedef struct {
+  gmr_t *mreg;
+  int    proc;
+  int    idx;
+  union { int i; long l; } src;
+  union { int i; long l; } out;
+} rmw_batch_elem_t;
+
+
+/** Order batch elements by window and then target, keeping the original order
+  * within each (window, target) group.
+  */
+static int rmw_batch_cmp(const void *a, const void *b) {
+  const rmw_batch_elem_t *x = a;
+  const rmw_batch_elem_t *y = b;
+
+  if (x->mreg != y->mreg)
+    return ((uintptr_t) x->mreg < (uintptr_t) y->mreg) ? -1 : 1;
+  else if (x->proc != y->proc)
+    return x->proc - y->proc;
+  else
+    return x->idx - y->idx;
+}
+
+
+/** Perform a batch of atomic read-modify-write operations.  All operations are
+  * issued before any of them is completed, and every touched (window, target)
+  * pair is flushed once.  Operations in the batch are not ordered with respect
+  * to each other, except for those on the same target and window.
+  *
+  * @param[in]  ops    Operations to be performed (see ARMCI_Rmw)
+  * @param[out] ploc   Locations to store the original values (also the source
+  *                    values for swap operations)
+  * @param[in]  prem   Locations on which to perform the atomic operations
+  * @param[in]  values Values to add to the remote locations (ignored for swap)
+  * @param[in]  procs  Process ranks for the target buffers
+  * @param[in]  n      Number of operations in the batch
+  */
+int ARMCIX_Rmw_batch(int *ops, void **ploc, void **prem, int *values, int *procs, int n) {
+  int i;
+  rmw_batch_elem_t *elems;
+
+  if (n <= 0) return 0;
+
+  elems = malloc(n*sizeof(rmw_batch_elem_t));
+  ARMCII_Assert(elems != NULL);
+
+  for (i = 0; i < n; i++) {
+    /* Consecutive operations often target the same allocation */
+    if (i > 0 && procs[i] == procs[i-1]) {
+      gmr_t *prev = elems[i-1].mreg;
+      const uint8_t *base = prev->slices[procs[i]].base;
+
+      if ((uint8_t*) prem[i] >= base && (uint8_t*) prem[i] < base + prev->slices[procs[i]].size)
+        elems[i].mreg = prev;
+      else
+        elems[i].mreg = gmr_lookup(prem[i], procs[i]);
+    } else {
+      elems[i].mreg = gmr_lookup(prem[i], procs[i]);
+    }
+
+    ARMCII_Assert_msg(elems[i].mreg != NULL, "Invalid remote pointer");
+
+    elems[i].proc = procs[i];
+    elems[i].idx  = i;
+
+    ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_RMW, procs[i],
+        (ops[i] == ARMCI_FETCH_AND_ADD_LONG || ops[i] == ARMCI_SWAP_LONG) ? sizeof(long) : sizeof(int));
+
+    switch (ops[i]) {
+      case ARMCI_FETCH_AND_ADD:
+        elems[i].src.i = values[i];
+        break;
+      case ARMCI_FETCH_AND_ADD_LONG:
+        elems[i].src.l = values[i];
+        break;
+      case ARMCI_SWAP:
+        elems[i].src.i = *(int*) ploc[i];
+        break;
+      case ARMCI_SWAP_LONG:
+        elems[i].src.l = *(long*) ploc[i];
+        break;
+      default:
+        ARMCII_Error("invalid operation (%d)", ops[i]);
+    }
+  }
+
+  qsort(elems, n, sizeof(rmw_batch_elem_t), rmw_batch_cmp);
+
+  for (i = 0; i < n; i++) {
+    const int op      = ops[elems[i].idx];
+    const int is_long = (op == ARMCI_FETCH_AND_ADD_LONG || op == ARMCI_SWAP_LONG);
+    const int is_swap = (op == ARMCI_SWAP || op == ARMCI_SWAP_LONG);
+
+    gmr_fetch_and_op(elems[i].mreg,
+                     is_long ? (void*) &elems[i].src.l : (void*) &elems[i].src.i,
+                     is_long ? (void*) &elems[i].out.l : (void*) &elems[i].out.i,
+                     prem[elems[i].idx], is_long ? MPI_LONG : MPI_INT,
+                     is_swap ? MPI_REPLACE : MPI_SUM, elems[i].proc);
+  }
+
+  for (i = 0; i < n; i++) {
+    if (i == 0 || elems[i].mreg != elems[i-1].mreg || elems[i].proc != elems[i-1].proc)
+      gmr_flush(elems[i].mreg, elems[i].proc, 0); /* round trip, local=remote */
+  }
+
+  for (i = 0; i < n; i++) {
+    const int op = ops[elems[i].idx];
+
+    if (op == ARMCI_FETCH_AND_ADD_LONG || op == ARMCI_SWAP_LONG)
+      *(long*) ploc[elems[i].idx] = elems[i].out.l;
+    else
+      *(int*) ploc[elems[i].idx] = elems[i].out.i;
+  }
+
+  free(elems);
+
+  return 0;
+}
+
+
+/** Perform an extended atomic read-modify-write operation on the given
+  * location and return the location's original value.  Operations are atomic
+  * with respect to other ARMCI_Rmw and ARMCIX_Rmw_ext operations on the same
+  * type, but not with respect to other one-sided operations.
+  *
+  * @param[in]  op      Operation to be performed (see armcix_rmw_op_e)
+  * @param[in]  type    Type of the location (see armcix_rmw_type_e)
+  * @param[out] ploc    Location to store the original value (may be NULL for
+  *                     ARMCIX_RMW_WRITE)
+  * @param[in]  prem    Location on which to perform the atomic operation
+  * @param[in]  value   Operand (ignored for ARMCIX_RMW_READ)
+  * @param[in]  compare Value to compare with (ARMCIX_RMW_CAS only)
+  * @param[in]  proc    Process rank for the target buffer
+  */
+int ARMCIX_Rmw_ext(int op, int type, void *ploc, void *prem, void *value, void *compare, int proc) {
+  union { int i; long l; int64_t i64; float f; double d; } src, cmp, out;
+  MPI_Datatype mpi_type;
+  MPI_Op       rop = MPI_NO_OP;
+  int          size, is_integer;
+  gmr_t       *dst_mreg;
+
+  dst_mreg = gmr_lookup(prem, proc);
+  ARMCII_Assert_msg(dst_mreg != NULL, "Invalid remote pointer");
+
+  switch (type) {
+    case ARMCIX_RMW_INT:
+      mpi_type = MPI_INT;
+      size     = sizeof(int);
+      break;
+    case ARMCIX_RMW_LONG:
+      mpi_type = MPI_LONG;
+      size     = sizeof(long);
+      break;
+    case ARMCIX_RMW_INT64:
+      mpi_type = MPI_INT64_T;
+      size     = sizeof(int64_t);
+      break;
+    case ARMCIX_RMW_FLOAT:
+      mpi_type = MPI_FLOAT;
+      size     = sizeof(float);
+      break;
+    case ARMCIX_RMW_DOUBLE:
+      mpi_type = MPI_DOUBLE;
+      size     = sizeof(double);
+      break;
+    default:
+      ARMCII_Error("invalid type (%d)", type);
+      return 1;
+  }
+
+  is_integer = (type == ARMCIX_RMW_INT || type == ARMCIX_RMW_LONG || type == ARMCIX_RMW_INT64);
+
+  switch (op) {
+    case ARMCIX_RMW_CAS:
+      ARMCII_Assert_msg(is_integer, "Compare-and-swap requires an integer type");
+      break;
+    case ARMCIX_RMW_FETCH_AND_ADD:
+      rop = MPI_SUM;
+      break;
+    case ARMCIX_RMW_FETCH_AND_MIN:
+      rop = MPI_MIN;
+      break;
+    case ARMCIX_RMW_FETCH_AND_MAX:
+      rop = MPI_MAX;
+      break;
+    case ARMCIX_RMW_FETCH_AND_BAND:
+      ARMCII_Assert_msg(is_integer, "Bitwise operations require an integer type");
+      rop = MPI_BAND;
+      break;
+    case ARMCIX_RMW_FETCH_AND_BOR:
+      ARMCII_Assert_msg(is_integer, "Bitwise operations require an integer type");
+      rop = MPI_BOR;
+      break;
+    case ARMCIX_RMW_FETCH_AND_BXOR:
+      ARMCII_Assert_msg(is_integer, "Bitwise operations require an integer type");
+      rop = MPI_BXOR;
+      break;
+    case ARMCIX_RMW_READ:
+      rop = MPI_NO_OP;
+      break;
+    case ARMCIX_RMW_WRITE:
+      rop = MPI_REPLACE;
+      break;
+    default:
+      ARMCII_Error("invalid operation (%d)", op);
+      return 1;
+  }
+
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_RMW, proc, size);
+
+  /* Operands may live in shared buffers, so copy them to private storage */
+  if (op != ARMCIX_RMW_READ)
+    ARMCI_Copy(value, &src, size);
+  if (op == ARMCIX_RMW_CAS)
+    ARMCI_Copy(compare, &cmp, size);
+
+  if (op == ARMCIX_RMW_CAS)
+    gmr_compare_and_swap(dst_mreg, &src, &cmp, &out, prem, mpi_type, proc);
+  else
+    gmr_fetch_and_op(dst_mreg, &src, &out, prem, mpi_type, rop, proc);
+
+  gmr_flush(dst_mreg, proc, 0); /* it's a round trip so w.r.t. flush, local=remote */
+
+  if (ploc != NULL)
+    ARMCI_Copy(&out, ploc, size);
+
+  return 0;
+}
@@ -0,0 +1,458 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+/* Reader-writer locks built on MPI-3 fetch-and-op.  All locks in a group live
+ * in a single window that is locked with lock_all for the lifetime of the
+ * group.  Each lock is a 64-bit state word, plus 32-bit ticket and serving
+ * counters that are only used in FIFO mode.  The state word holds:
+ *
+ *   bits  0..20  Number of readers holding (or trying to acquire) the lock
+ *   bits 21..41  Number of writers holding or trying to become the active writer
+ *   bits 42..62  Number of waiting writers (writer preference only)
+ *
+ * Each process adds at most one to each field per lock it is acquiring, so
+ * the fields hold up to 2M contenders without carrying into each other.
+ *
+ * A reader adds one to the reader count and holds the lock if no writer was
+ * active.  With writer preference, a reader that finds a writer active or
+ * waiting backs out and retries, and a writer holds the lock once it was the
+ * only writer and all readers have left.  With reader preference, a writer
+ * holds the lock only if it found neither readers nor writers, and otherwise
+ * backs out and retries, while a reader that finds a writer keeps its count
+ * in place and waits for the writer to leave.  Readers thus never yield to a
+ * writer that has not acquired the lock, so the two cannot livelock, though
+ * writers may wait for as long as readers keep the lock busy.  In FIFO mode,
+ * processes first take a ticket and wait for it to be served; readers serve
+ * the next ticket as soon as they hold the lock, so consecutive readers share
+ * it, while writers serve the next ticket when they release it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+
+#include <armci.h>
+#include <armci_internals.h>
+#include <armcix.h>
+#include <debug.h>
+
+/* Layout of each lock in the window, in bytes.  The ticket and serving
+ * counters are only compared for equality, so they may wrap around. */
+#define RW_STATE         0
+#define RW_TICKET        8
+#define RW_SERVING       12
+#define RW_LOCK_SIZE     16
+
+#define RW_READER        ((int64_t)1)
+#define RW_WRITER        ((int64_t)1 << 21)
+#define RW_WAITING       ((int64_t)1 << 42)
+
+#define RW_FIELD_MASK    0x1fffffLL
+#define RW_READERS(s)    ((s) & RW_FIELD_MASK)
+#define RW_WRITERS(s)    (((s) >> 21) & RW_FIELD_MASK)
+#define RW_WAITERS(s)    (((s) >> 42) & RW_FIELD_MASK)
+
+/* Modes recorded in the table of held locks */
+#define RW_MODE_READ     1
+#define RW_MODE_WRITE    2
+
+
+/** Atomically add to the state word of a lock and return its old value.
+  */
+static int64_t rw_fadd(armcix_rwlock_hdl_t hdl, int lock, int proc, int64_t val) {
+  int64_t out;
+
+  MPI_Fetch_and_op(&val, &out, MPI_INT64_T, proc, lock*RW_LOCK_SIZE + RW_STATE, MPI_SUM, hdl->window);
+  MPI_Win_flush(proc, hdl->window);
+
+  return out;
+}
+
+
+/** Atomically read the state word of a lock.
+  */
+static int64_t rw_read(armcix_rwlock_hdl_t hdl, int lock, int proc) {
+  int64_t out, dummy = 0;
+
+  MPI_Fetch_and_op(&dummy, &out, MPI_INT64_T, proc, lock*RW_LOCK_SIZE + RW_STATE, MPI_NO_OP, hdl->window);
+  MPI_Win_flush(proc, hdl->window);
+
+  return out;
+}
+
+
+/** Atomically add to the ticket or serving counter of a lock and return its
+  * old value.
+  */
+static int rw_turn_fadd(armcix_rwlock_hdl_t hdl, int lock, int word, int proc, int val) {
+  int out;
+
+  MPI_Fetch_and_op(&val, &out, MPI_INT, proc, lock*RW_LOCK_SIZE + word, MPI_SUM, hdl->window);
+  MPI_Win_flush(proc, hdl->window);
+
+  return out;
+}
+
+
+/** Atomically replace the ticket or serving counter of a lock if it holds
+  * the given value, and return its old value.
+  */
+static int rw_turn_cas(armcix_rwlock_hdl_t hdl, int lock, int word, int proc, int compare, int val) {
+  int out;
+
+  MPI_Compare_and_swap(&val, &compare, &out, MPI_INT, proc, lock*RW_LOCK_SIZE + word, hdl->window);
+  MPI_Win_flush(proc, hdl->window);
+
+  return out;
+}
+
+
+/** Check whether a reader that saw the given state word may hold the lock.
+  */
+static int rw_read_ok(armcix_rwlock_hdl_t hdl, int64_t state) {
+  return RW_WRITERS(state) == 0 &&
+         (!(hdl->flags & ARMCIX_RWLOCK_WRITER_PREF) || RW_WAITERS(state) == 0);
+}
+
+
+/** Take the next ticket if it is being served (FIFO mode).
+  *
+  * @return Non-zero if the ticket was taken, zero if others are waiting
+  */
+static int rw_try_turn(armcix_rwlock_hdl_t hdl, int lock, int proc) {
+  const int serving = rw_turn_fadd(hdl, lock, RW_SERVING, proc, 0);
+
+  return rw_turn_cas(hdl, lock, RW_TICKET, proc, serving, serving+1) == serving;
+}
+
+
+/** Wait for my ticket to be served (FIFO mode).
+  */
+static void rw_wait_turn(armcix_rwlock_hdl_t hdl, int lock, int proc) {
+  const int ticket = rw_turn_fadd(hdl, lock, RW_TICKET, proc, 1);
+  int serving;
+
+  while ((serving = rw_turn_fadd(hdl, lock, RW_SERVING, proc, 0)) != ticket)
+    ARMCII_Backoff((unsigned) (ticket - serving));
+}
+
+
+/** Record that I hold a lock.
+  */
+static void rw_held_add(armcix_rwlock_hdl_t hdl, int lock, int proc, int mode) {
+  if (hdl->nheld == hdl->max_held) {
+    hdl->max_held = hdl->max_held ? 2*hdl->max_held : 8;
+    hdl->held     = realloc(hdl->held, 3*hdl->max_held*sizeof(int));
+    ARMCII_Assert(hdl->held != NULL);
+  }
+
+  hdl->held[3*hdl->nheld]   = lock;
+  hdl->held[3*hdl->nheld+1] = proc;
+  hdl->held[3*hdl->nheld+2] = mode;
+  hdl->nheld++;
+}
+
+
+/** Remove a lock from the table of held locks and return the mode in which
+  * it was held.
+  */
+static int rw_held_remove(armcix_rwlock_hdl_t hdl, int lock, int proc) {
+  int i, mode;
+
+  for (i = 0; i < hdl->nheld; i++) {
+    if (hdl->held[3*i] == lock && hdl->held[3*i+1] == proc) {
+      mode = hdl->held[3*i+2];
+
+      hdl->nheld--;
+      hdl->held[3*i]   = hdl->held[3*hdl->nheld];
+      hdl->held[3*i+1] = hdl->held[3*hdl->nheld+1];
+      hdl->held[3*i+2] = hdl->held[3*hdl->nheld+2];
+
+      return mode;
+    }
+  }
+
+  ARMCII_Error("attempted to unlock a rwlock that is not held [proc = %d, lock = %d]", proc, lock);
+  return 0;
+}
+
+
+/** Create a group of reader-writer locks.  Collective on the ARMCI group.
+  *
+  * @param[in] count  Number of locks on the local process.
+  * @param[in] pgroup ARMCI group on which to create the locks
+  * @param[in] flags  Bitwise or of ARMCIX_RWLOCK_* flags (same on all processes)
+  * @return           Handle to the lock group.
+  */
+armcix_rwlock_hdl_t ARMCIX_Create_rwlocks_hdl(int count, ARMCI_Group *pgroup, int flags) {
+  int i, max_count;
+  armcix_rwlock_hdl_t hdl;
+
+  hdl = malloc(sizeof(struct armcix_rwlock_hdl_s));
+  ARMCII_Assert(hdl != NULL);
+
+  ARMCIX_Group_dup(pgroup, &hdl->grp);
+
+  MPI_Allreduce(&count, &max_count, 1, MPI_INT, MPI_MAX, hdl->grp.comm);
+  ARMCII_Assert_msg(max_count > 0, "Invalid number of rwlocks");
+
+  hdl->my_count  = count;
+  hdl->max_count = max_count;
+  hdl->flags     = flags;
+  hdl->held      = NULL;
+  hdl->nheld     = 0;
+  hdl->max_held  = 0;
+
+  MPI_Win_allocate(count*RW_LOCK_SIZE, 1, MPI_INFO_NULL, hdl->grp.comm, &hdl->base, &hdl->window);
+
+  for (i = 0; i < count*RW_LOCK_SIZE/(int)sizeof(int64_t); i++)
+    hdl->base[i] = 0;
+
+  MPI_Win_lock_all(0, hdl->window);
+  MPI_Win_sync(hdl->window);
+  MPI_Barrier(hdl->grp.comm);
+
+  return hdl;
+}
+
+
+/** Destroy a group of reader-writer locks.  Collective.
+  *
+  * @param[in] hdl Handle to the group that should be destroyed.
+  * @return        Zero on success, non-zero otherwise.
+  */
+int ARMCIX_Destroy_rwlocks_hdl(armcix_rwlock_hdl_t hdl) {
+  MPI_Win_unlock_all(hdl->window);
+  MPI_Win_free(&hdl->window);
+
+  ARMCI_Group_free(&hdl->grp);
+  free(hdl->held);
+  free(hdl);
+
+  return 0;
+}
+
+
+/** Lock a reader-writer lock for reading.  Without contention from writers,
+  * this takes a single fetch-and-add.
+  *
+  * @param[in] hdl        Lock group that the lock belongs to.
+  * @param[in] lock       Desired lock number [0..count-1]
+  * @param[in] world_proc Absolute ID of process where the lock lives
+  */
+void ARMCIX_Rdlock_hdl(armcix_rwlock_hdl_t hdl, int lock, int world_proc) {
+  int proc;
+
+  ARMCII_Assert(lock >= 0 && lock < hdl->max_count);
+
+  proc = ARMCII_Translate_absolute_to_group(&hdl->grp, world_proc);
+  ARMCII_Assert(proc >= 0);
+
+  if (hdl->flags & ARMCIX_RWLOCK_FAIR) {
+    /* The writer before me has released the lock: hold it and let the next
+       process in */
+    rw_wait_turn(hdl, lock, proc);
+    rw_fadd(hdl, lock, proc, RW_READER);
+    rw_turn_fadd(hdl, lock, RW_SERVING, proc, 1);
+  }
+  else if (hdl->flags & ARMCIX_RWLOCK_WRITER_PREF) {
+    for (;;) {
+      int64_t state = rw_fadd(hdl, lock, proc, RW_READER);
+
+      if (rw_read_ok(hdl, state))
+        break;
+
+      /* A writer holds or wants the lock: back out and wait for it */
+      rw_fadd(hdl, lock, proc, -RW_READER);
+
+      do {
+        ARMCII_Backoff(RW_WRITERS(state) + RW_WAITERS(state));
+        state = rw_read(hdl, lock, proc);
+      } while (!rw_read_ok(hdl, state));
+    }
+  }
+  else {
+    /* Readers have priority: keep my place, so that writers that have not
+       acquired the lock back out, and wait for an active writer to leave */
+    int64_t state = rw_fadd(hdl, lock, proc, RW_READER);
+
+    while (RW_WRITERS(state) != 0) {
+      ARMCII_Backoff(RW_WRITERS(state));
+      state = rw_read(hdl, lock, proc);
+    }
+  }
+
+  rw_held_add(hdl, lock, proc, RW_MODE_READ);
+
+  ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "read lock acquired [proc = %d, lock = %d]\n", proc, lock);
+}
+
+
+/** Lock a reader-writer lock for writing.
+  *
+  * @param[in] hdl        Lock group that the lock belongs to.
+  * @param[in] lock       Desired lock number [0..count-1]
+  * @param[in] world_proc Absolute ID of process where the lock lives
+  */
+void ARMCIX_Wrlock_hdl(armcix_rwlock_hdl_t hdl, int lock, int world_proc) {
+  int proc;
+  int64_t state;
+
+  ARMCII_Assert(lock >= 0 && lock < hdl->max_count);
+
+  proc = ARMCII_Translate_absolute_to_group(&hdl->grp, world_proc);
+  ARMCII_Assert(proc >= 0);
+
+  if (hdl->flags & ARMCIX_RWLOCK_FAIR) {
+    /* Readers ahead of me may still hold the lock: wait for them to leave */
+    rw_wait_turn(hdl, lock, proc);
+    state = rw_fadd(hdl, lock, proc, RW_WRITER);
+
+    while (RW_READERS(state) != 0) {
+      ARMCII_Backoff(RW_READERS(state));
+      state = rw_read(hdl, lock, proc);
+    }
+  }
+  else if (hdl->flags & ARMCIX_RWLOCK_WRITER_PREF) {
+    /* Announce myself so that new readers hold off, become the active
+       writer, then wait for the readers to drain */
+    rw_fadd(hdl, lock, proc, RW_WAITING);
+
+    while (RW_WRITERS(state = rw_fadd(hdl, lock, proc, RW_WRITER)) != 0) {
+      rw_fadd(hdl, lock, proc, -RW_WRITER);
+      ARMCII_Backoff(RW_WRITERS(state));
+    }
+
+    state = rw_fadd(hdl, lock, proc, -RW_WAITING);
+
+    while (RW_READERS(state) != 0) {
+      ARMCII_Backoff(RW_READERS(state));
+      state = rw_read(hdl, lock, proc);
+    }
+  }
+  else {
+    /* Readers have priority: only take the lock when it is free */
+    for (;;) {
+      state = rw_fadd(hdl, lock, proc, RW_WRITER);
+
+      if (RW_WRITERS(state) == 0 && RW_READERS(state) == 0)
+        break;
+
+      rw_fadd(hdl, lock, proc, -RW_WRITER);
+      ARMCII_Backoff(RW_WRITERS(state) + RW_READERS(state));
+    }
+  }
+
+  rw_held_add(hdl, lock, proc, RW_MODE_WRITE);
+
+  ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "write lock acquired [proc = %d, lock = %d]\n", proc, lock);
+}
+
+
+/** Try to lock a reader-writer lock for reading, without waiting.
+  *
+  * @param[in] hdl        Lock group that the lock belongs to.
+  * @param[in] lock       Desired lock number [0..count-1]
+  * @param[in] world_proc Absolute ID of process where the lock lives
+  * @return               Zero if the lock was acquired, non-zero otherwise
+  */
+int ARMCIX_Tryrdlock_hdl(armcix_rwlock_hdl_t hdl, int lock, int world_proc) {
+  int proc;
+
+  ARMCII_Assert(lock >= 0 && lock < hdl->max_count);
+
+  proc = ARMCII_Translate_absolute_to_group(&hdl->grp, world_proc);
+  ARMCII_Assert(proc >= 0);
+
+  if (hdl->flags & ARMCIX_RWLOCK_FAIR) {
+    if (!rw_try_turn(hdl, lock, proc))
+      return 1;
+
+    rw_fadd(hdl, lock, proc, RW_READER);
+    rw_turn_fadd(hdl, lock, RW_SERVING, proc, 1);
+  }
+  else if (!rw_read_ok(hdl, rw_fadd(hdl, lock, proc, RW_READER))) {
+    rw_fadd(hdl, lock, proc, -RW_READER);
+    return 1;
+  }
+
+  rw_held_add(hdl, lock, proc, RW_MODE_READ);
+
+  ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "read lock acquired [proc = %d, lock = %d]\n", proc, lock);
+
+  return 0;
+}
+
+
+/** Try to lock a reader-writer lock for writing, without waiting.
+  *
+  * @param[in] hdl        Lock group that the lock belongs to.
+  * @param[in] lock       Desired lock number [0..count-1]
+  * @param[in] world_proc Absolute ID of process where the lock lives
+  * @return               Zero if the lock was acquired, non-zero otherwise
+  */
+int ARMCIX_Trywrlock_hdl(armcix_rwlock_hdl_t hdl, int lock, int world_proc) {
+  int proc;
+
+  ARMCII_Assert(lock >= 0 && lock < hdl->max_count);
+
+  proc = ARMCII_Translate_absolute_to_group(&hdl->grp, world_proc);
+  ARMCII_Assert(proc >= 0);
+
+  if (hdl->flags & ARMCIX_RWLOCK_FAIR) {
+    if (!rw_try_turn(hdl, lock, proc))
+      return 1;
+
+    /* Readers served before me still hold the lock: pass my turn on */
+    if (RW_READERS(rw_fadd(hdl, lock, proc, RW_WRITER)) != 0) {
+      rw_fadd(hdl, lock, proc, -RW_WRITER);
+      rw_turn_fadd(hdl, lock, RW_SERVING, proc, 1);
+      return 1;
+    }
+  }
+  else {
+    const int64_t state = rw_fadd(hdl, lock, proc, RW_WRITER);
+
+    if (RW_WRITERS(state) != 0 || RW_READERS(state) != 0) {
+      rw_fadd(hdl, lock, proc, -RW_WRITER);
+      return 1;
+    }
+  }
+
+  rw_held_add(hdl, lock, proc, RW_MODE_WRITE);
+
+  ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "write lock acquired [proc = %d, lock = %d]\n", proc, lock);
+
+  return 0;
+}
+
+
+/** Unlock a reader-writer lock held for reading or writing.
+  *
+  * @param[in] hdl        Lock group that the lock belongs to.
+  * @param[in] lock       Desired lock number [0..count-1]
+  * @param[in] world_proc Absolute ID of process where the lock lives
+  */
+void ARMCIX_Rwunlock_hdl(armcix_rwlock_hdl_t hdl, int lock, int world_proc) {
+  int proc, mode;
+
+  ARMCII_Assert(lock >= 0 && lock < hdl->max_count);
+
+  proc = ARMCII_Translate_absolute_to_group(&hdl->grp, world_proc);
+  ARMCII_Assert(proc >= 0);
+
+  mode = rw_held_remove(hdl, lock, proc);
+
+  if (mode == RW_MODE_READ) {
+    rw_fadd(hdl, lock, proc, -RW_READER);
+  }
+  else {
+    rw_fadd(hdl, lock, proc, -RW_WRITER);
+
+    if (hdl->flags & ARMCIX_RWLOCK_FAIR)
+      rw_turn_fadd(hdl, lock, RW_SERVING, proc, 1);
+  }
+
+  ARMCII_Dbg_print(DEBUG_CAT_MUTEX, "lock released [proc = %d, lock = %d, mode = %d]\n", proc, lock, mode);
+}
@@ -113,11 +113,16 @@ int PARMCI_PutS(void *src_ptr, int src_stride_ar[/*stride_levels*/],
 
   int err;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_PutS);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_PutS, proc, ARMCII_Prof_strided_bytes(count, stride_levels));
+
   if (ARMCII_GLOBAL_STATE.strided_method == ARMCII_STRIDED_DIRECT) {
     void         *src_buf = NULL;
     gmr_t *mreg, *gmr_loc = NULL;
     MPI_Datatype src_type, dst_type;
 
+    ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_PUT, proc, ARMCII_Prof_strided_bytes(count, stride_levels));
+
     /* COPY: Guard shared buffers */
     if (ARMCII_GLOBAL_STATE.shr_buf_method == ARMCII_SHR_BUF_COPY) {
       gmr_loc = gmr_lookup(src_ptr, ARMCI_GROUP_WORLD.rank);
@@ -199,6 +204,8 @@ int PARMCI_PutS(void *src_ptr, int src_stride_ar[/*stride_levels*/],
     free(iov.dst_ptr_array);
   }
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_PutS);
+
   return err;
 }
 
@@ -234,13 +241,15 @@ int PARMCI_GetS(void *src_ptr, int src_stride_ar[/*stride_levels*/],
   int err;
 
   ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_GetS);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_GetS, proc);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_GetS, proc, ARMCII_Prof_strided_bytes(count, stride_levels));
 
   if (ARMCII_GLOBAL_STATE.strided_method == ARMCII_STRIDED_DIRECT) {
     void         *dst_buf = NULL;
     gmr_t *mreg, *gmr_loc = NULL;
     MPI_Datatype src_type, dst_type;
 
+    ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_GET, proc, ARMCII_Prof_strided_bytes(count, stride_levels));
+
     /* COPY: Guard shared buffers */
     if (ARMCII_GLOBAL_STATE.shr_buf_method == ARMCII_SHR_BUF_COPY) {
       gmr_loc = gmr_lookup(dst_ptr, ARMCI_GROUP_WORLD.rank);
@@ -350,7 +359,7 @@ int PARMCI_AccS(int datatype, void *scale,
   int err;
 
   ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_AccS);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_AccS, proc);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_AccS, proc, ARMCII_Prof_strided_bytes(count, stride_levels));
 
   if (ARMCII_GLOBAL_STATE.strided_method == ARMCII_STRIDED_DIRECT) {
     void         *src_buf = NULL;
@@ -359,6 +368,8 @@ int PARMCI_AccS(int datatype, void *scale,
     int          scaled, mpi_datatype_size;
     int          src_size, dst_size;
 
+    ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_ACC, proc, ARMCII_Prof_strided_bytes(count, stride_levels));
+
     ARMCII_Acc_type_translate(datatype, &mpi_datatype, &mpi_datatype_size);
     scaled = ARMCII_Buf_acc_is_scaled(datatype, scale);
 
@@ -704,12 +715,17 @@ int PARMCI_PutS_flag(void *src_ptr, int src_stride_ar[/*stride_levels*/],
                  int count[/*stride_levels+1*/], int stride_levels, 
                  int *flag, int value, int proc) {
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_PutS_flag);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_PutS_flag, proc, ARMCII_Prof_strided_bytes(count, stride_levels));
+
   /* TODO: This can be optimized with a more direct implementation, especially in the
    *       case where RMA is ordered; in that case, the Fence (Flush) is not necessary. */
   PARMCI_PutS(src_ptr, src_stride_ar, dst_ptr, dst_stride_ar, count, stride_levels, proc);
   PARMCI_Fence(proc);
   PARMCI_Put(&value, flag, sizeof(int), proc);
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_PutS_flag);
+
   return 1;
 }
 
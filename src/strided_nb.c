@@ -42,11 +42,16 @@ int PARMCI_NbPutS(void *src_ptr, int src_stride_ar[/*stride_levels*/],
 
   int err;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_NbPutS);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbPutS, proc, ARMCII_Prof_strided_bytes(count, stride_levels));
+
   if (ARMCII_GLOBAL_STATE.strided_method == ARMCII_STRIDED_DIRECT) {
     void         *src_buf = NULL;
     gmr_t *mreg, *gmr_loc = NULL;
     MPI_Datatype src_type, dst_type;
 
+    ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_PUT, proc, ARMCII_Prof_strided_bytes(count, stride_levels));
+
     /* COPY: Guard shared buffers */
     if (ARMCII_GLOBAL_STATE.shr_buf_method == ARMCII_SHR_BUF_COPY) {
       gmr_loc = gmr_lookup(src_ptr, ARMCI_GROUP_WORLD.rank);
@@ -137,6 +142,8 @@ int PARMCI_NbPutS(void *src_ptr, int src_stride_ar[/*stride_levels*/],
   gmr_progress();
 #endif
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_NbPutS);
+
   return err;
 }
 
@@ -172,13 +179,15 @@ int PARMCI_NbGetS(void *src_ptr, int src_stride_ar[/*stride_levels*/],
   int err;
 
   ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_NbGetS);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbGetS, proc);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbGetS, proc, ARMCII_Prof_strided_bytes(count, stride_levels));
 
   if (ARMCII_GLOBAL_STATE.strided_method == ARMCII_STRIDED_DIRECT) {
     void         *dst_buf = NULL;
     gmr_t *mreg, *gmr_loc = NULL;
     MPI_Datatype src_type, dst_type;
 
+    ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_GET, proc, ARMCII_Prof_strided_bytes(count, stride_levels));
+
     /* COPY: Guard shared buffers */
     if (ARMCII_GLOBAL_STATE.shr_buf_method == ARMCII_SHR_BUF_COPY) {
       gmr_loc = gmr_lookup(dst_ptr, ARMCI_GROUP_WORLD.rank);
@@ -307,12 +316,17 @@ int PARMCI_NbAccS(int datatype, void *scale,
 
   int err;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_NbAccS);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbAccS, proc, ARMCII_Prof_strided_bytes(count, stride_levels));
+
   if (ARMCII_GLOBAL_STATE.strided_method == ARMCII_STRIDED_DIRECT) {
     void         *src_buf = NULL;
     gmr_t *mreg, *gmr_loc = NULL;
     MPI_Datatype src_type, dst_type, mpi_datatype;
     int          scaled, mpi_datatype_size;
 
+    ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_ACC, proc, ARMCII_Prof_strided_bytes(count, stride_levels));
+
     ARMCII_Acc_type_translate(datatype, &mpi_datatype, &mpi_datatype_size);
     scaled = ARMCII_Buf_acc_is_scaled(datatype, scale);
 
@@ -435,5 +449,7 @@ int PARMCI_NbAccS(int datatype, void *scale,
   gmr_progress();
 #endif
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_NbAccS);
+
   return err;
 }
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+/*
+ * trace.h
+ *  On-disk format of the per-process event traces written by profiling
+ *  builds when ARMCI_TRACE is set.  Each file holds a header, the names of
+ *  the traced operations, and a sequence of fixed-size events.  Shared by the
+ *  library and the armci-trace2json converter, so it must not depend on MPI.
+ */
+
+#ifndef HAVE_TRACE_H
+#define HAVE_TRACE_H
+
+#include <stdint.h>
+
+#define ARMCII_TRACE_MAGIC    "ARMCITR1"
+#define ARMCII_TRACE_NAME_LEN 32
+
+typedef struct {
+  char     magic[8];        /* ARMCII_TRACE_MAGIC, not NUL terminated                  */
+  int32_t  rank;            /* World rank of the process that wrote the trace          */
+  int32_t  nproc;           /* Number of processes in the world group                 */
+  int32_t  nfuncs;          /* Number of operation names that follow the header        */
+  int32_t  sample;          /* One in this many calls of each operation was recorded   */
+  double   clock_hz;        /* Tick rate of the event timestamps                       */
+  uint64_t origin;          /* Tick count when all processes left the starting barrier */
+} armcii_trace_header_t;
+
+typedef struct {
+  uint64_t start;           /* Tick count on entry to the operation                    */
+  uint64_t end;             /* Tick count on exit                                      */
+  int64_t  bytes;           /* Bytes transferred, 0 if none                            */
+  int32_t  target;          /* Absolute target rank, -1 if none                        */
+  int32_t  window;          /* Fortran handle of the MPI window, -1 if unknown         */
+  int32_t  func;            /* Index into the operation names                          */
+  int32_t  pad;
+} armcii_trace_event_t;
+
+#endif /* HAVE_TRACE_H */
@@ -40,7 +40,6 @@ void PARMCI_Barrier(void) {
   gmr_t *cur_mreg = gmr_list;
 
   ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Barrier);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Barrier, 0);
 
   PARMCI_AllFence();
   MPI_Barrier(ARMCI_GROUP_WORLD.comm);
@@ -72,10 +71,15 @@ void PARMCI_Barrier(void) {
 void PARMCI_Fence(int proc) {
   gmr_t *cur_mreg = gmr_list;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_Fence);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_Fence, proc, 0);
+
   while (cur_mreg) {
     gmr_flush(cur_mreg, proc, 0);
     cur_mreg = cur_mreg->next;
   }
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_Fence);
   return;
 }
 
@@ -131,7 +135,6 @@ void PARMCI_AllFence(void) {
   gmr_t *cur_mreg = gmr_list;
 
   ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_AllFence);
-  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_AllFence, 0);
 
   while (cur_mreg) {
     gmr_flushall(cur_mreg, 0);
@@ -174,6 +177,55 @@ void PARMCI_AllFence(void) {
   return;
 }
 
+
+/** Wait for remote completion on one-sided operations on the allocations
+  * made on a group.  Allocations made on other groups, including the world
+  * group, are not fenced.  Not collective.
+  *
+  * @param[in] group Group whose allocations are fenced
+  */
+void ARMCIX_AllFence_group(ARMCI_Group *group) {
+  gmr_t *cur_mreg = gmr_list;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(ARMCIX_AllFence_group);
+
+  while (cur_mreg) {
+    if (cur_mreg->group.comm == group->comm) {
+      gmr_flushall(cur_mreg, 0);
+      gmr_sync(cur_mreg);
+    }
+
+    cur_mreg = cur_mreg->next;
+  }
+
+  ARMCI_FUNC_PROFILE_TIMING_END(ARMCIX_AllFence_group);
+}
+
+
+/** Barrier synchronization on a group.  Fences and synchronizes only the
+  * allocations made on the group, so independent groups do not wait for each
+  * other.  Collective on the group.
+  *
+  * @param[in] group Group to synchronize
+  */
+void ARMCIX_Barrier_group(ARMCI_Group *group) {
+  gmr_t *cur_mreg = gmr_list;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(ARMCIX_Barrier_group);
+
+  ARMCIX_AllFence_group(group);
+  MPI_Barrier(group->comm);
+
+  while (cur_mreg) {
+    if (cur_mreg->group.comm == group->comm)
+      gmr_sync(cur_mreg);
+
+    cur_mreg = cur_mreg->next;
+  }
+
+  ARMCI_FUNC_PROFILE_TIMING_END(ARMCIX_Barrier_group);
+}
+
 #ifdef USE_CSP_ASYNC_CONFIG
 #include <casper.h>
 
@@ -276,6 +328,24 @@ int ARMCII_Log2(unsigned int val) {
 }
 
 
+#define BACKOFF_BASE 1.0e-6   /* Delay per process ahead of me (seconds) */
+#define BACKOFF_MAX  1.0e-4   /* Maximum delay between polls (seconds)   */
+
+/** Busy-wait between polls of a remote synchronization word, in proportion
+  * to the number of processes that must go before the caller, up to
+  * BACKOFF_MAX.
+  *
+  * @param[in] distance Number of processes ahead of the caller
+  */
+void ARMCII_Backoff(unsigned distance) {
+  const double delay = distance < BACKOFF_MAX/BACKOFF_BASE ? distance*BACKOFF_BASE : BACKOFF_MAX;
+  const double t0    = MPI_Wtime();
+
+  while (MPI_Wtime() - t0 < delay)
+    ;
+}
+
+
 /** Retrieve the value of a boolean environment variable.
   */
 int ARMCII_Getenv_bool(const char *varname, int default_value) {
@@ -21,7 +21,16 @@
 /* -- end weak symbols block -- */
 
 int PARMCI_PutValueInt(int src, void *dst, int proc) {
-  return PARMCI_Put(&src, dst, sizeof(int), proc);
+  int err;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_PutValueInt);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_PutValueInt, proc, sizeof(int));
+
+  err = PARMCI_Put(&src, dst, sizeof(int), proc);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_PutValueInt);
+
+  return err;
 }
 
 /* -- begin weak symbols block -- */
@@ -35,7 +44,16 @@ int PARMCI_PutValueInt(int src, void *dst, int proc) {
 /* -- end weak symbols block -- */
 
 int PARMCI_PutValueLong(long src, void *dst, int proc) {
-  return PARMCI_Put(&src, dst, sizeof(long), proc);
+  int err;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_PutValueLong);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_PutValueLong, proc, sizeof(long));
+
+  err = PARMCI_Put(&src, dst, sizeof(long), proc);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_PutValueLong);
+
+  return err;
 }
 
 /* -- begin weak symbols block -- */
@@ -49,7 +67,16 @@ int PARMCI_PutValueLong(long src, void *dst, int proc) {
 /* -- end weak symbols block -- */
 
 int PARMCI_PutValueFloat(float src, void *dst, int proc) {
-  return PARMCI_Put(&src, dst, sizeof(float), proc);
+  int err;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_PutValueFloat);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_PutValueFloat, proc, sizeof(float));
+
+  err = PARMCI_Put(&src, dst, sizeof(float), proc);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_PutValueFloat);
+
+  return err;
 }
 
 /* -- begin weak symbols block -- */
@@ -63,7 +90,16 @@ int PARMCI_PutValueFloat(float src, void *dst, int proc) {
 /* -- end weak symbols block -- */
 
 int PARMCI_PutValueDouble(double src, void *dst, int proc) {
-  return PARMCI_Put(&src, dst, sizeof(double), proc);
+  int err;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_PutValueDouble);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_PutValueDouble, proc, sizeof(double));
+
+  err = PARMCI_Put(&src, dst, sizeof(double), proc);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_PutValueDouble);
+
+  return err;
 }
 
 /* Non-blocking put operations */
@@ -79,7 +115,16 @@ int PARMCI_PutValueDouble(double src, void *dst, int proc) {
 /* -- end weak symbols block -- */
 
 int PARMCI_NbPutValueInt(int src, void *dst, int proc, armci_hdl_t *hdl) {
-  return PARMCI_NbPut(&src, dst, sizeof(int), proc, hdl);
+  int err;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_NbPutValueInt);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbPutValueInt, proc, sizeof(int));
+
+  err = PARMCI_NbPut(&src, dst, sizeof(int), proc, hdl);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_NbPutValueInt);
+
+  return err;
 }
 
 /* -- begin weak symbols block -- */
@@ -93,7 +138,16 @@ int PARMCI_NbPutValueInt(int src, void *dst, int proc, armci_hdl_t *hdl) {
 /* -- end weak symbols block -- */
 
 int PARMCI_NbPutValueLong(long src, void *dst, int proc, armci_hdl_t *hdl) {
-  return PARMCI_NbPut(&src, dst, sizeof(long), proc, hdl);
+  int err;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_NbPutValueLong);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbPutValueLong, proc, sizeof(long));
+
+  err = PARMCI_NbPut(&src, dst, sizeof(long), proc, hdl);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_NbPutValueLong);
+
+  return err;
 }
 
 /* -- begin weak symbols block -- */
@@ -107,7 +161,16 @@ int PARMCI_NbPutValueLong(long src, void *dst, int proc, armci_hdl_t *hdl) {
 /* -- end weak symbols block -- */
 
 int PARMCI_NbPutValueFloat(float src, void *dst, int proc, armci_hdl_t *hdl) {
-  return PARMCI_NbPut(&src, dst, sizeof(float), proc, hdl);
+  int err;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_NbPutValueFloat);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbPutValueFloat, proc, sizeof(float));
+
+  err = PARMCI_NbPut(&src, dst, sizeof(float), proc, hdl);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_NbPutValueFloat);
+
+  return err;
 }
 
 /* -- begin weak symbols block -- */
@@ -121,7 +184,16 @@ int PARMCI_NbPutValueFloat(float src, void *dst, int proc, armci_hdl_t *hdl) {
 /* -- end weak symbols block -- */
 
 int PARMCI_NbPutValueDouble(double src, void *dst, int proc, armci_hdl_t *hdl) {
-  return PARMCI_NbPut(&src, dst, sizeof(double), proc, hdl);
+  int err;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_NbPutValueDouble);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbPutValueDouble, proc, sizeof(double));
+
+  err = PARMCI_NbPut(&src, dst, sizeof(double), proc, hdl);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_NbPutValueDouble);
+
+  return err;
 }
 
 /* Get value operations */
@@ -138,7 +210,14 @@ int PARMCI_NbPutValueDouble(double src, void *dst, int proc, armci_hdl_t *hdl) {
 
 int    PARMCI_GetValueInt(void *src, int proc) {
   int val;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_GetValueInt);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_GetValueInt, proc, sizeof(int));
+
   PARMCI_Get(src, &val, sizeof(int), proc);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_GetValueInt);
+
   return val;
 }
 
@@ -154,7 +233,14 @@ int    PARMCI_GetValueInt(void *src, int proc) {
 
 long   PARMCI_GetValueLong(void *src, int proc) {
   long val;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_GetValueLong);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_GetValueLong, proc, sizeof(long));
+
   PARMCI_Get(src, &val, sizeof(long), proc);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_GetValueLong);
+
   return val;
 }
 
@@ -168,9 +254,16 @@ long   PARMCI_GetValueLong(void *src, int proc) {
 #endif
 /* -- end weak symbols block -- */
 
-float  PARMCI_GetValueFloat(void *src, int proc) {     
+float  PARMCI_GetValueFloat(void *src, int proc) {
   float val;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_GetValueFloat);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_GetValueFloat, proc, sizeof(float));
+
   PARMCI_Get(src, &val, sizeof(float), proc);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_GetValueFloat);
+
   return val;
 }
 
@@ -184,8 +277,15 @@ float  PARMCI_GetValueFloat(void *src, int proc) {
 #endif
 /* -- end weak symbols block -- */
 
-double PARMCI_GetValueDouble(void *src, int proc) {     
+double PARMCI_GetValueDouble(void *src, int proc) {
   double val;
+
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_GetValueDouble);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_GetValueDouble, proc, sizeof(double));
+
   PARMCI_Get(src, &val, sizeof(double), proc);
+
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_GetValueDouble);
+
   return val;
 }
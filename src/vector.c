@@ -14,6 +14,12 @@
 #include <conflict_tree.h>
 #endif
 
+#define MIN(A,B) (((A) < (B)) ? (A) : (B))
+#define MAX(A,B) (((A) > (B)) ? (A) : (B))
+
+static int ARMCII_Iov_op_batched_issue(enum ARMCII_Op_e op, gmr_t *mreg, void **src, void **dst, int count,
+    int elem_count, MPI_Datatype type, int proc, int consrv, int bounded);
+
 
 /** Check an I/O vector operation's buffers for overlap.
   *
@@ -83,8 +89,8 @@ int ARMCII_Iov_check_same_allocation(void **ptrs, int count, int proc) {
   gmr_t *mreg;
   void *base, *extent;
 
-  if (!ARMCII_GLOBAL_STATE.iov_checks) return 1;
-
+  /* This check is cheap and selects the multi-allocation path in the IOV
+   * dispatcher, so it is performed even when IOV checks are disabled. */
   mreg = gmr_lookup(ptrs[0], proc);
 
   /* If local, all must be local */
@@ -139,13 +145,11 @@ int ARMCII_Iov_op_dispatch(enum ARMCII_Op_e op, void **src, void **dst, int coun
     ARMCII_Assert_msg(size % type_size == 0, "Transfer size is not a multiple of type size");
   }
 
-  // CONSERVATIVE CASE: If remote pointers overlap or remote pointers correspond to
-  // multiple allocations, use the safe implementation to avoid invalid MPI
-  // use.
+  // CONSERVATIVE CASE: If remote pointers overlap, use the safe implementation
+  // to avoid invalid MPI use.
 
-  if (overlapping || !same_alloc || ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_CONSRV) {
+  if (overlapping || ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_CONSRV) {
     if (overlapping) ARMCII_Warning("IOV remote buffers overlap\n");
-    if (!same_alloc) ARMCII_Warning("IOV remote buffers are not within the same allocation\n");
 #if 0
     return ARMCII_Iov_op_safe(op, src, dst, count, type_count, type, proc);
 #else
@@ -154,6 +158,14 @@ int ARMCII_Iov_op_dispatch(enum ARMCII_Op_e op, void **src, void **dst, int coun
 #endif
   }
 
+  // MULTIPLE ALLOCATIONS: Remote pointers correspond to several allocations.
+  // Split the operation by window and complete all windows together.
+
+  else if (!same_alloc) {
+    ARMCII_Dbg_print(DEBUG_CAT_IOV, "IOV remote buffers span multiple allocations\n");
+    return ARMCII_Iov_op_grouped(op, src, dst, count, type_count, type, proc, blocking);
+  }
+
   // OPTIMIZED CASE: It's safe for us to issue all the operations under a
   // single lock.
 
@@ -224,42 +236,282 @@ int ARMCII_Iov_op_safe(enum ARMCII_Op_e op, void **src, void **dst, int count, i
 }
 #endif
 
-/** Optimized implementation of the ARMCI IOV operation that uses a single
-  * lock/unlock pair.
+/** Implementation of the ARMCI IOV operation for remote buffers that span
+  * several allocations.  Segments are partitioned by the GMR that owns them,
+  * one optimized operation is issued per window, and the windows are only
+  * flushed once all operations have been issued.  With the BATCHED method, a
+  * blocking operation still bounds the operations and bytes outstanding on
+  * each window as ARMCII_Iov_op_batched does.
   */
-int ARMCII_Iov_op_batched(enum ARMCII_Op_e op, void **src, void **dst, int count, int elem_count,
-    MPI_Datatype type, int proc, int consrv, int blocking) {
+int ARMCII_Iov_op_grouped(enum ARMCII_Op_e op, void **src, void **dst, int count, int elem_count,
+    MPI_Datatype type, int proc, int blocking) {
 
-  int i;
-  int flush_local = 1; /* used only for MPI-3 */
-  gmr_t *mreg;
-  void *shr_ptr;
+  int     i, g, ngroups = 0;
+  int     flush_local = (op != ARMCII_OP_GET);
+  void  **buf_rem;
+  gmr_t **mregs;
+  int    *seg_group, *group_off;
+  void  **grp_src, **grp_dst;
 
   switch(op) {
     case ARMCII_OP_ACC:
     case ARMCII_OP_PUT:
-      shr_ptr = dst[0];
+      buf_rem = dst;
       break;
     case ARMCII_OP_GET:
-      shr_ptr = src[0];
+      buf_rem = src;
       break;
     default:
       ARMCII_Error("unknown operation (%d)", op);
       return 1;
   }
 
-  mreg = gmr_lookup(shr_ptr, proc);
-  ARMCII_Assert_msg(mreg != NULL, "Invalid remote pointer");
+  mregs     = malloc(count*sizeof(gmr_t*));
+  seg_group = malloc(count*sizeof(int));
+  group_off = malloc((count+1)*sizeof(int));
+  grp_src   = malloc(count*sizeof(void*));
+  grp_dst   = malloc(count*sizeof(void*));
+  ARMCII_Assert(mregs != NULL && seg_group != NULL && group_off != NULL &&
+                grp_src != NULL && grp_dst != NULL);
 
+  /* Assign each segment to the window that owns it.  Consecutive segments
+   * usually fall in the same allocation, so check the previous one first. */
   for (i = 0; i < count; i++) {
+    gmr_t *mreg = NULL;
 
-    if ( blocking && i > 0 &&
-        ( consrv ||
-         ( ARMCII_GLOBAL_STATE.iov_batched_limit > 0 && i % ARMCII_GLOBAL_STATE.iov_batched_limit == 0)
-        )
-       )
-    {
-      gmr_flush(mreg, proc, flush_local);
+    if (i > 0) {
+      gmr_t *prev = mregs[seg_group[i-1]];
+      const uint8_t *base = prev->slices[proc].base;
+
+      if ((uint8_t*) buf_rem[i] >= base && (uint8_t*) buf_rem[i] < base + prev->slices[proc].size)
+        mreg = prev;
+    }
+
+    if (mreg == NULL) {
+      mreg = gmr_lookup(buf_rem[i], proc);
+      ARMCII_Assert_msg(mreg != NULL, "Invalid remote pointer");
+    }
+
+    for (g = 0; g < ngroups && mregs[g] != mreg; g++)
+      ;
+
+    if (g == ngroups)
+      mregs[ngroups++] = mreg;
+
+    seg_group[i] = g;
+  }
+
+  /* Counting sort of the segments by window, preserving their order */
+  for (g = 0; g <= ngroups; g++)
+    group_off[g] = 0;
+
+  for (i = 0; i < count; i++)
+    group_off[seg_group[i]+1]++;
+
+  for (g = 0; g < ngroups; g++)
+    group_off[g+1] += group_off[g];
+
+  for (i = 0; i < count; i++) {
+    const int pos = group_off[seg_group[i]]++;
+    grp_src[pos] = src[i];
+    grp_dst[pos] = dst[i];
+  }
+
+  /* group_off[g] now holds the end of group g */
+  for (g = 0; g < ngroups; g++) {
+    const int start = (g == 0) ? 0 : group_off[g-1];
+    const int len   = group_off[g] - start;
+
+    if (ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_BATCHED)
+      ARMCII_Iov_op_batched_issue(op, mregs[g], &grp_src[start], &grp_dst[start], len, elem_count, type,
+                                  proc, 0 /* not consrv */, blocking);
+    else
+      ARMCII_Iov_op_datatype(op, &grp_src[start], &grp_dst[start], len, elem_count, type, proc,
+                             0 /* not blocking */);
+  }
+
+  if (blocking) {
+    for (g = 0; g < ngroups; g++)
+      gmr_flush(mregs[g], proc, flush_local);
+  }
+
+  free(mregs);
+  free(seg_group);
+  free(group_off);
+  free(grp_src);
+  free(grp_dst);
+
+  return 0;
+}
+
+
+/* Bounds and tuning constants for the adaptive BATCHED flush controller */
+#define IOV_FLUSH_CTL_INIT_OPS    64
+#define IOV_FLUSH_CTL_MAX_OPS     16384
+#define IOV_FLUSH_CTL_INIT_BYTES  (1L << 20)
+#define IOV_FLUSH_CTL_MIN_BYTES   (1L << 12)
+#define IOV_FLUSH_CTL_MAX_BYTES   (1L << 26)
+#define IOV_FLUSH_CTL_TOLERANCE   0.25  /* Relative cost increase treated as flat */
+#define IOV_FLUSH_CTL_SMOOTHING   0.125 /* Weight of a new sample in the average  */
+
+armcii_iov_flush_ctl_t ARMCII_IOV_FLUSH_CTL;
+
+
+/** Start the flush window of a target.  When ARMCI_IOV_BATCHED_LIMIT is set,
+  * it caps the operation window.
+  *
+  * @param[out] ctl  Window to initialize
+  * @param[in]  proc Target process, or -1 to mark the entry unused
+  */
+static void ARMCII_Iov_flush_target_init(armcii_iov_flush_target_t *ctl, int proc) {
+  const int limit = ARMCII_GLOBAL_STATE.iov_batched_limit;
+
+  ctl->proc      = proc;
+  ctl->max_ops   = (limit > 0 && limit < IOV_FLUSH_CTL_INIT_OPS) ? limit : IOV_FLUSH_CTL_INIT_OPS;
+  ctl->max_bytes = IOV_FLUSH_CTL_INIT_BYTES;
+  ctl->cost      = 0.0;
+}
+
+
+/** Find the flush window of a target, taking over its table entry if it is
+  * held by another target.
+  *
+  * @param[in] proc Target process
+  * @return         The target's window
+  */
+static armcii_iov_flush_target_t *ARMCII_Iov_flush_target(int proc) {
+  armcii_iov_flush_target_t *ctl = &ARMCII_IOV_FLUSH_CTL.targets[proc % ARMCII_IOV_FLUSH_CTL_NTARGETS];
+
+  if (ctl->proc != proc)
+    ARMCII_Iov_flush_target_init(ctl, proc);
+
+  return ctl;
+}
+
+
+/** Reset the adaptive flush controller for the BATCHED IOV method.
+  */
+void ARMCII_Iov_flush_ctl_init(void) {
+  int i;
+
+  for (i = 0; i < ARMCII_IOV_FLUSH_CTL_NTARGETS; i++)
+    ARMCII_Iov_flush_target_init(&ARMCII_IOV_FLUSH_CTL.targets[i], -1);
+
+  ARMCII_IOV_FLUSH_CTL.nflushes  = 0;
+  ARMCII_IOV_FLUSH_CTL.ngrow     = 0;
+  ARMCII_IOV_FLUSH_CTL.nshrink   = 0;
+}
+
+
+/** Query the current bounds of the adaptive BATCHED IOV flush controller for
+  * a target.  Targets without a window report the initial bounds.
+  *
+  * @param[in]  proc      Target process
+  * @param[out] max_ops   Operations allowed on proc between flushes
+  * @param[out] max_bytes Bytes allowed on proc between flushes
+  */
+void ARMCIX_Iov_batched_limits(int proc, int *max_ops, long *max_bytes) {
+  armcii_iov_flush_target_t  init;
+  armcii_iov_flush_target_t *ctl = &ARMCII_IOV_FLUSH_CTL.targets[proc % ARMCII_IOV_FLUSH_CTL_NTARGETS];
+
+  if (ctl->proc != proc) {
+    ARMCII_Iov_flush_target_init(&init, proc);
+    ctl = &init;
+  }
+
+  if (max_ops != NULL)   *max_ops   = ctl->max_ops;
+  if (max_bytes != NULL) *max_bytes = ctl->max_bytes;
+}
+
+
+/** Flush a full batch and adapt the window from the measured flush latency.
+  * The window grows while the flush time per outstanding byte stays flat and
+  * is halved when it rises, e.g. because MPI internal queues are overflowing.
+  *
+  * @param[in] ctl         Flush window of the target
+  * @param[in] mreg        Window holding the batch
+  * @param[in] proc        Target process
+  * @param[in] flush_local Only wait for local completion
+  * @param[in] bytes       Number of bytes outstanding in the batch
+  * @param[in] ops_full    The batch was cut by the operation bound (not bytes)
+  */
+static void ARMCII_Iov_flush_adapt(armcii_iov_flush_target_t *ctl, gmr_t *mreg, int proc, int flush_local,
+                                   long bytes, int ops_full) {
+  const int max_ops = ARMCII_GLOBAL_STATE.iov_batched_limit > 0 ?
+                      ARMCII_GLOBAL_STATE.iov_batched_limit : IOV_FLUSH_CTL_MAX_OPS;
+  double t_flush, cost;
+
+  t_flush = MPI_Wtime();
+  gmr_flush(mreg, proc, flush_local);
+  t_flush = MPI_Wtime() - t_flush;
+
+  ARMCII_IOV_FLUSH_CTL.nflushes++;
+  cost = t_flush / (bytes > 0 ? bytes : 1);
+
+  if (ctl->cost == 0.0 || cost <= ctl->cost * (1.0 + IOV_FLUSH_CTL_TOLERANCE)) {
+    /* Flat: additive increase of the bound that cut the batch */
+    if (ops_full)
+      ctl->max_ops = MIN(max_ops, ctl->max_ops + MAX(1, ctl->max_ops/4));
+    else
+      ctl->max_bytes = MIN(IOV_FLUSH_CTL_MAX_BYTES, ctl->max_bytes + ctl->max_bytes/4);
+    ARMCII_IOV_FLUSH_CTL.ngrow++;
+  } else {
+    /* Rising: multiplicative decrease of both bounds */
+    ctl->max_ops   = MAX(1, ctl->max_ops/2);
+    ctl->max_bytes = MAX(IOV_FLUSH_CTL_MIN_BYTES, ctl->max_bytes/2);
+    ARMCII_IOV_FLUSH_CTL.nshrink++;
+  }
+
+  if (ctl->cost == 0.0)
+    ctl->cost = cost;
+  else
+    ctl->cost = (1.0 - IOV_FLUSH_CTL_SMOOTHING) * ctl->cost + IOV_FLUSH_CTL_SMOOTHING * cost;
+}
+
+
+/** Issue the operations of an IOV operation on one window.  When bounded, the
+  * number of outstanding operations and bytes is bounded by the adaptive
+  * flush controller (or by the fixed ARMCI_IOV_BATCHED_LIMIT when the
+  * controller is disabled), and the window is flushed when a bound is
+  * reached.  The final flush is left to the caller.
+  *
+  * @param[in] mreg    Window holding all remote buffers
+  * @param[in] consrv  Flush after every operation
+  * @param[in] bounded Apply the flush bounds
+  * @return            Zero on success
+  */
+static int ARMCII_Iov_op_batched_issue(enum ARMCII_Op_e op, gmr_t *mreg, void **src, void **dst, int count,
+    int elem_count, MPI_Datatype type, int proc, int consrv, int bounded) {
+
+  int i, type_size, batch_ops = 0;
+  int flush_local = 1; /* used only for MPI-3 */
+  long batch_bytes = 0, elem_bytes;
+  armcii_iov_flush_target_t *ctl = NULL;
+
+  MPI_Type_size(type, &type_size);
+  elem_bytes = (long) elem_count * type_size;
+
+  if (bounded && !consrv && ARMCII_GLOBAL_STATE.iov_batched_adaptive)
+    ctl = ARMCII_Iov_flush_target(proc);
+
+  for (i = 0; i < count; i++) {
+
+    if (bounded && i > 0) {
+      if (consrv) {
+        gmr_flush(mreg, proc, flush_local);
+      }
+      else if (ctl != NULL) {
+        const int ops_full = batch_ops >= ctl->max_ops;
+
+        if (ops_full || batch_bytes + elem_bytes > ctl->max_bytes) {
+          ARMCII_Iov_flush_adapt(ctl, mreg, proc, flush_local, batch_bytes, ops_full);
+          batch_ops   = 0;
+          batch_bytes = 0;
+        }
+      }
+      else if (ARMCII_GLOBAL_STATE.iov_batched_limit > 0 && i % ARMCII_GLOBAL_STATE.iov_batched_limit == 0) {
+        gmr_flush(mreg, proc, flush_local);
+      }
     }
 
     switch(op) {
@@ -279,10 +531,47 @@ int ARMCII_Iov_op_batched(enum ARMCII_Op_e op, void **src, void **dst, int count
         ARMCII_Error("unknown operation (%d)", op);
         return 1;
     }
+
+    batch_ops++;
+    batch_bytes += elem_bytes;
   }
 
+  return 0;
+}
+
+
+/** Optimized implementation of the ARMCI IOV operation that uses a single
+  * lock/unlock pair.  When blocking, the number of outstanding operations and
+  * bytes is bounded by the adaptive flush controller (or by the fixed
+  * ARMCI_IOV_BATCHED_LIMIT when the controller is disabled).
+  */
+int ARMCII_Iov_op_batched(enum ARMCII_Op_e op, void **src, void **dst, int count, int elem_count,
+    MPI_Datatype type, int proc, int consrv, int blocking) {
+
+  gmr_t *mreg;
+  void *shr_ptr;
+
+  switch(op) {
+    case ARMCII_OP_ACC:
+    case ARMCII_OP_PUT:
+      shr_ptr = dst[0];
+      break;
+    case ARMCII_OP_GET:
+      shr_ptr = src[0];
+      break;
+    default:
+      ARMCII_Error("unknown operation (%d)", op);
+      return 1;
+  }
+
+  mreg = gmr_lookup(shr_ptr, proc);
+  ARMCII_Assert_msg(mreg != NULL, "Invalid remote pointer");
+
+  if (ARMCII_Iov_op_batched_issue(op, mreg, src, dst, count, elem_count, type, proc, consrv, blocking))
+    return 1;
+
   if (blocking) {
-    gmr_flush(mreg, proc, flush_local);
+    gmr_flush(mreg, proc, op != ARMCII_OP_GET /* flush_local, used only for MPI-3 */);
   }
 
   return 0;
@@ -401,6 +690,10 @@ int ARMCII_Iov_op_datatype(enum ARMCII_Op_e op, void **src, void **dst, int coun
 int PARMCI_PutV(armci_giov_t *iov, int iov_len, int proc) {
   int v;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_PutV);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_PutV, proc, ARMCII_Prof_iov_bytes(iov, iov_len));
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_PUT, proc, ARMCII_Prof_iov_bytes(iov, iov_len));
+
   for (v = 0; v < iov_len; v++) {
     void **src_buf;
     int    overlapping, same_alloc;
@@ -417,6 +710,8 @@ int PARMCI_PutV(armci_giov_t *iov, int iov_len, int proc) {
     ARMCII_Buf_finish_read_vec(iov[v].src_ptr_array, src_buf, iov[v].ptr_array_len, iov[v].bytes);
   }
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_PutV);
+
   return 0;
 }
 
@@ -441,6 +736,10 @@ int PARMCI_PutV(armci_giov_t *iov, int iov_len, int proc) {
 int PARMCI_GetV(armci_giov_t *iov, int iov_len, int proc) {
   int v;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_GetV);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_GetV, proc, ARMCII_Prof_iov_bytes(iov, iov_len));
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_GET, proc, ARMCII_Prof_iov_bytes(iov, iov_len));
+
   for (v = 0; v < iov_len; v++) {
     void **dst_buf;
     int    overlapping, same_alloc;
@@ -458,6 +757,8 @@ int PARMCI_GetV(armci_giov_t *iov, int iov_len, int proc) {
     ARMCII_Buf_finish_write_vec(iov[v].dst_ptr_array, dst_buf, iov[v].ptr_array_len, iov[v].bytes);
   }
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_GetV);
+
   return 0;
 }
 
@@ -482,6 +783,10 @@ int PARMCI_GetV(armci_giov_t *iov, int iov_len, int proc) {
 int PARMCI_AccV(int datatype, void *scale, armci_giov_t *iov, int iov_len, int proc) {
   int v;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_AccV);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_AccV, proc, ARMCII_Prof_iov_bytes(iov, iov_len));
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_ACC, proc, ARMCII_Prof_iov_bytes(iov, iov_len));
+
   for (v = 0; v < iov_len; v++) {
     void **src_buf;
     int    overlapping, same_alloc;
@@ -498,5 +803,7 @@ int PARMCI_AccV(int datatype, void *scale, armci_giov_t *iov, int iov_len, int p
     ARMCII_Buf_finish_acc_vec(iov[v].src_ptr_array, src_buf, iov[v].ptr_array_len, iov[v].bytes);
   }
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_AccV);
+
   return 0;
 }
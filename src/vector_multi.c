@@ -0,0 +1,352 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <armci.h>
+#include <armcix.h>
+#include <armci_internals.h>
+#include <debug.h>
+#include <gmr.h>
+
+
+/** A (window, target) pair that has outstanding operations.
+  */
+typedef struct {
+  gmr_t *mreg;
+  int    proc;
+} multi_target_t;
+
+
+/** Entry index with its sort key.
+  */
+typedef struct {
+  int key;
+  int idx;
+} multi_order_t;
+
+
+/** Sort key used to stagger the target order: each process starts with its
+  * right neighbor and wraps around, so that the targets are not all hit by
+  * every origin at the same time.
+  */
+static int stagger_key(int proc) {
+  const int me    = ARMCI_GROUP_WORLD.rank;
+  const int nproc = ARMCI_GROUP_WORLD.size;
+
+  return (proc - me - 1 + 2*nproc) % nproc;
+}
+
+
+static int stagger_cmp(const void *a, const void *b) {
+  const multi_order_t *x = a;
+  const multi_order_t *y = b;
+
+  if (x->key != y->key)
+    return x->key - y->key;
+  else
+    return x->idx - y->idx;
+}
+
+
+/** Record the windows touched by a set of remote pointers.  Targets are
+  * visited in order, so only pairs added for the current target need to be
+  * checked for duplicates.
+  *
+  * @param[in]    ptrs        Remote pointers valid on proc
+  * @param[in]    count       Number of pointers
+  * @param[in]    proc        Target process
+  * @param[inout] targets     List of touched pairs
+  * @param[inout] ntargets    Length of the list
+  * @param[inout] max_targets Allocated length of the list
+  * @param[in]    first       Index of the first pair for this target
+  */
+static void record_targets(void **ptrs, int count, int proc, multi_target_t **targets,
+                           int *ntargets, int *max_targets, int first) {
+  int    i, j;
+  gmr_t *last = NULL;
+
+  for (i = 0; i < count; i++) {
+    gmr_t *mreg;
+
+    if (last != NULL) {
+      const uint8_t *base = last->slices[proc].base;
+
+      if ((uint8_t*) ptrs[i] >= base && (uint8_t*) ptrs[i] < base + last->slices[proc].size)
+        continue;
+    }
+
+    mreg = gmr_lookup(ptrs[i], proc);
+    ARMCII_Assert_msg(mreg != NULL, "Invalid remote pointer");
+    last = mreg;
+
+    for (j = first; j < *ntargets && (*targets)[j].mreg != mreg; j++)
+      ;
+
+    if (j < *ntargets)
+      continue;
+
+    if (*ntargets == *max_targets) {
+      *max_targets *= 2;
+      *targets = realloc(*targets, *max_targets*sizeof(multi_target_t));
+      ARMCII_Assert(*targets != NULL);
+    }
+
+    (*targets)[*ntargets].mreg = mreg;
+    (*targets)[*ntargets].proc = proc;
+    (*ntargets)++;
+  }
+}
+
+
+/** Perform I/O vector operations on several targets.  All transfers are issued
+  * first, in staggered target order, then every touched window is flushed once
+  * per target.
+  *
+  * @param[in] op       Operation to be performed (ARMCII_OP_PUT, ...)
+  * @param[in] datatype Data type for accumulate op (ignored for all others)
+  * @param[in] scale    Scaling factor for accumulate op (ignored for all others)
+  * @param[in] entries  List of (proc, descriptor) entries
+  * @param[in] nentries Length of the entries list
+  * @return             Zero on success, error code otherwise
+  */
+static int ARMCII_Iov_multi(enum ARMCII_Op_e op, int datatype, void *scale,
+                            armcix_giov_multi_t *entries, int nentries) {
+
+  int   i, v, d, ndesc, ntargets, max_targets, first;
+  const enum ARMCII_Comm_op_e comm_op = (op == ARMCII_OP_PUT) ? ARMCII_COMM_PUT :
+                                        (op == ARMCII_OP_GET) ? ARMCII_COMM_GET : ARMCII_COMM_ACC;
+  multi_order_t *order;
+  void ***bufs;
+  multi_target_t *targets;
+
+  if (nentries <= 0) return 0;
+
+  /* Stagger the target order */
+  order = malloc(nentries*sizeof(multi_order_t));
+  ARMCII_Assert(order != NULL);
+
+  for (i = ndesc = 0; i < nentries; i++) {
+    order[i].key = stagger_key(entries[i].proc);
+    order[i].idx = i;
+    ndesc       += entries[i].iov_len;
+  }
+
+  qsort(order, nentries, sizeof(multi_order_t), stagger_cmp);
+
+  /* Private buffers must stay valid until the flush, keep them around */
+  bufs = malloc((ndesc > 0 ? ndesc : 1)*sizeof(void**));
+  ARMCII_Assert(bufs != NULL);
+
+  max_targets = nentries;
+  ntargets    = 0;
+  targets     = malloc(max_targets*sizeof(multi_target_t));
+  ARMCII_Assert(targets != NULL);
+
+  /* Issue phase */
+  for (i = d = 0, first = 0; i < nentries; i++) {
+    armcix_giov_multi_t *e = &entries[order[i].idx];
+
+    if (i > 0 && e->proc != entries[order[i-1].idx].proc)
+      first = ntargets;
+
+    ARMCII_COMM_MATRIX_RECORD(comm_op, e->proc, ARMCII_Prof_iov_bytes(e->iov, e->iov_len));
+
+    for (v = 0; v < e->iov_len; v++, d++) {
+      armci_giov_t *iov = &e->iov[v];
+      void        **buf_rem = (op == ARMCII_OP_GET) ? iov->src_ptr_array : iov->dst_ptr_array;
+      int           overlapping, same_alloc;
+
+      bufs[d] = NULL;
+
+      if (iov->ptr_array_len == 0) continue; // NOP //
+      if (iov->bytes == 0) continue; // NOP //
+
+      overlapping = ARMCII_Iov_check_overlap(buf_rem, iov->ptr_array_len, iov->bytes);
+      same_alloc  = ARMCII_Iov_check_same_allocation(buf_rem, iov->ptr_array_len, e->proc);
+
+      record_targets(buf_rem, iov->ptr_array_len, e->proc, &targets, &ntargets, &max_targets, first);
+
+      switch (op) {
+        case ARMCII_OP_PUT:
+          ARMCII_Buf_prepare_read_vec(iov->src_ptr_array, &bufs[d], iov->ptr_array_len, iov->bytes);
+          ARMCII_Iov_op_dispatch(op, bufs[d], iov->dst_ptr_array, iov->ptr_array_len, iov->bytes, 0,
+                                 overlapping, same_alloc, e->proc, 0 /* not blocking */);
+          break;
+        case ARMCII_OP_GET:
+          ARMCII_Buf_prepare_write_vec(iov->dst_ptr_array, &bufs[d], iov->ptr_array_len, iov->bytes);
+          ARMCII_Iov_op_dispatch(op, iov->src_ptr_array, bufs[d], iov->ptr_array_len, iov->bytes, 0,
+                                 overlapping, same_alloc, e->proc, 0 /* not blocking */);
+          break;
+        case ARMCII_OP_ACC:
+          ARMCII_Buf_prepare_acc_vec(iov->src_ptr_array, &bufs[d], iov->ptr_array_len, iov->bytes, datatype, scale);
+          ARMCII_Iov_op_dispatch(op, bufs[d], iov->dst_ptr_array, iov->ptr_array_len, iov->bytes, datatype,
+                                 overlapping, same_alloc, e->proc, 0 /* not blocking */);
+          break;
+        default:
+          ARMCII_Error("unknown operation (%d)", op);
+          return 1;
+      }
+    }
+  }
+
+  /* Completion phase: one flush per touched (window, target) pair */
+  for (i = 0; i < ntargets; i++)
+    gmr_flush(targets[i].mreg, targets[i].proc, op != ARMCII_OP_GET);
+
+  /* Release private buffers, copying results out for get operations */
+  for (i = d = 0; i < nentries; i++) {
+    armcix_giov_multi_t *e = &entries[order[i].idx];
+
+    for (v = 0; v < e->iov_len; v++, d++) {
+      armci_giov_t *iov = &e->iov[v];
+
+      if (bufs[d] == NULL) continue;
+
+      switch (op) {
+        case ARMCII_OP_PUT:
+          ARMCII_Buf_finish_read_vec(iov->src_ptr_array, bufs[d], iov->ptr_array_len, iov->bytes);
+          break;
+        case ARMCII_OP_GET:
+          ARMCII_Buf_finish_write_vec(iov->dst_ptr_array, bufs[d], iov->ptr_array_len, iov->bytes);
+          break;
+        case ARMCII_OP_ACC:
+          ARMCII_Buf_finish_acc_vec(iov->src_ptr_array, bufs[d], iov->ptr_array_len, iov->bytes);
+          break;
+      }
+    }
+  }
+
+  free(targets);
+  free(bufs);
+  free(order);
+
+  return 0;
+}
+
+
+/** Translate a list of strided entries into I/O vector entries.
+  */
+static armcix_giov_multi_t *strided_to_iov_multi(armcix_strided_multi_t *entries, int nentries) {
+  int i;
+  armcix_giov_multi_t *iov_entries;
+
+  iov_entries = malloc((nentries > 0 ? nentries : 1)*sizeof(armcix_giov_multi_t));
+  ARMCII_Assert(iov_entries != NULL);
+
+  for (i = 0; i < nentries; i++) {
+    iov_entries[i].proc    = entries[i].proc;
+    iov_entries[i].iov_len = 1;
+    iov_entries[i].iov     = malloc(sizeof(armci_giov_t));
+    ARMCII_Assert(iov_entries[i].iov != NULL);
+
+    ARMCII_Strided_to_iov(iov_entries[i].iov, entries[i].src_ptr, entries[i].src_stride_ar,
+                          entries[i].dst_ptr, entries[i].dst_stride_ar, entries[i].count,
+                          entries[i].stride_levels);
+  }
+
+  return iov_entries;
+}
+
+
+static void free_iov_multi(armcix_giov_multi_t *iov_entries, int nentries) {
+  int i;
+
+  for (i = 0; i < nentries; i++) {
+    free(iov_entries[i].iov->src_ptr_array);
+    free(iov_entries[i].iov->dst_ptr_array);
+    free(iov_entries[i].iov);
+  }
+
+  free(iov_entries);
+}
+
+
+/** Generalized I/O vector one-sided put to several targets.  All transfers are
+  * complete when the call returns.
+  *
+  * @param[in] entries  List of (proc, descriptor) entries.
+  * @param[in] nentries Length of the entries list.
+  * @return             Success 0, otherwise non-zero.
+  */
+int ARMCIX_PutV_multi(armcix_giov_multi_t *entries, int nentries) {
+  return ARMCII_Iov_multi(ARMCII_OP_PUT, 0, NULL, entries, nentries);
+}
+
+
+/** Generalized I/O vector one-sided get from several targets.  All transfers
+  * are complete when the call returns.
+  *
+  * @param[in] entries  List of (proc, descriptor) entries.
+  * @param[in] nentries Length of the entries list.
+  * @return             Success 0, otherwise non-zero.
+  */
+int ARMCIX_GetV_multi(armcix_giov_multi_t *entries, int nentries) {
+  return ARMCII_Iov_multi(ARMCII_OP_GET, 0, NULL, entries, nentries);
+}
+
+
+/** Generalized I/O vector one-sided accumulate to several targets.  All
+  * transfers are complete when the call returns.
+  *
+  * @param[in] datatype ARMCI data type for the accumulate operation.
+  * @param[in] scale    Scaling factor for the accumulate operation.
+  * @param[in] entries  List of (proc, descriptor) entries.
+  * @param[in] nentries Length of the entries list.
+  * @return             Success 0, otherwise non-zero.
+  */
+int ARMCIX_AccV_multi(int datatype, void *scale, armcix_giov_multi_t *entries, int nentries) {
+  return ARMCII_Iov_multi(ARMCII_OP_ACC, datatype, scale, entries, nentries);
+}
+
+
+/** Strided one-sided put to several targets.  All transfers are complete when
+  * the call returns.
+  *
+  * @param[in] entries  List of (proc, strided descriptor) entries.
+  * @param[in] nentries Length of the entries list.
+  * @return             Success 0, otherwise non-zero.
+  */
+int ARMCIX_PutS_multi(armcix_strided_multi_t *entries, int nentries) {
+  armcix_giov_multi_t *iov_entries = strided_to_iov_multi(entries, nentries);
+  int err = ARMCII_Iov_multi(ARMCII_OP_PUT, 0, NULL, iov_entries, nentries);
+
+  free_iov_multi(iov_entries, nentries);
+  return err;
+}
+
+
+/** Strided one-sided get from several targets.  All transfers are complete
+  * when the call returns.
+  *
+  * @param[in] entries  List of (proc, strided descriptor) entries.
+  * @param[in] nentries Length of the entries list.
+  * @return             Success 0, otherwise non-zero.
+  */
+int ARMCIX_GetS_multi(armcix_strided_multi_t *entries, int nentries) {
+  armcix_giov_multi_t *iov_entries = strided_to_iov_multi(entries, nentries);
+  int err = ARMCII_Iov_multi(ARMCII_OP_GET, 0, NULL, iov_entries, nentries);
+
+  free_iov_multi(iov_entries, nentries);
+  return err;
+}
+
+
+/** Strided one-sided accumulate to several targets.  All transfers are
+  * complete when the call returns.
+  *
+  * @param[in] datatype ARMCI data type for the accumulate operation.
+  * @param[in] scale    Scaling factor for the accumulate operation.
+  * @param[in] entries  List of (proc, strided descriptor) entries.
+  * @param[in] nentries Length of the entries list.
+  * @return             Success 0, otherwise non-zero.
+  */
+int ARMCIX_AccS_multi(int datatype, void *scale, armcix_strided_multi_t *entries, int nentries) {
+  armcix_giov_multi_t *iov_entries = strided_to_iov_multi(entries, nentries);
+  int err = ARMCII_Iov_multi(ARMCII_OP_ACC, datatype, scale, iov_entries, nentries);
+
+  free_iov_multi(iov_entries, nentries);
+  return err;
+}
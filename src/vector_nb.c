@@ -31,6 +31,10 @@ int PARMCI_NbPutV(armci_giov_t *iov, int iov_len, int proc, armci_hdl_t* handle)
   int v;
   int blocking = 0;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_NbPutV);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbPutV, proc, ARMCII_Prof_iov_bytes(iov, iov_len));
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_PUT, proc, ARMCII_Prof_iov_bytes(iov, iov_len));
+
   if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD) {
       blocking = 1;
   }
@@ -60,6 +64,8 @@ int PARMCI_NbPutV(armci_giov_t *iov, int iov_len, int proc, armci_hdl_t* handle)
   gmr_progress();
 #endif
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_NbPutV);
+
   return 0;
 }
 
@@ -85,6 +91,10 @@ int PARMCI_NbGetV(armci_giov_t *iov, int iov_len, int proc, armci_hdl_t* handle)
   int v;
   int blocking = 0;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_NbGetV);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbGetV, proc, ARMCII_Prof_iov_bytes(iov, iov_len));
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_GET, proc, ARMCII_Prof_iov_bytes(iov, iov_len));
+
   if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD) {
       blocking = 1;
   }
@@ -115,6 +125,8 @@ int PARMCI_NbGetV(armci_giov_t *iov, int iov_len, int proc, armci_hdl_t* handle)
   gmr_progress();
 #endif
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_NbGetV);
+
   return 0;
 }
 
@@ -140,6 +152,10 @@ int PARMCI_NbAccV(int datatype, void *scale, armci_giov_t *iov, int iov_len, int
   int v;
   int blocking = 0;
 
+  ARMCI_FUNC_PROFILE_TIMING_START(PARMCI_NbAccV);
+  ARMCI_FUNC_PROFILE_COUNTER_INC(PARMCI_NbAccV, proc, ARMCII_Prof_iov_bytes(iov, iov_len));
+  ARMCII_COMM_MATRIX_RECORD(ARMCII_COMM_ACC, proc, ARMCII_Prof_iov_bytes(iov, iov_len));
+
   if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD) {
       blocking = 1;
   }
@@ -169,5 +185,7 @@ int PARMCI_NbAccV(int datatype, void *scale, armci_giov_t *iov, int iov_len, int
   gmr_progress();
 #endif
 
+  ARMCI_FUNC_PROFILE_TIMING_END(PARMCI_NbAccV);
+
   return 0;
 }
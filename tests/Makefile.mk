@@ -8,12 +8,19 @@ check_PROGRAMS += tests/test_onesided         \
                   tests/test_mutex            \
                   tests/test_mutex_rmw        \
                   tests/test_mutex_trylock    \
+                  tests/test_mutex_many       \
+                  tests/test_mutex_biased     \
+                  tests/test_mutex_held       \
+                  tests/test_rwlock           \
                   tests/test_malloc           \
                   tests/test_malloc_irreg     \
                   tests/ARMCI_PutS_latency    \
                   tests/ARMCI_AccS_latency    \
                   tests/test_groups           \
                   tests/test_group_split      \
+                  tests/test_group_ranks      \
+                  tests/test_group_cache      \
+                  tests/test_barrier_group    \
                   tests/test_malloc_group     \
                   tests/test_accs             \
                   tests/test_accs_dla         \
@@ -21,9 +28,18 @@ check_PROGRAMS += tests/test_onesided         \
                   tests/test_puts_gets        \
                   tests/test_puts_gets_dla    \
                   tests/test_putv             \
+                  tests/test_putv_batched     \
+                  tests/test_iov_multialloc   \
+                  tests/test_multi            \
                   tests/test_assert           \
                   tests/test_igop             \
+                  tests/test_gop_nb           \
+                  tests/test_msg_sel          \
+                  tests/test_msg_scope        \
                   tests/test_rmw_fadd         \
+                  tests/test_rmw_batch        \
+                  tests/test_rmw_ext          \
+                  tests/test_alloc_stats      \
                   tests/test_parmci           \
                   # end
 
@@ -33,12 +49,19 @@ TESTS          += tests/test_onesided         \
                   tests/test_mutex            \
                   tests/test_mutex_rmw        \
                   tests/test_mutex_trylock    \
+                  tests/test_mutex_many       \
+                  tests/test_mutex_biased     \
+                  tests/test_mutex_held       \
+                  tests/test_rwlock           \
                   tests/test_malloc           \
                   tests/test_malloc_irreg     \
                   tests/ARMCI_PutS_latency    \
                   tests/ARMCI_AccS_latency    \
                   tests/test_groups           \
                   tests/test_group_split      \
+                  tests/test_group_ranks      \
+                  tests/test_group_cache      \
+                  tests/test_barrier_group    \
                   tests/test_malloc_group     \
                   tests/test_accs             \
                   tests/test_accs_dla         \
@@ -46,8 +69,17 @@ TESTS          += tests/test_onesided         \
                   tests/test_puts_gets        \
                   tests/test_puts_gets_dla    \
                   tests/test_putv             \
+                  tests/test_putv_batched     \
+                  tests/test_iov_multialloc   \
+                  tests/test_multi            \
                   tests/test_igop             \
+                  tests/test_gop_nb           \
+                  tests/test_msg_sel          \
+                  tests/test_msg_scope        \
                   tests/test_rmw_fadd         \
+                  tests/test_rmw_batch        \
+                  tests/test_rmw_ext          \
+                  tests/test_alloc_stats      \
                   tests/test_parmci           \
                   # end
 
@@ -60,12 +92,19 @@ tests_test_onesided_shared_dla_LDADD = libarmci.la
 tests_test_mutex_LDADD = libarmci.la
 tests_test_mutex_rmw_LDADD = libarmci.la
 tests_test_mutex_trylock_LDADD = libarmci.la
+tests_test_mutex_many_LDADD = libarmci.la
+tests_test_mutex_biased_LDADD = libarmci.la
+tests_test_mutex_held_LDADD = libarmci.la
+tests_test_rwlock_LDADD = libarmci.la
 tests_test_malloc_LDADD = libarmci.la
 tests_test_malloc_irreg_LDADD = libarmci.la
 tests_ARMCI_PutS_latency_LDADD = libarmci.la
 tests_ARMCI_AccS_latency_LDADD = libarmci.la
 tests_test_groups_LDADD = libarmci.la
 tests_test_group_split_LDADD = libarmci.la
+tests_test_group_ranks_LDADD = libarmci.la
+tests_test_group_cache_LDADD = libarmci.la
+tests_test_barrier_group_LDADD = libarmci.la
 tests_test_malloc_group_LDADD = libarmci.la
 tests_test_accs_LDADD = libarmci.la
 tests_test_accs_dla_LDADD = libarmci.la
@@ -73,9 +112,18 @@ tests_test_puts_LDADD = libarmci.la
 tests_test_puts_gets_LDADD = libarmci.la
 tests_test_puts_gets_dla_LDADD = libarmci.la
 tests_test_putv_LDADD = libarmci.la
+tests_test_putv_batched_LDADD = libarmci.la
+tests_test_iov_multialloc_LDADD = libarmci.la
+tests_test_multi_LDADD = libarmci.la
 tests_test_assert_LDADD = libarmci.la
 tests_test_igop_LDADD = libarmci.la
+tests_test_gop_nb_LDADD = libarmci.la
+tests_test_msg_sel_LDADD = libarmci.la
+tests_test_msg_scope_LDADD = libarmci.la
 tests_test_rmw_fadd_LDADD = libarmci.la
+tests_test_rmw_batch_LDADD = libarmci.la
+tests_test_rmw_ext_LDADD = libarmci.la
+tests_test_alloc_stats_LDADD = libarmci.la
 tests_test_parmci_LDADD = libarmci.la
 tests_test_parmci_SOURCES = tests/test_parmci.c tests/test_parmci_lib.c
 
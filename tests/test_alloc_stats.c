@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+/** ARMCI per-allocation statistics test
+  *
+  * Every process puts, gets, and accumulates into its right neighbor's slice
+  * of a named allocation and puts once into its own slice, then checks the
+  * operation and byte counts reported by ARMCIX_Alloc_stats.  A second
+  * allocation that is not touched must report no operations, only the
+  * flushes done by barriers.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define N     64
+#define NITER 10
+
+static int check(int rank, const char *what, long got, long expected) {
+  if (got != expected) {
+    printf("%3d -- %s is %ld, expected %ld\n", rank, what, got, expected);
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  int                   rank, nproc, right, i, errors = 0;
+  double              **base, **idle, buf[N], scale = 1.0;
+  armcix_alloc_stats_t  stats;
+  const long            bytes = N * sizeof(double);
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (rank == 0) printf("Starting ARMCI allocation statistics test with %d processes\n", nproc);
+
+  right = (rank + 1) % nproc;
+
+  base = malloc(nproc * sizeof(double*));
+  idle = malloc(nproc * sizeof(double*));
+
+  armci_dbg_set_gmr_name("stats_array");
+  ARMCI_Malloc((void**) base, bytes);
+  armci_dbg_reset_gmr_name();
+  ARMCI_Malloc((void**) idle, bytes);
+
+  for (i = 0; i < N; i++)
+    buf[i] = rank;
+
+  ARMCI_Barrier();
+
+  for (i = 0; i < NITER; i++) {
+    ARMCI_Put(buf, base[right], bytes, right);
+    ARMCI_Get(base[right], buf, bytes, right);
+    ARMCI_Acc(ARMCI_ACC_DBL, &scale, buf, base[right], bytes, right);
+  }
+
+  ARMCI_Put(buf, base[rank], bytes, rank);
+
+  ARMCI_Barrier();
+
+  if (ARMCIX_Alloc_stats(base[rank], &stats) != 0) {
+    printf("%3d -- ARMCIX_Alloc_stats failed on a valid allocation\n", rank);
+    errors++;
+  } else {
+    const int remote = (right == rank) ? ARMCIX_ALLOC_LOCAL : ARMCIX_ALLOC_REMOTE;
+    const int extra  = (right == rank) ? NITER : 0;
+
+    errors += check(rank, "remote get ops", stats.ops[ARMCIX_ALLOC_GET][remote], NITER);
+    errors += check(rank, "remote get bytes", stats.bytes[ARMCIX_ALLOC_GET][remote], NITER*bytes);
+    errors += check(rank, "remote acc ops", stats.ops[ARMCIX_ALLOC_ACC][remote], NITER);
+    errors += check(rank, "remote acc bytes", stats.bytes[ARMCIX_ALLOC_ACC][remote], NITER*bytes);
+    errors += check(rank, "remote put ops", stats.ops[ARMCIX_ALLOC_PUT][remote], NITER);
+    errors += check(rank, "local put ops", stats.ops[ARMCIX_ALLOC_PUT][ARMCIX_ALLOC_LOCAL], 1 + extra);
+    errors += check(rank, "local put bytes", stats.bytes[ARMCIX_ALLOC_PUT][ARMCIX_ALLOC_LOCAL],
+                    (1 + extra)*bytes);
+
+    if (stats.flushes < 2*NITER) {
+      printf("%3d -- %ld flushes, expected at least %d\n", rank, stats.flushes, 2*NITER);
+      errors++;
+    }
+  }
+
+  if (ARMCIX_Alloc_stats(idle[rank], &stats) != 0) {
+    printf("%3d -- ARMCIX_Alloc_stats failed on a valid allocation\n", rank);
+    errors++;
+  } else {
+    errors += check(rank, "idle allocation get ops", stats.ops[ARMCIX_ALLOC_GET][ARMCIX_ALLOC_REMOTE], 0);
+    errors += check(rank, "idle allocation put ops", stats.ops[ARMCIX_ALLOC_PUT][ARMCIX_ALLOC_REMOTE], 0);
+  }
+
+  if (ARMCIX_Alloc_stats(buf, &stats) == 0) {
+    printf("%3d -- ARMCIX_Alloc_stats succeeded on a private buffer\n", rank);
+    errors++;
+  }
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (rank == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else            printf("Test fail: %d errors.\n", errors);
+  }
+
+  ARMCI_Free(idle[rank]);
+  ARMCI_Free(base[rank]);
+  free(idle);
+  free(base);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <armci.h>
+#include <armcix.h>
+
+/* Odd and even processes work on separate group allocations and synchronize
+ * only within their group.  The groups run different numbers of phases, which
+ * would deadlock if the group barrier involved the other group. */
+
+#define NPHASE 10
+
+int main(int argc, char **argv) {
+  int          me, nproc, grp_me, grp_nproc, phase, nphase, errors = 0;
+  ARMCI_Group  g_world, g_new;
+  int        **base_ptrs;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &me);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (me == 0) printf("ARMCI group barrier test starting on %d procs\n", nproc);
+
+  ARMCI_Group_get_world(&g_world);
+  ARMCIX_Group_split(&g_world, me%2, me, &g_new);
+
+  ARMCI_Group_rank(&g_new, &grp_me);
+  ARMCI_Group_size(&g_new, &grp_nproc);
+
+  base_ptrs = malloc(sizeof(int*)*grp_nproc);
+  ARMCI_Malloc_group((void**) base_ptrs, sizeof(int), &g_new);
+
+  nphase = NPHASE * (1 + me%2);
+
+  for (phase = 0; phase < nphase; phase++) {
+    const int right = (grp_me + 1) % grp_nproc;
+    const int left  = (grp_me + grp_nproc - 1) % grp_nproc;
+    int       val   = phase*grp_nproc + grp_me;
+
+    /* Write my value to my right neighbor */
+    ARMCI_Put(&val, base_ptrs[right], sizeof(int), ARMCI_Absolute_id(&g_new, right));
+    ARMCIX_AllFence_group(&g_new);
+    ARMCIX_Barrier_group(&g_new);
+
+    ARMCI_Access_begin(base_ptrs[grp_me]);
+    if (*base_ptrs[grp_me] != phase*grp_nproc + left) {
+      printf("%d: phase %d, expected %d got %d\n", me, phase, phase*grp_nproc + left, *base_ptrs[grp_me]);
+      errors++;
+    }
+    ARMCI_Access_end(base_ptrs[grp_me]);
+
+    /* Do not let my left neighbor overwrite the value before I checked it */
+    ARMCIX_Barrier_group(&g_new);
+  }
+
+  ARMCI_Free_group(base_ptrs[grp_me], &g_new);
+  ARMCI_Group_free(&g_new);
+  free(base_ptrs);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (me == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else             printf("Test fail: %d errors.\n", errors);
+  }
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mpi.h>
+#include <armci.h>
+
+/* Global operations on private and shared buffers: non-blocking all-reduce
+ * completed with both wait and test, and root-only reductions, blocking and
+ * non-blocking, whose result must appear on the root only. */
+
+#define DATA_SZ 100
+
+
+/** Integers in shared space, doubles in private space.
+  */
+static void fill(int *ibuf, double *dbuf, int rank) {
+  int i;
+
+  ARMCI_Access_begin(ibuf);
+  for (i = 0; i < DATA_SZ; i++) {
+    ibuf[i] = rank + i;
+    dbuf[i] = (rank+1) * ((i % 2) ? -1.0 : 1.0);
+  }
+  ARMCI_Access_end(ibuf);
+}
+
+
+/** Check the sum of the integers and the absmax of the doubles, which are
+  * only reduced on the root if root_only is set.
+  */
+static int check(const int *ibuf, const double *dbuf, int rank, int nproc, int root_only) {
+  int i, errors = 0;
+
+  ARMCI_Access_begin((void*) ibuf);
+  for (i = 0; i < DATA_SZ; i++) {
+    const int    reduced = !root_only || rank == 0;
+    const int    iexp    = reduced ? nproc*(nproc-1)/2 + nproc*i : rank + i;
+    const double dexp    = reduced ? nproc : (rank+1) * ((i % 2) ? -1.0 : 1.0);
+
+    if (ibuf[i] != iexp) {
+      printf("%d: ibuf[%d] = %d, expected %d\n", rank, i, ibuf[i], iexp);
+      errors++;
+    }
+
+    if (dbuf[i] != dexp) {
+      printf("%d: dbuf[%d] = %f, expected %f\n", rank, i, dbuf[i], dexp);
+      errors++;
+    }
+  }
+  ARMCI_Access_end((void*) ibuf);
+
+  return errors;
+}
+
+int main(int argc, char ** argv) {
+  int              rank, nproc, errors = 0;
+  int             *ibuf;
+  double          *dbuf;
+  long             lval;
+  void           **base_ptrs;
+  armci_msg_hdl_t  ihdl, dhdl;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (rank == 0) printf("Starting ARMCI GOP and root-only reduction test with %d processes\n", nproc);
+
+  base_ptrs = malloc(nproc*sizeof(void*));
+  ARMCI_Malloc(base_ptrs, DATA_SZ*sizeof(int));
+  ibuf = base_ptrs[rank];
+  dbuf = malloc(DATA_SZ*sizeof(double));
+
+  /* Non-blocking all-reduce */
+  fill(ibuf, dbuf, rank);
+
+  armci_msg_igop_nb(ibuf, DATA_SZ, "+", &ihdl);
+  armci_msg_dgop_nb(dbuf, DATA_SZ, "absmax", &dhdl);
+
+  while (!armci_msg_test(&dhdl))
+    ;
+
+  armci_msg_wait(&ihdl);
+
+  if (ihdl != NULL || dhdl != NULL) {
+    printf("%d: handles were not released\n", rank);
+    errors++;
+  }
+
+  errors += check(ibuf, dbuf, rank, nproc, 0);
+
+  /* Root-only reductions, blocking and non-blocking */
+  fill(ibuf, dbuf, rank);
+
+  armci_msg_reduce(ibuf, DATA_SZ, "+", ARMCI_INT);
+  armci_msg_reduce_scope_nb(SCOPE_ALL, dbuf, DATA_SZ, "absmax", ARMCI_DOUBLE, &dhdl);
+  armci_msg_wait(&dhdl);
+
+  errors += check(ibuf, dbuf, rank, nproc, 1);
+
+  /* Node scope: each node master receives the sum over its node */
+  {
+    MPI_Comm node_comm;
+    int      node_rank, node_size;
+
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+    MPI_Comm_rank(node_comm, &node_rank);
+    MPI_Comm_size(node_comm, &node_size);
+
+    lval = 1;
+    armci_msg_reduce_scope(SCOPE_NODE, &lval, 1, "+", ARMCI_LONG);
+
+    if (lval != ((node_rank == 0) ? node_size : 1)) {
+      printf("%d: node reduction gave %ld\n", rank, lval);
+      errors++;
+    }
+
+    MPI_Comm_free(&node_comm);
+  }
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (rank == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else             printf("Test fail: %d errors.\n", errors);
+  }
+
+  ARMCI_Free(base_ptrs[rank]);
+  free(base_ptrs);
+  free(dbuf);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
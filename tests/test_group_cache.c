@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <armci.h>
+#include <armcix.h>
+#include <armci_internals.h>
+
+/* Repeatedly create and free the same subgroups, checking that repeated
+ * creations reuse the cached communicator and that the groups stay usable.
+ * With room for unreferenced groups in the cache, a freed group must also be
+ * reused by the next creation, but not by a child of a different parent with
+ * the same members. */
+
+#define NITER 20
+
+int main(int argc, char **argv) {
+  int          me, nproc, i, iter, errors = 0;
+  int         *procs, nprocs;
+  ARMCI_Group  g_world, g_a, g_b;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &me);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (me == 0) printf("ARMCI Group cache test starting on %d procs\n", nproc);
+
+  ARMCI_Group_get_world(&g_world);
+
+  procs = malloc(sizeof(int)*nproc);
+
+  /* Even ranks */
+  for (i = 0, nprocs = 0; i < nproc; i += 2)
+    procs[nprocs++] = i;
+
+  for (iter = 0; iter < NITER; iter++) {
+    int val = 1;
+
+    ARMCI_Group_create_child(nprocs, procs, &g_a, &g_world);
+
+    if (me % 2 == 0) {
+      /* A second creation while the first is live must return the same group */
+      ARMCI_Group_create_child(nprocs, procs, &g_b, &g_world);
+
+      if (ARMCII_GLOBAL_STATE.group_cache && g_a.comm != g_b.comm) {
+        printf("%d: iteration %d, live group was not reused\n", me, iter);
+        errors++;
+      }
+
+      armci_msg_group_igop(&val, 1, "+", &g_b);
+      ARMCI_Group_free(&g_b);
+
+      armci_msg_group_igop(&val, 1, "+", &g_a);
+      if (val != nprocs*nprocs) {
+        printf("%d: iteration %d, group sum %d, expected %d\n", me, iter, val, nprocs*nprocs);
+        errors++;
+      }
+
+      ARMCI_Group_free(&g_a);
+    }
+    else if (!ARMCII_GLOBAL_STATE.noncollective_groups) {
+      /* Non-members take part in collective creation */
+      ARMCI_Group_create_child(nprocs, procs, &g_b, &g_world);
+    }
+  }
+
+  if (ARMCII_GLOBAL_STATE.group_cache && !ARMCII_GLOBAL_STATE.noncollective_groups) {
+    MPI_Comm first = MPI_COMM_NULL;
+
+    ARMCII_GLOBAL_STATE.group_cache_size = 1;
+
+    for (iter = 0; iter < 2; iter++) {
+      ARMCI_Group_create_child(nprocs, procs, &g_a, &g_world);
+
+      if (me % 2 == 0) {
+        if (iter == 0)
+          first = g_a.comm;
+        else if (g_a.comm != first) {
+          printf("%d: freed group was not kept for reuse\n", me);
+          errors++;
+        }
+
+        ARMCI_Group_free(&g_a);
+      }
+    }
+
+    /* A live child of a freed parent must not be found through a new
+       parent, even if it gets the same communicator handle */
+    for (iter = 0; iter < 2; iter++) {
+      ARMCI_Group g_parent;
+
+      ARMCIX_Group_dup(&g_world, &g_parent);
+      ARMCI_Group_create_child(nprocs, procs, iter == 0 ? &g_b : &g_a, &g_parent);
+      ARMCI_Group_free(&g_parent);
+    }
+
+    if (me % 2 == 0) {
+      int val = 1;
+
+      if (g_a.comm == g_b.comm) {
+        printf("%d: group was reused from a freed parent\n", me);
+        errors++;
+      }
+
+      armci_msg_group_igop(&val, 1, "+", &g_a);
+      if (val != nprocs) {
+        printf("%d: group sum %d, expected %d\n", me, val, nprocs);
+        errors++;
+      }
+
+      ARMCI_Group_free(&g_a);
+      ARMCI_Group_free(&g_b);
+    }
+  }
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (me == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else             printf("Test fail: %d errors.\n", errors);
+  }
+
+  free(procs);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <armci.h>
+#include <armcix.h>
+#include <armci_internals.h>
+
+/* Check translation between group and absolute ranks against MPI for strided,
+ * reversed, and irregular groups. */
+
+static int check_group(ARMCI_Group *group, const char *name) {
+  MPI_Group world_group, sub_group;
+  int       i, errors = 0;
+
+  MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+  MPI_Comm_group(group->comm, &sub_group);
+
+  for (i = 0; i < group->size; i++) {
+    int expected;
+
+    MPI_Group_translate_ranks(sub_group, 1, &i, world_group, &expected);
+
+    if (ARMCI_Absolute_id(group, i) != expected) {
+      printf("%s: group rank %d translated to %d, expected %d\n", name, i,
+             ARMCI_Absolute_id(group, i), expected);
+      errors++;
+    }
+  }
+
+  for (i = 0; i < ARMCI_GROUP_WORLD.size; i++) {
+    int expected;
+
+    MPI_Group_translate_ranks(world_group, 1, &i, sub_group, &expected);
+    if (expected == MPI_UNDEFINED) expected = -1;
+
+    if (ARMCII_Translate_absolute_to_group(group, i) != expected) {
+      printf("%s: absolute rank %d translated to %d, expected %d\n", name, i,
+             ARMCII_Translate_absolute_to_group(group, i), expected);
+      errors++;
+    }
+  }
+
+  MPI_Group_free(&world_group);
+  MPI_Group_free(&sub_group);
+
+  return errors;
+}
+
+int main(int argc, char **argv) {
+  int          me, nproc, errors = 0;
+  ARMCI_Group  g_world, g_new;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &me);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (me == 0) printf("ARMCI Group rank translation test starting on %d procs\n", nproc);
+
+  ARMCI_Group_get_world(&g_world);
+  
+  if (me == 0) printf(" + Strided groups\n");
+
+  ARMCIX_Group_split(&g_world, me%2, me, &g_new);
+  errors += check_group(&g_new, "strided");
+  ARMCI_Group_free(&g_new);
+
+  if (me == 0) printf(" + Reversed groups\n");
+
+  ARMCIX_Group_split(&g_world, me%2, -me, &g_new);
+  errors += check_group(&g_new, "reversed");
+  ARMCI_Group_free(&g_new);
+
+  if (me == 0) printf(" + Irregular groups\n");
+
+  ARMCIX_Group_split(&g_world, (me*me)%3, (me*7)%5, &g_new);
+  errors += check_group(&g_new, "irregular");
+  ARMCI_Group_free(&g_new);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (me == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else             printf("Test fail: %d errors.\n", errors);
+  }
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
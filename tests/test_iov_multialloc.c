@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+
+#define NSEG 64
+#define SEGLEN 16
+
+/* Exercise IOV operations whose remote segments alternate between two
+ * separate allocations. */
+
+int main(int argc, char **argv) {
+    int i, j, rank, nranks, peer, errors = 0;
+    double **buf_a, **buf_b, *loc_buf;
+    armci_giov_t iov;
+
+    MPI_Init(&argc, &argv);
+    ARMCI_Init();
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+    if (rank == 0)
+        printf("ARMCI I/O Vector Multiple Allocation Test:\n");
+
+    buf_a = malloc(nranks*sizeof(double*));
+    buf_b = malloc(nranks*sizeof(double*));
+    ARMCI_Malloc((void **) buf_a, NSEG/2*SEGLEN*sizeof(double));
+    ARMCI_Malloc((void **) buf_b, NSEG/2*SEGLEN*sizeof(double));
+    loc_buf = ARMCI_Malloc_local(NSEG*SEGLEN*sizeof(double));
+
+    peer = (rank+1) % nranks;
+
+    iov.bytes                = SEGLEN*sizeof(double);
+    iov.ptr_array_len        = NSEG;
+    iov.src_ptr_array        = malloc(NSEG*sizeof(void*));
+    iov.dst_ptr_array        = malloc(NSEG*sizeof(void*));
+
+    /* Even segments go to A, odd segments go to B */
+    for (i = 0; i < NSEG; i++) {
+      double *rem = (i % 2) ? buf_b[peer] : buf_a[peer];
+      iov.src_ptr_array[i] = &loc_buf[i*SEGLEN];
+      iov.dst_ptr_array[i] = &rem[(i/2)*SEGLEN];
+    }
+
+    for (i = 0; i < NSEG*SEGLEN; i++)
+      loc_buf[i] = rank*NSEG*SEGLEN + i;
+
+    ARMCI_Barrier();
+    ARMCI_PutV(&iov, 1, peer);
+    ARMCI_Barrier();
+
+    /* Check the data put into my buffers by my left neighbor */
+    ARMCI_Access_begin(buf_a[rank]);
+    ARMCI_Access_begin(buf_b[rank]);
+    for (i = 0; i < NSEG; i++) {
+      const int left = (rank+nranks-1) % nranks;
+      double *mine = (i % 2) ? buf_b[rank] : buf_a[rank];
+
+      for (j = 0; j < SEGLEN; j++) {
+        const double expected = left*NSEG*SEGLEN + i*SEGLEN + j;
+        if (mine[(i/2)*SEGLEN + j] != expected) {
+          printf("%d: PutV mismatch at segment %d, element %d: expected %f, got %f\n",
+              rank, i, j, expected, mine[(i/2)*SEGLEN + j]);
+          errors++;
+        }
+      }
+    }
+    ARMCI_Access_end(buf_b[rank]);
+    ARMCI_Access_end(buf_a[rank]);
+
+    ARMCI_Barrier();
+
+    /* Read the same segments back from the peer */
+    for (i = 0; i < NSEG*SEGLEN; i++)
+      loc_buf[i] = -1.0;
+
+    iov.src_ptr_array = iov.dst_ptr_array;
+    iov.dst_ptr_array = malloc(NSEG*sizeof(void*));
+    for (i = 0; i < NSEG; i++)
+      iov.dst_ptr_array[i] = &loc_buf[i*SEGLEN];
+
+    ARMCI_GetV(&iov, 1, peer);
+
+    for (i = 0; i < NSEG*SEGLEN; i++) {
+      const double expected = rank*NSEG*SEGLEN + i;
+      if (loc_buf[i] != expected) {
+        printf("%d: GetV mismatch at %d: expected %f, got %f\n", rank, i, expected, loc_buf[i]);
+        errors++;
+      }
+    }
+
+    ARMCI_Barrier();
+
+    free(iov.src_ptr_array);
+    free(iov.dst_ptr_array);
+
+    ARMCI_Free(buf_a[rank]);
+    ARMCI_Free(buf_b[rank]);
+    ARMCI_Free_local(loc_buf);
+    free(buf_a);
+    free(buf_b);
+
+    if (errors == 0) {
+      if (rank == 0) printf("Test complete: PASS.\n");
+    } else {
+      printf("%d: Test complete: FAIL (%d errors).\n", rank, errors);
+    }
+
+    ARMCI_Finalize();
+    MPI_Finalize();
+
+    return errors != 0;
+}
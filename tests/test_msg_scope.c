@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mpi.h>
+#include <armci.h>
+
+/* Scoped reductions and broadcasts: SCOPE_NODE and SCOPE_MASTERS results are
+ * checked against node communicators built here, and SCOPE_ALL is checked
+ * with messages above and below the two-level collective threshold. */
+
+#define SMALL_SZ 16
+#define LARGE_SZ 100000
+
+int main(int argc, char ** argv) {
+  int       rank, nproc, node_rank, node_size, nnodes, is_master, i, errors = 0;
+  int       master, node_sum, val;
+  double   *buf;
+  MPI_Comm  node_comm;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (rank == 0) printf("Starting ARMCI scoped collectives test with %d processes\n", nproc);
+
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+  MPI_Comm_rank(node_comm, &node_rank);
+  MPI_Comm_size(node_comm, &node_size);
+
+  is_master = (node_rank == 0);
+  MPI_Allreduce(&is_master, &nnodes, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+
+  master = rank;
+  MPI_Bcast(&master, 1, MPI_INT, 0, node_comm);
+  MPI_Allreduce(&rank, &node_sum, 1, MPI_INT, MPI_SUM, node_comm);
+
+  /* SCOPE_NODE reduction */
+  val = rank;
+  armci_msg_gop_scope(SCOPE_NODE, &val, 1, "+", ARMCI_INT);
+  if (val != node_sum) {
+    printf("%d: SCOPE_NODE sum %d, expected %d\n", rank, val, node_sum);
+    errors++;
+  }
+
+  /* SCOPE_MASTERS reduction: non-masters are unchanged */
+  val = 1;
+  armci_msg_gop_scope(SCOPE_MASTERS, &val, 1, "+", ARMCI_INT);
+  if (val != (is_master ? nnodes : 1)) {
+    printf("%d: SCOPE_MASTERS sum %d, expected %d\n", rank, val, is_master ? nnodes : 1);
+    errors++;
+  }
+
+  /* SCOPE_NODE broadcast from each node's master */
+  val = (rank == master) ? -master : 0;
+  armci_msg_bcast_scope(SCOPE_NODE, &val, sizeof(int), master);
+  if (val != -master) {
+    printf("%d: SCOPE_NODE bcast %d, expected %d\n", rank, val, -master);
+    errors++;
+  }
+
+  /* SCOPE_ALL reductions and broadcasts, flat and two-level */
+  buf = malloc(LARGE_SZ*sizeof(double));
+
+  for (int n = SMALL_SZ; n <= LARGE_SZ; n = (n == SMALL_SZ) ? LARGE_SZ : LARGE_SZ+1) {
+    for (i = 0; i < n; i++)
+      buf[i] = (rank+1) * ((i % 2) ? -1.0 : 1.0);
+
+    armci_msg_dgop(buf, n, "absmax");
+
+    for (i = 0; i < n; i++) {
+      if (buf[i] != nproc) {
+        printf("%d: absmax buf[%d] = %f, expected %d\n", rank, i, buf[i], nproc);
+        errors++;
+        break;
+      }
+    }
+
+    for (i = 0; i < n; i++)
+      buf[i] = (rank == nproc-1) ? i : -1.0;
+
+    armci_msg_bcast(buf, n*sizeof(double), nproc-1);
+
+    for (i = 0; i < n; i++) {
+      if (buf[i] != i) {
+        printf("%d: bcast buf[%d] = %f, expected %d\n", rank, i, buf[i], i);
+        errors++;
+        break;
+      }
+    }
+  }
+
+  free(buf);
+  MPI_Comm_free(&node_comm);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (rank == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else             printf("Test fail: %d errors.\n", errors);
+  }
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mpi.h>
+#include <armci.h>
+
+/* Index selection with a packed value and int index, which maps to MINLOC
+ * and MAXLOC, and with layouts that use the generic select operation,
+ * including padded structs and 64-bit indices of the same size.  Odd ranks
+ * do not contribute. */
+
+typedef struct { double    val; int  idx; } dbl_int_t;
+typedef struct { long      val; int  idx; } long_int_t;
+typedef struct { double    val; long idx; } dbl_long_t;
+typedef struct { long      val; long idx; } long_long_t;
+typedef struct { double    val; long idx[2]; } dbl_long2_t;
+typedef struct { long long val; int  idx; } ll_int_t;
+
+int main(int argc, char ** argv) {
+  int rank, nproc, last, errors = 0;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (rank == 0) printf("Starting ARMCI select test with %d processes\n", nproc);
+
+  /* Highest contributing rank */
+  last = (nproc - 1) - ((nproc - 1) % 2);
+
+  /* Value and int index, packed without trailing padding */
+  {
+    dbl_int_t x;
+
+    x.val = -1.0 * rank;
+    x.idx = 10 * rank;
+    armci_msg_sel(&x, sizeof(double) + sizeof(int), "min", ARMCI_DOUBLE, rank % 2 == 0);
+
+    if (x.val != -1.0 * last || x.idx != 10 * last) {
+      printf("%d: double min gave (%f, %d), expected (%f, %d)\n", rank, x.val, x.idx, -1.0 * last, 10 * last);
+      errors++;
+    }
+  }
+
+  /* Value and int index, passed with the size of the padded struct */
+  {
+    dbl_int_t x;
+
+    x.val = rank;
+    x.idx = 10 * rank;
+    armci_msg_sel(&x, sizeof(x), "max", ARMCI_DOUBLE, rank % 2 == 0);
+
+    if (x.val != last || x.idx != 10 * last) {
+      printf("%d: padded double max gave (%f, %d), expected (%d, %d)\n", rank, x.val, x.idx, last, 10 * last);
+      errors++;
+    }
+  }
+
+  {
+    long_int_t x;
+
+    x.val = 100 - rank;
+    x.idx = rank;
+    armci_msg_sel(&x, sizeof(x), "min", ARMCI_LONG, rank % 2 == 0);
+
+    if (x.val != 100 - last || x.idx != last) {
+      printf("%d: padded long min gave (%ld, %d), expected (%d, %d)\n", rank, x.val, x.idx, 100 - last, last);
+      errors++;
+    }
+  }
+
+  {
+    int x[2];
+
+    x[0] = rank;
+    x[1] = 10 * rank;
+    armci_msg_sel(x, sizeof(x), "max", ARMCI_INT, rank % 2 == 0);
+
+    if (x[0] != last || x[1] != 10 * last) {
+      printf("%d: int max gave (%d, %d), expected (%d, %d)\n", rank, x[0], x[1], last, 10 * last);
+      errors++;
+    }
+  }
+
+  /* Value and long index, as used with a 64-bit GA Integer */
+  {
+    dbl_long_t x;
+    const long big = (1L << 40) + 1;
+
+    x.val = rank;
+    x.idx = big * (rank + 1);
+    armci_msg_sel(&x, sizeof(x), "max", ARMCI_DOUBLE, rank % 2 == 0);
+
+    if (x.val != last || x.idx != big * (last + 1)) {
+      printf("%d: double/long max gave (%f, %ld), expected (%d, %ld)\n", rank, x.val, x.idx,
+             last, big * (last + 1));
+      errors++;
+    }
+  }
+
+  {
+    long_long_t x;
+    const long big = (1L << 40) + 1;
+
+    x.val = 100 - rank;
+    x.idx = -big * (rank + 1);
+    armci_msg_sel(&x, sizeof(x), "min", ARMCI_LONG, rank % 2 == 0);
+
+    if (x.val != 100 - last || x.idx != -big * (last + 1)) {
+      printf("%d: long/long min gave (%ld, %ld), expected (%d, %ld)\n", rank, x.val, x.idx,
+             100 - last, -big * (last + 1));
+      errors++;
+    }
+  }
+
+  /* Layouts without an MPI pair type */
+  {
+    dbl_long2_t x;
+
+    x.val    = rank;
+    x.idx[0] = 10 * rank;
+    x.idx[1] = 20 * rank;
+    armci_msg_sel(&x, sizeof(x), "max", ARMCI_DOUBLE, rank % 2 == 0);
+
+    if (x.val != last || x.idx[0] != 10 * last || x.idx[1] != 20 * last) {
+      printf("%d: double max gave (%f, %ld, %ld), expected (%d, %d, %d)\n", rank, x.val, x.idx[0], x.idx[1],
+             last, 10 * last, 20 * last);
+      errors++;
+    }
+  }
+
+  {
+    ll_int_t x;
+
+    x.val = 100 - rank;
+    x.idx = rank;
+    armci_msg_sel(&x, sizeof(long long) + sizeof(int), "min", ARMCI_LONG_LONG, rank % 2 == 0);
+
+    if (x.val != 100 - last || x.idx != last) {
+      printf("%d: long long min gave (%lld, %d), expected (%d, %d)\n", rank, x.val, x.idx, 100 - last, last);
+      errors++;
+    }
+  }
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (rank == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else             printf("Test fail: %d errors.\n", errors);
+  }
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
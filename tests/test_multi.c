@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define ROWS 4
+#define COLS 8
+#define BLOCK (ROWS*COLS)
+
+/* Every process writes its own block on every other process with one
+ * multi-target strided put, reads them back with one multi-target vector
+ * get, and finally accumulates into them with a multi-target strided acc. */
+
+int main(int argc, char **argv) {
+    int i, p, rank, nranks, errors = 0;
+    int **buffer, *loc_buf;
+    int count[2], stride, stride_level;
+    armcix_strided_multi_t *s_entries;
+    armcix_giov_multi_t    *v_entries;
+    armci_giov_t           *iovs;
+    int one = 1;
+
+    MPI_Init(&argc, &argv);
+    ARMCI_Init();
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+    if (rank == 0)
+        printf("ARMCI Multi-target Test:\n");
+
+    buffer = malloc(nranks*sizeof(int*));
+    ARMCI_Malloc((void **) buffer, nranks*BLOCK*sizeof(int));
+    loc_buf = ARMCI_Malloc_local(nranks*BLOCK*sizeof(int));
+
+    for (i = 0; i < BLOCK; i++)
+      loc_buf[i] = rank*1000 + i;
+
+    stride       = COLS*sizeof(int);
+    stride_level = 1;
+    count[0]     = COLS*sizeof(int);
+    count[1]     = ROWS;
+
+    s_entries = malloc(nranks*sizeof(armcix_strided_multi_t));
+    for (p = 0; p < nranks; p++) {
+      s_entries[p].proc          = p;
+      s_entries[p].src_ptr       = loc_buf;
+      s_entries[p].src_stride_ar = &stride;
+      s_entries[p].dst_ptr       = &buffer[p][rank*BLOCK];
+      s_entries[p].dst_stride_ar = &stride;
+      s_entries[p].count         = count;
+      s_entries[p].stride_levels = stride_level;
+    }
+
+    ARMCI_Barrier();
+    ARMCIX_PutS_multi(s_entries, nranks);
+    ARMCI_Barrier();
+
+    ARMCI_Access_begin(buffer[rank]);
+    for (p = 0; p < nranks; p++)
+      for (i = 0; i < BLOCK; i++)
+        if (buffer[rank][p*BLOCK + i] != p*1000 + i) {
+          printf("%d: PutS_multi mismatch from %d at %d: expected %d, got %d\n",
+              rank, p, i, p*1000 + i, buffer[rank][p*BLOCK + i]);
+          errors++;
+        }
+    ARMCI_Access_end(buffer[rank]);
+
+    ARMCI_Barrier();
+
+    /* Read my block back from every process, one row per segment */
+    iovs      = malloc(nranks*sizeof(armci_giov_t));
+    v_entries = malloc(nranks*sizeof(armcix_giov_multi_t));
+    for (p = 0; p < nranks; p++) {
+      iovs[p].bytes         = COLS*sizeof(int);
+      iovs[p].ptr_array_len = ROWS;
+      iovs[p].src_ptr_array = malloc(ROWS*sizeof(void*));
+      iovs[p].dst_ptr_array = malloc(ROWS*sizeof(void*));
+
+      for (i = 0; i < ROWS; i++) {
+        iovs[p].src_ptr_array[i] = &buffer[p][rank*BLOCK + i*COLS];
+        iovs[p].dst_ptr_array[i] = &loc_buf[p*BLOCK + i*COLS];
+      }
+
+      v_entries[p].proc    = p;
+      v_entries[p].iov     = &iovs[p];
+      v_entries[p].iov_len = 1;
+    }
+
+    ARMCIX_GetV_multi(v_entries, nranks);
+
+    for (p = 0; p < nranks; p++)
+      for (i = 0; i < BLOCK; i++)
+        if (loc_buf[p*BLOCK + i] != rank*1000 + i) {
+          printf("%d: GetV_multi mismatch from %d at %d: expected %d, got %d\n",
+              rank, p, i, rank*1000 + i, loc_buf[p*BLOCK + i]);
+          errors++;
+        }
+
+    ARMCI_Barrier();
+
+    /* Add one to my block on every process */
+    for (i = 0; i < BLOCK; i++)
+      loc_buf[i] = 1;
+
+    ARMCIX_AccS_multi(ARMCI_ACC_INT, &one, s_entries, nranks);
+    ARMCI_Barrier();
+
+    ARMCI_Access_begin(buffer[rank]);
+    for (p = 0; p < nranks; p++)
+      for (i = 0; i < BLOCK; i++)
+        if (buffer[rank][p*BLOCK + i] != p*1000 + i + 1) {
+          printf("%d: AccS_multi mismatch from %d at %d: expected %d, got %d\n",
+              rank, p, i, p*1000 + i + 1, buffer[rank][p*BLOCK + i]);
+          errors++;
+        }
+    ARMCI_Access_end(buffer[rank]);
+
+    for (p = 0; p < nranks; p++) {
+      free(iovs[p].src_ptr_array);
+      free(iovs[p].dst_ptr_array);
+    }
+    free(iovs);
+    free(v_entries);
+    free(s_entries);
+
+    ARMCI_Free(buffer[rank]);
+    ARMCI_Free_local(loc_buf);
+    free(buffer);
+
+    if (errors == 0) {
+      if (rank == 0) printf("Test complete: PASS.\n");
+    } else {
+      printf("%d: Test complete: FAIL (%d errors).\n", rank, errors);
+    }
+
+    ARMCI_Finalize();
+    MPI_Finalize();
+
+    return errors != 0;
+}
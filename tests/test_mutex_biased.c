@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+/** ARMCI biased mutex test
+  *
+  * With ARMCI_MUTEX_BIASED, every process first re-acquires a mutex on its
+  * right neighbor many times in a row, which should be served from its cache.
+  * All processes then contend for a single mutex on process 0, with lock and
+  * trylock, so that cached ownership is revoked over and over.  Shared
+  * counters guarded by the mutexes check mutual exclusion.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NITER 500
+
+static void increment(int *ptr, int proc) {
+  int val;
+
+  ARMCI_Get(ptr, &val, sizeof(int), proc);
+  val++;
+  ARMCI_Put(&val, ptr, sizeof(int), proc);
+  ARMCI_Fence(proc);
+}
+
+int main(int argc, char ** argv) {
+  int    rank, nproc, right, i, errors = 0;
+  int  **base;
+  double t_cached;
+  armcix_mutex_hdl_t mhdl;
+  ARMCI_Group world_group;
+
+  MPI_Init(&argc, &argv);
+
+  setenv("ARMCI_MUTEX_BIASED", "1", 1);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (rank == 0) printf("Starting ARMCI biased mutex test with %d processes\n", nproc);
+
+  base = malloc(nproc*sizeof(int*));
+  ARMCI_Malloc((void**) base, 2*sizeof(int));
+
+  ARMCI_Access_begin(base[rank]);
+  base[rank][0] = 0;
+  base[rank][1] = 0;
+  ARMCI_Access_end(base[rank]);
+
+  ARMCI_Group_get_world(&world_group);
+  mhdl  = ARMCIX_Create_mutexes_hdl(2, &world_group);
+  right = (rank + 1) % nproc;
+
+  ARMCI_Barrier();
+
+  /* Uncontended: mutex 0 on my right neighbor is only used by me */
+  t_cached = MPI_Wtime();
+  for (i = 0; i < NITER; i++) {
+    ARMCIX_Lock_hdl(mhdl, 0, right);
+    increment(&base[right][0], right);
+    ARMCIX_Unlock_hdl(mhdl, 0, right);
+  }
+  t_cached = MPI_Wtime() - t_cached;
+
+  /* Contended: everyone alternates lock and trylock on mutex 1 on process 0 */
+  for (i = 0; i < NITER; i++) {
+    if (i % 2)
+      ARMCIX_Lock_hdl(mhdl, 1, 0);
+    else
+      while (ARMCIX_Trylock_hdl(mhdl, 1, 0))
+        ;
+
+    increment(&base[0][1], 0);
+    ARMCIX_Unlock_hdl(mhdl, 1, 0);
+  }
+
+  ARMCI_Barrier();
+
+  ARMCI_Access_begin(base[rank]);
+  if (base[rank][0] != NITER) {
+    printf("%3d -- uncontended counter is %d, expected %d\n", rank, base[rank][0], NITER);
+    errors++;
+  }
+  if (rank == 0 && base[rank][1] != NITER*nproc) {
+    printf("%3d -- contended counter is %d, expected %d\n", rank, base[rank][1], NITER*nproc);
+    errors++;
+  }
+  ARMCI_Access_end(base[rank]);
+
+  if (rank == 0)
+    printf("uncontended lock/unlock: %.3f us per iteration\n", 1.0e6*t_cached/NITER);
+
+  ARMCIX_Destroy_mutexes_hdl(mhdl);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (rank == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else            printf("Test fail: %d errors.\n", errors);
+  }
+
+  ARMCI_Free(base[rank]);
+  free(base);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
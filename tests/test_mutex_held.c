@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+/** ARMCI Mutex test with many mutexes held at once
+  *
+  * Every process takes NHELD mutexes, spread over all processes, before
+  * releasing any of them; this is more than the default number of queue nodes,
+  * so ARMCI_MUTEX_QNODES is raised unless it is already set.  All processes
+  * lock in the same order, with lock and then with trylock, and increment a
+  * shared counter guarded by each mutex.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NHELD  160
+#define NITER  10
+
+static void increment(int *ptr, int proc) {
+  int val;
+
+  ARMCI_Get(ptr, &val, sizeof(int), proc);
+  val++;
+  ARMCI_Put(&val, ptr, sizeof(int), proc);
+  ARMCI_Fence(proc);
+}
+
+int main(int argc, char ** argv) {
+  int    rank, nproc, nmutex, i, k, errors = 0;
+  int  **base;
+  armcix_mutex_hdl_t mhdl;
+  ARMCI_Group world_group;
+
+  MPI_Init(&argc, &argv);
+
+  setenv("ARMCI_MUTEX_QNODES", "256", 0);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (rank == 0) printf("Starting ARMCIX held mutex test with %d processes\n", nproc);
+
+  /* Mutex k lives on process k % nproc */
+  nmutex = (NHELD + nproc - 1) / nproc;
+
+  base = malloc(nproc*sizeof(int*));
+  ARMCI_Malloc((void**) base, nmutex*sizeof(int));
+
+  ARMCI_Access_begin(base[rank]);
+  for (i = 0; i < nmutex; i++)
+    base[rank][i] = 0;
+  ARMCI_Access_end(base[rank]);
+
+  ARMCI_Group_get_world(&world_group);
+  mhdl = ARMCIX_Create_mutexes_hdl(nmutex, &world_group);
+
+  ARMCI_Barrier();
+
+  for (i = 0; i < 2*NITER; i++) {
+    for (k = 0; k < NHELD; k++) {
+      if (i < NITER)
+        ARMCIX_Lock_hdl(mhdl, k / nproc, k % nproc);
+      else
+        while (ARMCIX_Trylock_hdl(mhdl, k / nproc, k % nproc)) ;
+    }
+
+    for (k = 0; k < NHELD; k++)
+      increment(&base[k % nproc][k / nproc], k % nproc);
+
+    for (k = NHELD-1; k >= 0; k--)
+      ARMCIX_Unlock_hdl(mhdl, k / nproc, k % nproc);
+  }
+
+  ARMCI_Barrier();
+
+  ARMCIX_Destroy_mutexes_hdl(mhdl);
+
+  ARMCI_Access_begin(base[rank]);
+  for (i = 0; i < nmutex; i++) {
+    const int expected = (i*nproc + rank < NHELD) ? 2*NITER*nproc : 0;
+
+    if (base[rank][i] != expected) {
+      printf("%3d -- element %d is %d, expected %d\n", rank, i, base[rank][i], expected);
+      errors++;
+    }
+  }
+  ARMCI_Access_end(base[rank]);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (rank == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else            printf("Test fail: %d errors.\n", errors);
+  }
+
+  ARMCI_Free(base[rank]);
+  free(base);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
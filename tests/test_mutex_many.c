@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+/** ARMCI Mutex test with many mutexes
+  * 
+  * All processes create NUM_MUTEXES mutexes, then lock a strided subset of
+  * the mutexes on every process and use them to protect read-modify-write
+  * updates of a shared array with one element per mutex.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NUM_MUTEXES 100000
+#define STRIDE      97
+
+int main(int argc, char ** argv) {
+  int rank, nproc, i, j, errors = 0;
+  int **base, val;
+  double t_create, t_lock, t_destroy;
+  armcix_mutex_hdl_t mhdl;
+  ARMCI_Group world_group;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (rank == 0) printf("Starting ARMCIX mutex test with %d mutexes and %d processes\n", NUM_MUTEXES, nproc);
+
+  base = malloc(nproc*sizeof(int*));
+  ARMCI_Malloc((void**) base, NUM_MUTEXES*sizeof(int));
+
+  ARMCI_Access_begin(base[rank]);
+  for (j = 0; j < NUM_MUTEXES; j++)
+    base[rank][j] = 0;
+  ARMCI_Access_end(base[rank]);
+
+  ARMCI_Group_get_world(&world_group);
+
+  ARMCI_Barrier();
+  t_create = MPI_Wtime();
+  mhdl = ARMCIX_Create_mutexes_hdl(NUM_MUTEXES, &world_group);
+  t_create = MPI_Wtime() - t_create;
+
+  t_lock = MPI_Wtime();
+  for (i = 0; i < nproc; i++) {
+    const int proc = (rank+i) % nproc;
+
+    for (j = 0; j < NUM_MUTEXES; j += STRIDE) {
+      ARMCIX_Lock_hdl(mhdl, j, proc);
+
+      ARMCI_Get(&base[proc][j], &val, sizeof(int), proc);
+      val++;
+      ARMCI_Put(&val, &base[proc][j], sizeof(int), proc);
+      ARMCI_Fence(proc);
+
+      ARMCIX_Unlock_hdl(mhdl, j, proc);
+    }
+  }
+  t_lock = MPI_Wtime() - t_lock;
+
+  ARMCI_Barrier();
+
+  t_destroy = MPI_Wtime();
+  ARMCIX_Destroy_mutexes_hdl(mhdl);
+  t_destroy = MPI_Wtime() - t_destroy;
+
+  ARMCI_Access_begin(base[rank]);
+  for (j = 0; j < NUM_MUTEXES; j++) {
+    const int expected = (j % STRIDE == 0) ? nproc : 0;
+
+    if (base[rank][j] != expected) {
+      if (errors < 10)
+        printf("%3d -- element %d is %d, expected %d\n", rank, j, base[rank][j], expected);
+      errors++;
+    }
+  }
+  ARMCI_Access_end(base[rank]);
+
+  if (rank == 0)
+    printf("create %.6f s, lock/unlock %.6f s, destroy %.6f s\n", t_create, t_lock, t_destroy);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (rank == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else            printf("Test fail: %d errors.\n", errors);
+  }
+
+  ARMCI_Free(base[rank]);
+  free(base);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+/** ARMCI I/O vector put test for the adaptive BATCHED method
+  *
+  * Every process puts a large I/O vector of small segments, one every other
+  * block, to every process, so that the flush controller issues many flushes
+  * and adapts its window.  The window of each target must stay within the
+  * controller's bounds and under ARMCI_IOV_BATCHED_LIMIT, and the data and the
+  * gaps between segments must be intact.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NSEG       16384
+#define SEGLEN     8
+#define ITERATIONS 4
+#define OPS_LIMIT  256
+
+/* Bounds of the flush window, see vector.c */
+#define MIN_BYTES  (1L << 12)
+#define MAX_BYTES  (1L << 26)
+
+static int check_limits(int rank, int proc, const char *when) {
+  int  max_ops;
+  long max_bytes;
+
+  ARMCIX_Iov_batched_limits(proc, &max_ops, &max_bytes);
+
+  if (max_ops < 1 || max_ops > OPS_LIMIT || max_bytes < MIN_BYTES || max_bytes > MAX_BYTES) {
+    printf("%d: %s, window for target %d out of bounds: max_ops %d, max_bytes %ld\n",
+           rank, when, proc, max_ops, max_bytes);
+    return 1;
+  }
+
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  int i, j, k, rank, nranks, errors = 0;
+  char limit[16];
+  double **buffer, *src_buf;
+  armci_giov_t iov;
+
+  MPI_Init(&argc, &argv);
+
+  setenv("ARMCI_IOV_METHOD", "BATCHED", 1);
+  setenv("ARMCI_IOV_BATCHED_ADAPTIVE", "1", 1);
+  snprintf(limit, sizeof(limit), "%d", OPS_LIMIT);
+  setenv("ARMCI_IOV_BATCHED_LIMIT", limit, 1);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI I/O Vector Put Test (BATCHED):\n");
+
+  /* Each process writes to its own slice of 2*NSEG blocks on every target */
+  buffer = malloc(sizeof(double *) * nranks);
+  ARMCI_Malloc((void **) buffer, (long) nranks * 2 * NSEG * SEGLEN * sizeof(double));
+  src_buf = ARMCI_Malloc_local(NSEG * SEGLEN * sizeof(double));
+
+  ARMCI_Access_begin(buffer[rank]);
+  for (i = 0; i < nranks * 2 * NSEG * SEGLEN; i++)
+    buffer[rank][i] = -1.0;
+  ARMCI_Access_end(buffer[rank]);
+
+  iov.bytes         = SEGLEN * sizeof(double);
+  iov.ptr_array_len = NSEG;
+  iov.src_ptr_array = malloc(NSEG * sizeof(void *));
+  iov.dst_ptr_array = malloc(NSEG * sizeof(void *));
+
+  for (i = 0; i < nranks; i++)
+    errors += check_limits(rank, i, "before the puts");
+
+  ARMCI_Barrier();
+
+  for (k = 0; k < ITERATIONS; k++) {
+    for (j = 0; j < NSEG * SEGLEN; j++)
+      src_buf[j] = rank + k + j / (double) (NSEG * SEGLEN);
+
+    for (i = 0; i < nranks; i++) {
+      const int peer = (rank + i) % nranks;
+
+      for (j = 0; j < NSEG; j++) {
+        iov.src_ptr_array[j] = &src_buf[j * SEGLEN];
+        iov.dst_ptr_array[j] = &buffer[peer][(rank * 2 * NSEG + 2 * j) * SEGLEN];
+      }
+
+      ARMCI_PutV(&iov, 1, peer);
+      errors += check_limits(rank, peer, "after a put");
+    }
+  }
+
+  ARMCI_Barrier();
+
+  ARMCI_Access_begin(buffer[rank]);
+  for (i = 0; i < nranks; i++) {
+    for (j = 0; j < 2 * NSEG * SEGLEN; j++) {
+      const int    blk      = j / SEGLEN;
+      const double actual   = buffer[rank][i * 2 * NSEG * SEGLEN + j];
+      const double expected = (blk % 2) ? -1.0 :
+        i + ITERATIONS - 1 + ((blk / 2) * SEGLEN + j % SEGLEN) / (double) (NSEG * SEGLEN);
+
+      if (actual != expected) {
+        if (errors < 10)
+          printf("%d: Data validation failed at [%d, %d] expected=%f actual=%f\n",
+                 rank, i, j, expected, actual);
+        errors++;
+      }
+    }
+  }
+  ARMCI_Access_end(buffer[rank]);
+
+  free(iov.src_ptr_array);
+  free(iov.dst_ptr_array);
+
+  ARMCI_Free(buffer[rank]);
+  ARMCI_Free_local(src_buf);
+  free(buffer);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (rank == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else            printf("Test fail: %d errors.\n", errors);
+  }
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+/** ARMCI batched RMW test
+  *
+  * All processes allocate one shared integer and one shared long counter per
+  * process.  All processes perform NINC batches, each containing one atomic
+  * fetch-and-add on every counter.  A final batch of swaps reads the counters
+  * back.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NINC 100
+
+int main(int argc, char ** argv) {
+  int        errors = 0;
+  int        rank, nproc, i, j;
+  void     **ibase, **lbase;
+  int       *ops, *values, *procs;
+  void     **ploc, **prem;
+  int       *ivals;
+  long      *lvals;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (rank == 0) printf("Starting ARMCI batched RMW test with %d processes\n", nproc);
+
+  ibase = malloc(sizeof(void*)*nproc);
+  lbase = malloc(sizeof(void*)*nproc);
+  ARMCI_Malloc(ibase, sizeof(int));
+  ARMCI_Malloc(lbase, sizeof(long));
+
+  ARMCI_Access_begin(ibase[rank]);
+  *(int*) ibase[rank] = 0;
+  ARMCI_Access_end(ibase[rank]);
+
+  ARMCI_Access_begin(lbase[rank]);
+  *(long*) lbase[rank] = 0;
+  ARMCI_Access_end(lbase[rank]);
+
+  ops    = malloc(sizeof(int)*2*nproc);
+  values = malloc(sizeof(int)*2*nproc);
+  procs  = malloc(sizeof(int)*2*nproc);
+  ploc   = malloc(sizeof(void*)*2*nproc);
+  prem   = malloc(sizeof(void*)*2*nproc);
+  ivals  = malloc(sizeof(int)*nproc);
+  lvals  = malloc(sizeof(long)*nproc);
+
+  /* Interleave int and long operations so the batch has to be grouped */
+  for (j = 0; j < nproc; j++) {
+    ops[2*j]      = ARMCI_FETCH_AND_ADD;
+    ploc[2*j]     = &ivals[j];
+    prem[2*j]     = ibase[j];
+    procs[2*j]    = j;
+    values[2*j]   = 1;
+
+    ops[2*j+1]    = ARMCI_FETCH_AND_ADD_LONG;
+    ploc[2*j+1]   = &lvals[j];
+    prem[2*j+1]   = lbase[j];
+    procs[2*j+1]  = j;
+    values[2*j+1] = 2;
+  }
+
+  ARMCI_Barrier();
+
+  for (i = 0; i < NINC; i++) {
+    ARMCIX_Rmw_batch(ops, ploc, prem, values, procs, 2*nproc);
+
+    for (j = 0; j < nproc; j++) {
+      if (ivals[j] < 0 || ivals[j] >= NINC*nproc || lvals[j] < 0 || lvals[j] >= 2*NINC*nproc || lvals[j] % 2) {
+        errors++;
+        printf("%3d -- Bad fetched values from %d: %d, %ld\n", rank, j, ivals[j], lvals[j]);
+      }
+    }
+  }
+
+  ARMCI_Barrier();
+
+  /* Swap the counters back to zero and check the old values */
+  for (j = 0; j < nproc; j++) {
+    ops[2*j]   = ARMCI_SWAP;
+    ops[2*j+1] = ARMCI_SWAP_LONG;
+    ivals[j]   = 0;
+    lvals[j]   = 0;
+  }
+
+  if (rank == 0) {
+    ARMCIX_Rmw_batch(ops, ploc, prem, values, procs, 2*nproc);
+
+    for (j = 0; j < nproc; j++) {
+      if (ivals[j] != NINC*nproc || lvals[j] != 2*NINC*nproc) {
+        errors++;
+        printf("%3d -- Got %d and %ld from %d, expected %d and %d\n", rank, ivals[j], lvals[j], j,
+               NINC*nproc, 2*NINC*nproc);
+      }
+    }
+  }
+
+  ARMCI_Barrier();
+
+  ARMCI_Access_begin(lbase[rank]);
+  if (*(long*) lbase[rank] != 0) {
+    errors++;
+    printf("%3d -- Got %ld after swap, expected 0\n", rank, *(long*) lbase[rank]);
+  }
+  ARMCI_Access_end(lbase[rank]);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (rank == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else            printf("Test fail: %d errors.\n", errors);
+  }
+
+  free(ops);
+  free(values);
+  free(procs);
+  free(ploc);
+  free(prem);
+  free(ivals);
+  free(lvals);
+
+  ARMCI_Free(ibase[rank]);
+  ARMCI_Free(lbase[rank]);
+  free(ibase);
+  free(lbase);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
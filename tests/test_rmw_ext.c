@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+/** ARMCI extended RMW test
+  *
+  * All processes allocate one shared record per process.  Every process
+  * increments the integer counters of every other process with
+  * compare-and-swap loops, adds to the floating point fields of every process
+  * with fetch-and-add, and sets bits and extrema with the bitwise and min/max
+  * operations.  Atomic writes and reads check the final values.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NINC 50
+
+typedef struct {
+  int64_t c64;
+  long    cl;
+  int     ci;
+  int     bits;
+  long    mx;
+  long    mn;
+  double  d;
+  float   f;
+} record_t;
+
+/* Increment a remote integer of the given type with a compare-and-swap loop */
+static void cas_increment(int type, void *prem, int proc) {
+  int64_t cur = 0, next, old = 0;
+  long    cur_l, next_l, old_l;
+  int     cur_i, next_i, old_i;
+
+  switch (type) {
+    case ARMCIX_RMW_INT64:
+      ARMCIX_Rmw_ext(ARMCIX_RMW_READ, type, &cur, prem, NULL, NULL, proc);
+      for (;;) {
+        next = cur + 1;
+        ARMCIX_Rmw_ext(ARMCIX_RMW_CAS, type, &old, prem, &next, &cur, proc);
+        if (old == cur) break;
+        cur = old;
+      }
+      break;
+    case ARMCIX_RMW_LONG:
+      cur_l = 0;
+      for (;;) {
+        next_l = cur_l + 1;
+        ARMCIX_Rmw_ext(ARMCIX_RMW_CAS, type, &old_l, prem, &next_l, &cur_l, proc);
+        if (old_l == cur_l) break;
+        cur_l = old_l;
+      }
+      break;
+    case ARMCIX_RMW_INT:
+      cur_i = 0;
+      for (;;) {
+        next_i = cur_i + 1;
+        ARMCIX_Rmw_ext(ARMCIX_RMW_CAS, type, &old_i, prem, &next_i, &cur_i, proc);
+        if (old_i == cur_i) break;
+        cur_i = old_i;
+      }
+      break;
+  }
+}
+
+int main(int argc, char ** argv) {
+  int        errors = 0;
+  int        rank, nproc, i, j;
+  record_t **base;
+  record_t  *mine;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (rank == 0) printf("Starting ARMCI extended RMW test with %d processes\n", nproc);
+
+  base = malloc(sizeof(record_t*)*nproc);
+  ARMCI_Malloc((void**) base, sizeof(record_t));
+  mine = base[rank];
+
+  ARMCI_Access_begin(mine);
+  mine->c64  = 0;
+  mine->cl   = 0;
+  mine->ci   = 0;
+  mine->bits = 0;
+  mine->mx   = 0;
+  mine->mn   = 1 << 20;
+  mine->d    = 0.0;
+  mine->f    = 0.0f;
+  ARMCI_Access_end(mine);
+
+  ARMCI_Barrier();
+
+  for (i = 0; i < NINC; i++) {
+    for (j = 0; j < nproc; j++) {
+      double dval = 0.5;
+      float  fval = 1.0f;
+
+      if (j != rank) {
+        cas_increment(ARMCIX_RMW_INT64, &base[j]->c64, j);
+        cas_increment(ARMCIX_RMW_LONG,  &base[j]->cl,  j);
+        cas_increment(ARMCIX_RMW_INT,   &base[j]->ci,  j);
+      }
+
+      ARMCIX_Rmw_ext(ARMCIX_RMW_FETCH_AND_ADD, ARMCIX_RMW_DOUBLE, NULL, &base[j]->d, &dval, NULL, j);
+      ARMCIX_Rmw_ext(ARMCIX_RMW_FETCH_AND_ADD, ARMCIX_RMW_FLOAT,  NULL, &base[j]->f, &fval, NULL, j);
+    }
+  }
+
+  for (j = 0; j < nproc; j++) {
+    int  bit = 1 << (rank % 31), old_bits;
+    long val_mx = rank + 1, val_mn = rank, old;
+
+    ARMCIX_Rmw_ext(ARMCIX_RMW_FETCH_AND_BOR, ARMCIX_RMW_INT, &old_bits, &base[j]->bits, &bit, NULL, j);
+    ARMCIX_Rmw_ext(ARMCIX_RMW_FETCH_AND_MAX, ARMCIX_RMW_LONG, &old, &base[j]->mx, &val_mx, NULL, j);
+    ARMCIX_Rmw_ext(ARMCIX_RMW_FETCH_AND_MIN, ARMCIX_RMW_LONG, &old, &base[j]->mn, &val_mn, NULL, j);
+  }
+
+  ARMCI_Barrier();
+
+  /* Check the values on my right neighbor, and reset its 64-bit counter with
+   * an atomic write */
+  {
+    const int right = (rank + 1) % nproc;
+    const int nbits = nproc < 31 ? nproc : 31;
+    int64_t   c64, zero = 0;
+    long      mx, mn;
+    int       bits, clear;
+    double    d;
+    float     f;
+
+    ARMCIX_Rmw_ext(ARMCIX_RMW_WRITE, ARMCIX_RMW_INT64, &c64, &base[right]->c64, &zero, NULL, right);
+    ARMCIX_Rmw_ext(ARMCIX_RMW_READ, ARMCIX_RMW_LONG, &mx, &base[right]->mx, NULL, NULL, right);
+    ARMCIX_Rmw_ext(ARMCIX_RMW_READ, ARMCIX_RMW_LONG, &mn, &base[right]->mn, NULL, NULL, right);
+    ARMCIX_Rmw_ext(ARMCIX_RMW_READ, ARMCIX_RMW_INT, &bits, &base[right]->bits, NULL, NULL, right);
+    ARMCIX_Rmw_ext(ARMCIX_RMW_READ, ARMCIX_RMW_DOUBLE, &d, &base[right]->d, NULL, NULL, right);
+    ARMCIX_Rmw_ext(ARMCIX_RMW_READ, ARMCIX_RMW_FLOAT, &f, &base[right]->f, NULL, NULL, right);
+
+    if (c64 != NINC*(nproc-1)) {
+      errors++;
+      printf("%3d -- int64 CAS counter on %d is %ld, expected %d\n", rank, right, (long) c64, NINC*(nproc-1));
+    }
+    if (mx != nproc || mn != 0) {
+      errors++;
+      printf("%3d -- max/min on %d are %ld/%ld, expected %d/0\n", rank, right, mx, mn, nproc);
+    }
+    if (bits != (int) ((1u << nbits) - 1)) {
+      errors++;
+      printf("%3d -- bits on %d are 0x%x, expected 0x%x\n", rank, right, bits, (1u << nbits) - 1);
+    }
+    if (d != 0.5*NINC*nproc || f != (float) (NINC*nproc)) {
+      errors++;
+      printf("%3d -- float sums on %d are %f/%f, expected %f/%f\n", rank, right, d, f,
+             0.5*NINC*nproc, (double) NINC*nproc);
+    }
+
+    /* Clear the bits again: xor with the full mask, then and with zero */
+    clear = (int) ((1u << nbits) - 1);
+    ARMCIX_Rmw_ext(ARMCIX_RMW_FETCH_AND_BXOR, ARMCIX_RMW_INT, NULL, &base[right]->bits, &clear, NULL, right);
+    clear = 0;
+    ARMCIX_Rmw_ext(ARMCIX_RMW_FETCH_AND_BAND, ARMCIX_RMW_INT, NULL, &base[right]->bits, &clear, NULL, right);
+  }
+
+  ARMCI_Barrier();
+
+  ARMCI_Access_begin(mine);
+  if (mine->c64 != 0 || mine->bits != 0) {
+    errors++;
+    printf("%3d -- Got %ld and 0x%x after reset, expected 0\n", rank, (long) mine->c64, mine->bits);
+  }
+  if (mine->cl != NINC*(nproc-1) || mine->ci != NINC*(nproc-1)) {
+    errors++;
+    printf("%3d -- CAS counters are %ld and %d, expected %d\n", rank, mine->cl, mine->ci, NINC*(nproc-1));
+  }
+  ARMCI_Access_end(mine);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (rank == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else            printf("Test fail: %d errors.\n", errors);
+  }
+
+  ARMCI_Free(mine);
+  free(base);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
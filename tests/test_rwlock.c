@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+/** ARMCIX reader-writer lock test
+  *
+  * For each locking mode, all processes update and read a table of records,
+  * one per lock on every process.  Writers increment both fields of a record
+  * under the write lock and readers check that the fields match under the
+  * read lock; the final counts must match the number of writes.  Trylock is
+  * checked against a write lock and a read lock held by other processes.
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NLOCKS 4
+#define NITER  200
+
+typedef struct {
+  long a;
+  long b;
+} record_t;
+
+static const char *mode_names[] = { "reader-pref", "writer-pref", "fair" };
+static const int   mode_flags[] = { 0, ARMCIX_RWLOCK_WRITER_PREF, ARMCIX_RWLOCK_FAIR };
+
+static int test_mode(int mode, record_t **table, int rank, int nproc) {
+  armcix_rwlock_hdl_t hdl;
+  ARMCI_Group         world;
+  record_t            rec;
+  long                nwrites = 0, total = 0;
+  int                 i, j, errors = 0;
+
+  ARMCI_Group_get_world(&world);
+  hdl = ARMCIX_Create_rwlocks_hdl(NLOCKS, &world, mode_flags[mode]);
+
+  for (i = 0; i < NLOCKS; i++)
+    table[rank][i].a = table[rank][i].b = 0;
+
+  srand(rank + 1);
+  ARMCI_Barrier();
+
+  /* Mixed reads and writes, with every third write taken by trylock */
+  for (i = 0; i < NITER; i++) {
+    const int proc     = rand() % nproc;
+    const int lock     = rand() % NLOCKS;
+    const int is_write = (rand() % 4) == 0;
+
+    if (!is_write)
+      ARMCIX_Rdlock_hdl(hdl, lock, proc);
+    else if (i % 3 == 0)
+      while (ARMCIX_Trywrlock_hdl(hdl, lock, proc)) ;
+    else
+      ARMCIX_Wrlock_hdl(hdl, lock, proc);
+
+    ARMCI_Get(&table[proc][lock], &rec, sizeof(record_t), proc);
+
+    if (rec.a != rec.b) {
+      printf("%3d -- %s: record (%d, %d) is inconsistent: %ld != %ld\n", rank,
+             mode_names[mode], proc, lock, rec.a, rec.b);
+      errors++;
+    }
+
+    if (is_write) {
+      rec.a++;
+      ARMCI_Put(&rec.a, &table[proc][lock].a, sizeof(long), proc);
+      ARMCI_Fence(proc);
+      rec.b++;
+      ARMCI_Put(&rec.b, &table[proc][lock].b, sizeof(long), proc);
+      ARMCI_Fence(proc);
+      nwrites++;
+    }
+
+    ARMCIX_Rwunlock_hdl(hdl, lock, proc);
+  }
+
+  ARMCI_Barrier();
+
+  for (i = 0; i < NLOCKS; i++)
+    total += table[rank][i].a;
+
+  armci_msg_lgop(&nwrites, 1, "+");
+  armci_msg_lgop(&total, 1, "+");
+
+  if (rank == 0 && total != nwrites) {
+    printf("%3d -- %s: %ld updates recorded, expected %ld\n", rank, mode_names[mode], total, nwrites);
+    errors++;
+  }
+
+  /* Trylock must fail while process 0 holds a write lock */
+  if (rank == 0)
+    ARMCIX_Wrlock_hdl(hdl, 0, 0);
+
+  ARMCI_Barrier();
+
+  if (rank != 0) {
+    if (ARMCIX_Tryrdlock_hdl(hdl, 0, 0) == 0) {
+      printf("%3d -- %s: read trylock succeeded on a write-locked lock\n", rank, mode_names[mode]);
+      ARMCIX_Rwunlock_hdl(hdl, 0, 0);
+      errors++;
+    }
+    if (ARMCIX_Trywrlock_hdl(hdl, 0, 0) == 0) {
+      printf("%3d -- %s: write trylock succeeded on a write-locked lock\n", rank, mode_names[mode]);
+      ARMCIX_Rwunlock_hdl(hdl, 0, 0);
+      errors++;
+    }
+  }
+
+  ARMCI_Barrier();
+
+  if (rank == 0)
+    ARMCIX_Rwunlock_hdl(hdl, 0, 0);
+
+  ARMCI_Barrier();
+
+  /* All processes share a read lock, which a write trylock must not break */
+  while (ARMCIX_Tryrdlock_hdl(hdl, 0, 0)) ;
+
+  ARMCI_Barrier();
+
+  if (ARMCIX_Trywrlock_hdl(hdl, 0, 0) == 0) {
+    printf("%3d -- %s: write trylock succeeded on a read-locked lock\n", rank, mode_names[mode]);
+    ARMCIX_Rwunlock_hdl(hdl, 0, 0);
+    errors++;
+  }
+
+  ARMCI_Barrier();
+
+  ARMCIX_Rwunlock_hdl(hdl, 0, 0);
+
+  /* Every process takes each lock for writing in turn */
+  for (j = 0; j < NLOCKS; j++) {
+    while (ARMCIX_Trywrlock_hdl(hdl, j, 0)) ;
+    ARMCIX_Rwunlock_hdl(hdl, j, 0);
+  }
+
+  ARMCIX_Destroy_rwlocks_hdl(hdl);
+
+  return errors;
+}
+
+
+int main(int argc, char **argv) {
+  int        rank, nproc, mode, errors = 0;
+  record_t **table;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (rank == 0) printf("Starting ARMCIX rwlock test with %d processes\n", nproc);
+
+  table = malloc(nproc * sizeof(record_t*));
+  ARMCI_Malloc((void**) table, NLOCKS * sizeof(record_t));
+
+  for (mode = 0; mode < 3; mode++)
+    errors += test_mode(mode, table, rank, nproc);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  if (rank == 0) {
+    if (errors == 0) printf("Test complete: PASS.\n");
+    else            printf("Test fail: %d errors.\n", errors);
+  }
+
+  ARMCI_Free(table[rank]);
+  free(table);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
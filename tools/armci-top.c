@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+/*
+ * armci-top
+ *  Monitor a running ARMCI-MPI job built with profiling and started with
+ *  ARMCI_LIVE_STATS=1.  Reads the per-node shared-memory statistics segments
+ *  (see live_stats.h) and prints, for each process, the rate, bandwidth, and
+ *  average latency of every operation active in the sampling interval, along
+ *  with its average flush latency and the fraction of time spent in barriers.
+ *
+ *  Usage: armci-top [-i SECONDS] [-n ITERATIONS] [SEGMENT...]
+ *
+ *  Segments are named armci_stats.JOB.NODE; all of those in /dev/shm are
+ *  monitored if none are given.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include <live_stats.h>
+
+#define MAX_SEGMENTS 256
+
+typedef struct {
+  char                 name[256];
+  armcii_live_header_t *hdr;
+  size_t               size;
+  armcii_live_func_t   *prev;     /* Counters at the previous sample, per slot and operation */
+} segment_t;
+
+
+static double now(void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1.0e-6;
+}
+
+
+static armcii_live_slot_t *seg_slot(const segment_t *seg, int i) {
+  return (armcii_live_slot_t *) ((char *) seg->hdr + seg->hdr->slots_offset
+                                 + (size_t) i * seg->hdr->slot_size);
+}
+
+
+static const char *seg_func_name(const segment_t *seg, int f) {
+  return (const char *) seg->hdr + seg->hdr->names_offset + (size_t) f * ARMCII_LIVE_NAME_LEN;
+}
+
+
+/** Copy the counters of every slot, one relaxed load per counter.
+  */
+static void seg_sample(const segment_t *seg, armcii_live_func_t *out) {
+  const int nfuncs = seg->hdr->nfuncs;
+  int       i, f;
+
+  for (i = 0; i < (int) seg->hdr->nslots; i++) {
+    const armcii_live_slot_t *slot = seg_slot(seg, i);
+
+    for (f = 0; f < nfuncs; f++) {
+      out[i*nfuncs + f].calls = __atomic_load_n(&slot->funcs[f].calls, __ATOMIC_RELAXED);
+      out[i*nfuncs + f].bytes = __atomic_load_n(&slot->funcs[f].bytes, __ATOMIC_RELAXED);
+      out[i*nfuncs + f].ticks = __atomic_load_n(&slot->funcs[f].ticks, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+
+/** Map a statistics segment read-only and check its header.
+  *
+  * @param[in]  name Segment name, as passed to shm_open
+  * @param[out] seg  Mapped segment
+  * @return          0 on success, non-zero on failure
+  */
+static int seg_open(const char *name, segment_t *seg) {
+  struct stat st;
+  int         fd;
+
+  memset(seg, 0, sizeof(segment_t));
+  snprintf(seg->name, sizeof(seg->name), "%s%s", name[0] == '/' ? "" : "/", name);
+
+  fd = shm_open(seg->name, O_RDONLY, 0);
+  if (fd < 0) {
+    fprintf(stderr, "armci-top: unable to open %s\n", seg->name);
+    return 1;
+  }
+
+  if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(armcii_live_header_t)) {
+    fprintf(stderr, "armci-top: %s is not an ARMCI statistics segment\n", seg->name);
+    close(fd);
+    return 1;
+  }
+
+  seg->size = st.st_size;
+  seg->hdr  = mmap(NULL, seg->size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (seg->hdr == MAP_FAILED) {
+    fprintf(stderr, "armci-top: unable to map %s\n", seg->name);
+    return 1;
+  }
+
+  if (__atomic_load_n(&seg->hdr->magic, __ATOMIC_ACQUIRE) != ARMCII_LIVE_MAGIC
+      || seg->hdr->version != ARMCII_LIVE_VERSION
+      || seg->hdr->slots_offset + (size_t) seg->hdr->nslots * seg->hdr->slot_size > seg->size) {
+    fprintf(stderr, "armci-top: %s is not a complete ARMCI statistics segment (version %d)\n",
+            seg->name, ARMCII_LIVE_VERSION);
+    munmap(seg->hdr, seg->size);
+    return 1;
+  }
+
+  seg->prev = calloc((size_t) seg->hdr->nslots * seg->hdr->nfuncs, sizeof(armcii_live_func_t));
+  if (seg->prev == NULL) {
+    munmap(seg->hdr, seg->size);
+    return 1;
+  }
+
+  seg_sample(seg, seg->prev);
+
+  return 0;
+}
+
+
+/** Print the activity of every process in a segment since the previous
+  * sample, which is then replaced by the current one.
+  *
+  * @param[in] seg     Segment
+  * @param[in] cur     Scratch space for the current sample
+  * @param[in] elapsed Seconds since the previous sample
+  */
+static void seg_report(segment_t *seg, armcii_live_func_t *cur, double elapsed) {
+  const int    nfuncs = seg->hdr->nfuncs;
+  const double hz     = seg->hdr->clock_hz;
+  int          i, f, barriers[2] = { -1, -1 }, flushes[2] = { -1, -1 };
+
+  for (f = 0; f < nfuncs; f++) {
+    if (strcmp(seg_func_name(seg, f), "PARMCI_Barrier") == 0)
+      barriers[0] = f;
+    else if (strcmp(seg_func_name(seg, f), "ARMCIX_Barrier_group") == 0)
+      barriers[1] = f;
+    else if (strcmp(seg_func_name(seg, f), "gmr_flush") == 0)
+      flushes[0] = f;
+    else if (strcmp(seg_func_name(seg, f), "gmr_flushall") == 0)
+      flushes[1] = f;
+  }
+
+  seg_sample(seg, cur);
+
+  for (i = 0; i < (int) seg->hdr->nslots; i++) {
+    const armcii_live_slot_t *slot = seg_slot(seg, i);
+    const armcii_live_func_t *c    = &cur[i*nfuncs], *p = &seg->prev[i*nfuncs];
+    uint64_t                  flush_calls = 0, flush_ticks = 0;
+    double                    barrier_frac = 0;
+    int                       k;
+
+    if (__atomic_load_n(&slot->rank, __ATOMIC_ACQUIRE) < 0)
+      continue;
+
+    for (k = 0; k < 2; k++) {
+      if (flushes[k] >= 0) {
+        flush_calls += c[flushes[k]].calls - p[flushes[k]].calls;
+        flush_ticks += c[flushes[k]].ticks - p[flushes[k]].ticks;
+      }
+
+      if (barriers[k] >= 0)
+        barrier_frac += (c[barriers[k]].ticks - p[barriers[k]].ticks) / hz / elapsed;
+    }
+
+    printf("rank %d (pid %d): flush %.3f us avg over %llu, barrier %.1f%% of time\n",
+           slot->rank, slot->pid, flush_calls ? flush_ticks / hz * 1.0e6 / flush_calls : 0.0,
+           (unsigned long long) flush_calls, 100.0 * barrier_frac);
+
+    for (f = 0; f < nfuncs; f++) {
+      const uint64_t calls = c[f].calls - p[f].calls;
+      const uint64_t bytes = c[f].bytes - p[f].bytes;
+      const uint64_t ticks = c[f].ticks - p[f].ticks;
+
+      if (calls == 0 && bytes == 0)
+        continue;
+
+      printf("  %-24s %12.1f ops/s %12.3f MB/s %12.3f us\n", seg_func_name(seg, f),
+             calls / elapsed, bytes / elapsed / 1.0e6, calls ? ticks / hz * 1.0e6 / calls : 0.0);
+    }
+  }
+
+  memcpy(seg->prev, cur, sizeof(armcii_live_func_t) * seg->hdr->nslots * nfuncs);
+}
+
+
+/** Find the statistics segments in /dev/shm.
+  *
+  * @param[out] segs Segments found
+  * @return          Number of segments found
+  */
+static int seg_scan(segment_t *segs) {
+  DIR           *dir = opendir("/dev/shm");
+  struct dirent *ent;
+  int            nsegs = 0;
+
+  if (dir == NULL)
+    return 0;
+
+  while ((ent = readdir(dir)) != NULL && nsegs < MAX_SEGMENTS)
+    if (strncmp(ent->d_name, ARMCII_LIVE_PREFIX ".", strlen(ARMCII_LIVE_PREFIX) + 1) == 0)
+      if (seg_open(ent->d_name, &segs[nsegs]) == 0)
+        nsegs++;
+
+  closedir(dir);
+
+  return nsegs;
+}
+
+
+int main(int argc, char **argv) {
+  static segment_t    segs[MAX_SEGMENTS];
+  armcii_live_func_t *cur;
+  double              interval = 1.0, last;
+  int                 c, i, nsegs = 0, niter = -1, iter;
+  size_t              max_slots = 0;
+
+  while ((c = getopt(argc, argv, "i:n:h")) != -1) {
+    switch (c) {
+      case 'i':
+        interval = atof(optarg);
+        break;
+      case 'n':
+        niter = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-i SECONDS] [-n ITERATIONS] [SEGMENT...]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  if (interval <= 0)
+    interval = 1.0;
+
+  if (optind < argc) {
+    for (i = optind; i < argc && nsegs < MAX_SEGMENTS; i++) {
+      const char *name = argv[i];
+
+      if (strncmp(name, "/dev/shm/", 9) == 0)
+        name += 8;
+
+      if (seg_open(name, &segs[nsegs]) == 0)
+        nsegs++;
+    }
+  } else {
+    nsegs = seg_scan(segs);
+  }
+
+  if (nsegs == 0) {
+    fprintf(stderr, "armci-top: no statistics segments found\n");
+    return 1;
+  }
+
+  for (i = 0; i < nsegs; i++) {
+    const size_t n = (size_t) segs[i].hdr->nslots * segs[i].hdr->nfuncs;
+    if (n > max_slots) max_slots = n;
+  }
+
+  cur = malloc(max_slots * sizeof(armcii_live_func_t));
+  if (cur == NULL)
+    return 1;
+
+  last = now();
+
+  for (iter = 0; niter < 0 || iter < niter; iter++) {
+    double t;
+
+    usleep((useconds_t) (interval * 1.0e6));
+    t = now();
+
+    printf("---- interval %d, %.2f s ----\n", iter + 1, t - last);
+
+    for (i = 0; i < nsegs; i++) {
+      printf("%s\n", segs[i].name + 1);
+      seg_report(&segs[i], cur, t - last);
+    }
+
+    fflush(stdout);
+    last = t;
+  }
+
+  for (i = 0; i < nsegs; i++) {
+    free(segs[i].prev);
+    munmap(segs[i].hdr, segs[i].size);
+  }
+
+  free(cur);
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+/*
+ * armci-trace2json
+ *  Convert the per-process event traces written by ARMCI-MPI profiling builds
+ *  (ARMCI_TRACE=1) to the Chrome trace event format, which can be loaded in
+ *  chrome://tracing or the Perfetto UI.  Each process is shown as one track,
+ *  with a complete event per recorded call.
+ *
+ *  Usage: armci-trace2json armci_trace.*.bin > trace.json
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <trace.h>
+
+#define BATCH 4096
+
+/** Convert one trace file, appending its events to out.
+  *
+  * @param[in]    path  Trace file
+  * @param[in]    out   Output stream
+  * @param[inout] first Set while no event has been written
+  * @return             0 on success, non-zero on failure
+  */
+static int convert(const char *path, FILE *out, int *first) {
+  armcii_trace_header_t hdr;
+  armcii_trace_event_t *events;
+  char                 *names;
+  double                us_per_tick;
+  size_t                n, i;
+  FILE                 *in;
+
+  in = fopen(path, "rb");
+  if (in == NULL) {
+    fprintf(stderr, "armci-trace2json: unable to open %s\n", path);
+    return 1;
+  }
+
+  if (fread(&hdr, sizeof(hdr), 1, in) != 1
+      || memcmp(hdr.magic, ARMCII_TRACE_MAGIC, sizeof(hdr.magic)) != 0
+      || hdr.nfuncs <= 0 || hdr.clock_hz <= 0) {
+    fprintf(stderr, "armci-trace2json: %s is not an ARMCI trace\n", path);
+    fclose(in);
+    return 1;
+  }
+
+  names  = malloc((size_t) hdr.nfuncs * ARMCII_TRACE_NAME_LEN);
+  events = malloc(BATCH * sizeof(armcii_trace_event_t));
+
+  if (names == NULL || events == NULL
+      || fread(names, ARMCII_TRACE_NAME_LEN, hdr.nfuncs, in) != (size_t) hdr.nfuncs) {
+    fprintf(stderr, "armci-trace2json: %s is truncated\n", path);
+    free(names);
+    free(events);
+    fclose(in);
+    return 1;
+  }
+
+  for (i = 0; i < (size_t) hdr.nfuncs; i++)
+    names[i*ARMCII_TRACE_NAME_LEN + ARMCII_TRACE_NAME_LEN - 1] = '\0';
+
+  us_per_tick = 1.0e6 / hdr.clock_hz;
+
+  fprintf(out, "%s\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"rank %d\"}}",
+          *first ? "" : ",", hdr.rank, hdr.rank);
+  fprintf(out, ",\n{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"sort_index\":%d}}",
+          hdr.rank, hdr.rank);
+  *first = 0;
+
+  while ((n = fread(events, sizeof(armcii_trace_event_t), BATCH, in)) > 0) {
+    for (i = 0; i < n; i++) {
+      const armcii_trace_event_t *ev = &events[i];
+      const char *name = "unknown";
+
+      if (ev->func >= 0 && ev->func < hdr.nfuncs)
+        name = &names[ev->func * ARMCII_TRACE_NAME_LEN];
+
+      fprintf(out, ",\n{\"name\":\"%s\",\"cat\":\"armci\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,"
+              "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"target\":%d,\"bytes\":%lld,\"window\":%d}}",
+              name, hdr.rank, (double) (int64_t) (ev->start - hdr.origin) * us_per_tick,
+              (double) (ev->end - ev->start) * us_per_tick, ev->target, (long long) ev->bytes,
+              ev->window);
+    }
+  }
+
+  free(names);
+  free(events);
+  fclose(in);
+
+  return 0;
+}
+
+
+int main(int argc, char **argv) {
+  int i, first = 1, errors = 0;
+
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s TRACE_FILE... > trace.json\n", argv[0]);
+    return 1;
+  }
+
+  printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+  for (i = 1; i < argc; i++)
+    errors += convert(argv[i], stdout, &first);
+
+  printf("\n]}\n");
+
+  return errors != 0;
+}